@@ -367,6 +367,7 @@ void state_reset_for_test(struct sandbox_state *state)
 	state->sysreset_allowed[SYSRESET_POWER_OFF] = true;
 	state->sysreset_allowed[SYSRESET_COLD] = true;
 	state->allow_memio = false;
+	state->usb_flash_lba_base = 0;
 	sandbox_set_eth_enable(true);
 
 	memset(&state->wdt, '\0', sizeof(state->wdt));
@@ -474,6 +475,20 @@ bool sandbox_sf_bootdev_enabled(void)
 	return !state->disable_sf_bootdevs;
 }
 
+void sandbox_flash_set_lba_base(u64 lba_base)
+{
+	struct sandbox_state *state = state_get_current();
+
+	state->usb_flash_lba_base = lba_base;
+}
+
+u64 sandbox_flash_get_lba_base(void)
+{
+	struct sandbox_state *state = state_get_current();
+
+	return state->usb_flash_lba_base;
+}
+
 int state_init(void)
 {
 	state = &main_state;
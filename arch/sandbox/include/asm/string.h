@@ -3,4 +3,23 @@
  * Copyright (c) 2011 The Chromium OS Authors.
  */
 
+#ifndef __ASM_SANDBOX_STRING_H
+#define __ASM_SANDBOX_STRING_H
+
+#include <linux/types.h>
+
+#undef __HAVE_ARCH_MEMCPY
+#if CONFIG_IS_ENABLED(USE_ARCH_MEMCPY)
+#define __HAVE_ARCH_MEMCPY
+#endif
+extern void *memcpy(void *, const void *, __kernel_size_t);
+
+#undef __HAVE_ARCH_MEMSET
+#if CONFIG_IS_ENABLED(USE_ARCH_MEMSET)
+#define __HAVE_ARCH_MEMSET
+#endif
+extern void *memset(void *, int, __kernel_size_t);
+
+#endif /* __ASM_SANDBOX_STRING_H */
+
 #include <linux/string.h>
@@ -11,6 +11,7 @@
 #include <video.h>
 #include <pci_ids.h>
 
+struct mtd_info;
 struct unit_test_state;
 
 /* The sandbox driver always permits an I2C device with this address */
@@ -151,6 +152,70 @@ int sandbox_pwm_get_config(struct udevice *dev, uint channel, uint *period_nsp,
  */
 void sandbox_sf_set_block_protect(struct udevice *dev, int bp_mask);
 
+/**
+ * sandbox_sf_set_bad_read() - Make a read command return corrupted data
+ *
+ * This emulates a board where a data line does not work at the speed of a
+ * particular read mode
+ *
+ * @dev: Device to update
+ * @opcode: Read opcode to corrupt (e.g. SPINOR_OP_READ_1_1_2), 0 for none
+ */
+void sandbox_sf_set_bad_read(struct udevice *dev, int opcode);
+
+/**
+ * struct sandbox_nand_stats - Usage counters for the sandbox NAND emulator
+ *
+ * @page_reads: Number of READ PAGE operations (READ0 followed by READSTART)
+ * @cache_seq: Number of READ CACHE SEQUENTIAL commands
+ * @cache_end: Number of READ CACHE END commands
+ * @errors: Number of commands which were out of sequence or out of range,
+ *	including cache reads which would cross a block boundary
+ */
+struct sandbox_nand_stats {
+	int page_reads;
+	int cache_seq;
+	int cache_end;
+	int errors;
+};
+
+/**
+ * sandbox_nand_get_mtd() - Get the MTD device for a sandbox NAND chip
+ *
+ * @dev: NAND device
+ * Return: MTD device
+ */
+struct mtd_info *sandbox_nand_get_mtd(struct udevice *dev);
+
+/**
+ * sandbox_nand_get_stats() - Read the usage counters of a sandbox NAND chip
+ *
+ * @dev: NAND device
+ * @stats: Returns the counters
+ */
+void sandbox_nand_get_stats(struct udevice *dev,
+			    struct sandbox_nand_stats *stats);
+
+/**
+ * sandbox_nand_reset_stats() - Clear the usage counters of a sandbox NAND chip
+ *
+ * @dev: NAND device
+ */
+void sandbox_nand_reset_stats(struct udevice *dev);
+
+/**
+ * sandbox_nand_flip_bit() - Corrupt a bit in the NAND array
+ *
+ * This emulates a bit error, which is seen by all later reads of the page
+ *
+ * @dev: NAND device
+ * @page: Page number
+ * @offset: Byte offset within the page, including the OOB area
+ * @bit: Bit number to flip (0 to 7)
+ * Return: 0 if OK, -EINVAL if the position is out of range
+ */
+int sandbox_nand_flip_bit(struct udevice *dev, int page, int offset, int bit);
+
 /**
  * sandbox_get_codec_params() - Read back codec parameters
  *
@@ -374,4 +439,30 @@ bool sandbox_sf_bootdev_enabled(void);
  */
 void sandbox_sf_set_enable_bootdevs(bool enable);
 
+/**
+ * sandbox_flash_set_lba_base() - Make USB flash sticks appear larger
+ *
+ * This adds blocks in front of the backing file of each USB flash stick probed
+ * after this call, so that large devices can be tested. Block @lba_base is
+ * the first block of the file.
+ *
+ * @lba_base: Number of blocks to add, 0 for none
+ */
+void sandbox_flash_set_lba_base(u64 lba_base);
+
+/**
+ * sandbox_flash_get_lba_base() - Get the blocks added before USB flash sticks
+ *
+ * Returns: value set by sandbox_flash_set_lba_base()
+ */
+u64 sandbox_flash_get_lba_base(void);
+
+/**
+ * sandbox_flash_get_last_cmd() - Get the last SCSI command for a flash stick
+ *
+ * @dev: USB emulator for the flash stick
+ * Returns: opcode of the last SCSI command received (e.g. SCSI_READ16)
+ */
+int sandbox_flash_get_last_cmd(struct udevice *dev);
+
 #endif
@@ -0,0 +1,6 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * memcpy() and memset() for sandbox on x86-64 hosts
+ */
+
+#include "../../../arch/x86/lib/string_64.c"
@@ -16,13 +16,20 @@ extern char *strchr(const char *s, int c);
 
 #ifdef CONFIG_X86_64
 
+/* The 64-bit phases use string instructions, see string_64.c */
 #undef __HAVE_ARCH_MEMCPY
+#if CONFIG_IS_ENABLED(X86_64)
+#define __HAVE_ARCH_MEMCPY
+#endif
 extern void *memcpy(void *, const void *, __kernel_size_t);
 
 #undef __HAVE_ARCH_MEMMOVE
 extern void *memmove(void *, const void *, __kernel_size_t);
 
 #undef __HAVE_ARCH_MEMSET
+#if CONFIG_IS_ENABLED(X86_64)
+#define __HAVE_ARCH_MEMSET
+#endif
 extern void *memset(void *, int, __kernel_size_t);
 
 #else
@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * memcpy() and memset() for x86-64
+ *
+ * These use the x86 string instructions. On CPUs with Enhanced REP MOVSB
+ * (ERMS) these run at close to memory bandwidth for large blocks without
+ * touching the vector registers, which U-Boot does not set up.
+ *
+ * This is also used by sandbox on x86-64 hosts, which can enable each
+ * function separately.
+ */
+
+#include <linux/types.h>
+#include <linux/compiler.h>
+#include <asm/string.h>
+
+#ifdef __HAVE_ARCH_MEMCPY
+void *memcpy(void *dstpp, const void *srcpp, size_t len)
+{
+	void *d = dstpp;
+	size_t head = 0, quads;
+
+	/* align the destination, since misaligned stores are much slower */
+	if (len >= 64)
+		head = -(ulong)dstpp & 7;
+	quads = (len - head) >> 3;
+	__asm__ __volatile__("rep movsb\n\t"
+			     "mov %3, %%rcx\n\t"
+			     "rep movsq\n\t"
+			     "mov %4, %%rcx\n\t"
+			     "rep movsb"
+			     : "+D" (d), "+S" (srcpp), "+c" (head)
+			     : "r" (quads), "r" ((len - head) & 7)
+			     : "memory");
+
+	return dstpp;
+}
+#endif
+
+#ifdef __HAVE_ARCH_MEMSET
+void *memset(void *dstpp, int c, size_t len)
+{
+	unsigned long val = 0x0101010101010101UL * (u8)c;
+	void *d = dstpp;
+	size_t head = 0, quads;
+
+	if (len >= 64)
+		head = -(ulong)dstpp & 7;
+	quads = (len - head) >> 3;
+	__asm__ __volatile__("rep stosb\n\t"
+			     "mov %3, %%rcx\n\t"
+			     "rep stosq\n\t"
+			     "mov %4, %%rcx\n\t"
+			     "rep stosb"
+			     : "+D" (d), "+c" (head)
+			     : "a" (val), "r" (quads), "r" ((len - head) & 7)
+			     : "memory");
+
+	return dstpp;
+}
+#endif
@@ -589,26 +589,115 @@ int bootdev_next_label(struct bootflow_iter *iter, struct udevice **devp,
 	return 0;
 }
 
+static int bootdev_hunt_drv(struct bootdev_hunter *info, uint seq, bool show)
+{
+	const char *name = uclass_get_name(info->uclass);
+	struct bootstd_priv *std;
+	int ret;
+
+	ret = bootstd_get_priv(&std);
+	if (ret)
+		return log_msg_ret("std", ret);
+
+	if (!(std->hunters_used & BIT(seq))) {
+		if (show)
+			printf("Hunting with: %s\n",
+			       uclass_get_name(info->uclass));
+		log_debug("Hunting with: %s\n", name);
+		if (info->hunt) {
+			ret = info->hunt(info, show);
+			if (ret)
+				return ret;
+		}
+		std->hunters_used |= BIT(seq);
+	}
+
+	return 0;
+}
+
+/**
+ * bootdev_hunt_next() - Run the next unused hunter of a given priority
+ *
+ * @prio: Priority of the hunter to run
+ * @seqp: Position in the hunter linker list at which to start looking. This
+ *	is updated to point just after the hunter which was run
+ * @show: true to show information from the hunter
+ * Return: 0 if a hunter was run, -ENOENT if there are no more hunters with
+ *	this priority, other -ve on error
+ */
+static int bootdev_hunt_next(enum bootdev_prio_t prio, int *seqp, bool show)
+{
+	struct bootdev_hunter *start;
+	struct bootstd_priv *std;
+	int n_ent, i;
+	int ret;
+
+	ret = bootstd_get_priv(&std);
+	if (ret)
+		return log_msg_ret("std", ret);
+
+	start = ll_entry_start(struct bootdev_hunter, bootdev_hunter);
+	n_ent = ll_entry_count(struct bootdev_hunter, bootdev_hunter);
+	for (i = *seqp; i < n_ent; i++) {
+		struct bootdev_hunter *info = start + i;
+
+		if (prio != info->prio || (std->hunters_used & BIT(i)))
+			continue;
+		*seqp = i + 1;
+		ret = bootdev_hunt_drv(info, i, show);
+		if (ret && ret != -ENOENT)
+			return log_msg_ret("hun", ret);
+
+		return 0;
+	}
+	*seqp = n_ent;
+
+	return -ENOENT;
+}
+
+/**
+ * bootdev_mark_old() - Mark all existing bootdevs as being there before a hunt
+ *
+ * Return: 0 if OK, -ve on error
+ */
+static int bootdev_mark_old(void)
+{
+	struct bootdev_uc_plat *plat;
+	struct udevice *dev;
+	struct uclass *uc;
+	int ret;
+
+	ret = uclass_get(UCLASS_BOOTDEV, &uc);
+	if (ret)
+		return log_msg_ret("uc", ret);
+	uclass_foreach_dev(dev, uc) {
+		plat = dev_get_uclass_plat(dev);
+		plat->old = true;
+	}
+
+	return 0;
+}
+
 int bootdev_next_prio(struct bootflow_iter *iter, struct udevice **devp)
 {
-	struct udevice *dev = *devp;
-	bool found;
+	struct udevice *dev, *last = *devp;
+	bool hunted = false;
 	int ret;
 
 	/* find the next device with this priority */
 	*devp = NULL;
-	log_debug("next prio %d: dev=%p/%s\n", iter->cur_prio, dev,
-		  dev ? dev->name : "none");
-	do {
+	log_debug("next prio %d: dev=%p/%s\n", iter->cur_prio, last,
+		  last ? last->name : "none");
+	for (;;) {
 		/*
 		 * Don't probe devices here since they may not be of the
 		 * required priority
 		 */
+		dev = last;
 		if (!dev)
 			uclass_find_first_device(UCLASS_BOOTDEV, &dev);
 		else
 			uclass_find_next_device(&dev);
-		found = false;
 
 		/* scan for the next device with the correct priority */
 		while (dev) {
@@ -617,36 +706,56 @@ int bootdev_next_prio(struct bootflow_iter *iter, struct udevice **devp)
 			plat = dev_get_uclass_plat(dev);
 			log_debug("- %s: %d, want %d\n", dev->name, plat->prio,
 				  iter->cur_prio);
-			if (plat->prio == iter->cur_prio)
+			if (plat->prio == iter->cur_prio &&
+			    !(hunted && plat->old))
 				break;
 			uclass_find_next_device(&dev);
 		}
 
-		/* none found for this priority, so move to the next */
-		if (!dev) {
-			log_debug("None found at prio %d, moving to %d\n",
-				  iter->cur_prio, iter->cur_prio + 1);
-			if (++iter->cur_prio == BOOTDEVP_COUNT)
-				return log_msg_ret("fin", -ENODEV);
-
-			if (iter->flags & BOOTFLOWF_HUNT) {
-				/* hunt to find new bootdevs */
-				ret = bootdev_hunt_prio(iter->cur_prio,
-							iter->flags &
-							BOOTFLOWF_SHOW);
-				log_debug("- hunt ret %d\n", ret);
-				if (ret)
-					return log_msg_ret("hun", ret);
-			}
-		} else {
+		if (dev) {
 			ret = device_probe(dev);
-			if (ret) {
-				log_debug("Device '%s' failed to probe\n",
-					  dev->name);
-				dev = NULL;
-			}
+			if (!ret)
+				break;
+			log_debug("Device '%s' failed to probe\n", dev->name);
+			last = dev;
+			continue;
 		}
-	} while (!dev);
+
+		/*
+		 * Run the hunters for this priority one at a time, so that the
+		 * bootdevs which are already there, and those found by each
+		 * hunter, are tried before waiting for the next hunter.
+		 *
+		 * A hunter may unbind bootdevs (e.g. scsi_scan() does), so
+		 * start again from the first device afterwards. All the
+		 * bootdevs of this priority which are there now have been
+		 * tried, so mark them to skip them. Those bound by the hunter,
+		 * including any it bound again, are tried next.
+		 */
+		if (iter->flags & BOOTFLOWF_HUNT) {
+			ret = bootdev_mark_old();
+			if (ret)
+				return log_msg_ret("old", ret);
+			ret = bootdev_hunt_next(iter->cur_prio, &iter->cur_hunter,
+						iter->flags & BOOTFLOWF_SHOW);
+			log_debug("- hunt ret %d\n", ret);
+			hunted = true;
+			last = NULL;
+			if (!ret)
+				continue;
+			if (ret != -ENOENT)
+				return log_msg_ret("hun", ret);
+		}
+
+		/* none left at this priority, so move to the next */
+		log_debug("None found at prio %d, moving to %d\n",
+			  iter->cur_prio, iter->cur_prio + 1);
+		if (++iter->cur_prio == BOOTDEVP_COUNT)
+			return log_msg_ret("fin", -ENODEV);
+		iter->cur_hunter = 0;
+		hunted = false;
+		last = NULL;
+	}
 
 	*devp = dev;
 
@@ -723,32 +832,6 @@ int bootdev_setup_iter(struct bootflow_iter *iter, const char *label,
 	return 0;
 }
 
-static int bootdev_hunt_drv(struct bootdev_hunter *info, uint seq, bool show)
-{
-	const char *name = uclass_get_name(info->uclass);
-	struct bootstd_priv *std;
-	int ret;
-
-	ret = bootstd_get_priv(&std);
-	if (ret)
-		return log_msg_ret("std", ret);
-
-	if (!(std->hunters_used & BIT(seq))) {
-		if (show)
-			printf("Hunting with: %s\n",
-			       uclass_get_name(info->uclass));
-		log_debug("Hunting with: %s\n", name);
-		if (info->hunt) {
-			ret = info->hunt(info, show);
-			if (ret)
-				return ret;
-		}
-		std->hunters_used |= BIT(seq);
-	}
-
-	return 0;
-}
-
 int bootdev_hunt(const char *spec, bool show)
 {
 	struct bootdev_hunter *start;
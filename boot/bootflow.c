@@ -111,6 +111,8 @@ int bootflow_iter_drop_bootmeth(struct bootflow_iter *iter,
 		(iter->num_methods - iter->cur_method - 1) * sizeof(void *));
 
 	iter->num_methods--;
+	if (iter->cur_method < iter->first_glob_method)
+		iter->first_glob_method--;
 
 	return 0;
 }
@@ -313,6 +315,13 @@ static int bootflow_check(struct bootflow_iter *iter, struct bootflow *bflow)
 	dev = iter->dev;
 	ret = bootdev_get_bootflow(dev, iter, bflow);
 
+	/* Skip the bootflow from the cache, which was returned already */
+	if (!ret && dev == iter->cache_dev && iter->part == iter->cache_part &&
+	    iter->method == iter->cache_method) {
+		bootflow_free(bflow);
+		ret = -EALREADY;
+	}
+
 	/* If we got a valid bootflow, return it */
 	if (!ret) {
 		log_debug("Bootdevice '%s' part %d method '%s': Found bootflow\n",
@@ -337,23 +346,35 @@ static int bootflow_check(struct bootflow_iter *iter, struct bootflow *bflow)
 	return 0;
 }
 
-int bootflow_scan_first(struct udevice *dev, const char *label,
-			struct bootflow_iter *iter, int flags,
-			struct bootflow *bflow)
+/**
+ * bootflow_scan_start() - Set up the iterator and find the first bootflow
+ *
+ * @label: Label to scan, NULL to work through all bootdevs
+ * @iter: Iterator, already set up with bootflow_iter_init()
+ * @bflow: Returns the first bootflow found
+ * Return: 0 if found, -ENODEV if no bootdevs, other -ve on error
+ */
+static int bootflow_scan_start(const char *label, struct bootflow_iter *iter,
+			       struct bootflow *bflow)
 {
+	int flags = iter->flags;
 	int ret;
 
-	if (dev || label)
-		flags |= BOOTFLOWF_SKIP_GLOBAL;
-	bootflow_iter_init(iter, flags);
-
 	/*
 	 * Set up the ordering of bootmeths. This sets iter->doing_global and
-	 * iter->first_glob_method if we are starting with the global bootmeths
+	 * iter->first_glob_method if we are starting with the global bootmeths.
+	 * It is already there if the bootflow cache was used, possibly with
+	 * a bootmeth dropped since.
 	 */
-	ret = bootmeth_setup_iter_order(iter, !(flags & BOOTFLOWF_SKIP_GLOBAL));
-	if (ret)
-		return log_msg_ret("obmeth", -ENODEV);
+	if (!iter->method_order) {
+		ret = bootmeth_setup_iter_order(iter,
+						!(flags & BOOTFLOWF_SKIP_GLOBAL));
+		if (ret)
+			return log_msg_ret("obmeth", -ENODEV);
+	} else {
+		iter->cur_method = iter->doing_global ?
+			iter->first_glob_method : 0;
+	}
 
 	/* Find the first bootmeth (there must be at least one!) */
 	iter->method = iter->method_order[iter->cur_method];
@@ -385,10 +406,41 @@ int bootflow_scan_first(struct udevice *dev, const char *label,
 	return 0;
 }
 
+int bootflow_scan_first(struct udevice *dev, const char *label,
+			struct bootflow_iter *iter, int flags,
+			struct bootflow *bflow)
+{
+	if (dev || label)
+		flags |= BOOTFLOWF_SKIP_GLOBAL;
+	bootflow_iter_init(iter, flags);
+
+	/*
+	 * Try the bootflow which was booted last time. If that fails to boot,
+	 * the next call to bootflow_scan_next() starts the scan
+	 */
+	if (CONFIG_IS_ENABLED(BOOTSTD_CACHE) && (flags & BOOTFLOWF_CACHE) &&
+	    !(flags & BOOTFLOWF_ALL) && !dev && !label) {
+		if (bootmeth_setup_iter_order(iter, !(flags &
+						      BOOTFLOWF_SKIP_GLOBAL)))
+			return log_msg_ret("cmeth", -ENODEV);
+		if (!bootflow_cache_check(iter, bflow)) {
+			iter->flags |= BOOTFLOWF_CACHED;
+			return 0;
+		}
+	}
+
+	return bootflow_scan_start(label, iter, bflow);
+}
+
 int bootflow_scan_next(struct bootflow_iter *iter, struct bootflow *bflow)
 {
 	int ret;
 
+	if (iter->flags & BOOTFLOWF_CACHED) {
+		iter->flags &= ~BOOTFLOWF_CACHED;
+		return bootflow_scan_start(NULL, iter, bflow);
+	}
+
 	do {
 		ret = iter_incr(iter);
 		log_debug("iter_incr: ret=%d\n", ret);
@@ -467,6 +519,12 @@ int bootflow_run_boot(struct bootflow_iter *iter, struct bootflow *bflow)
 
 	printf("** Booting bootflow '%s' with %s\n", bflow->name,
 	       bflow->method->name);
+	if (CONFIG_IS_ENABLED(BOOTSTD_CACHE)) {
+		ret = bootflow_cache_save(bflow);
+		if (ret && ret != -EINVAL)
+			log_warning("Failed to update bootflow cache (err=%d)\n",
+				    ret);
+	}
 	ret = bootflow_boot(bflow);
 	if (!IS_ENABLED(CONFIG_BOOTSTD_FULL)) {
 		printf("Boot failed (err=%d)\n", ret);
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Remember the last bootflow which was booted, so it can be tried first
+ *
+ * The bootflow is recorded in the 'bootflow_cache' environment variable as:
+ *
+ *	<bootdev> <part> <bootmeth> <fname> <size> <crc32> <order>
+ *
+ * where <size> and <crc32> describe the contents of the bootflow file (e.g.
+ * extlinux.conf or boot.scr) and <order> is the CRC32 of the bootdev order
+ * (e.g. from boot_targets). On the next boot this bootflow is read and
+ * checked against the record before any scanning is done. If it matches, it
+ * is booted straight away.
+ */
+
+#define LOG_CATEGORY UCLASS_BOOTSTD
+
+#include <common.h>
+#include <bootdev.h>
+#include <bootflow.h>
+#include <bootmeth.h>
+#include <bootstd.h>
+#include <dm.h>
+#include <env.h>
+#include <malloc.h>
+#include <part.h>
+#include <dm/device-internal.h>
+#include <dm/uclass-internal.h>
+#include <u-boot/crc.h>
+
+/* Number of fields in the cache record */
+#define CACHE_FIELDS	7
+
+/* Maximum length of the cache record, including the terminator */
+#define CACHE_MAX_LEN	256
+
+/**
+ * bootflow_cache_order() - Get a fingerprint of the bootdev order
+ *
+ * The cached bootflow is only valid for the bootdev order which was in use
+ * when it was booted, since it may not be the first bootflow in another
+ * order.
+ *
+ * @crcp: Returns the CRC32 of the labels in the bootdev order, or 0 if
+ *	bootdevs are used in order of priority
+ * Return: 0 if OK, -ve on error
+ */
+static int bootflow_cache_order(u32 *crcp)
+{
+	const char *const *labels;
+	struct udevice *bootstd;
+	u32 crc = 0;
+	bool ok;
+	int ret;
+
+	ret = uclass_first_device_err(UCLASS_BOOTSTD, &bootstd);
+	if (ret)
+		return log_msg_ret("std", ret);
+	labels = bootstd_get_bootdev_order(bootstd, &ok);
+	if (!ok)
+		return log_msg_ret("ord", -ENOMEM);
+	for (; labels && *labels; labels++)
+		crc = crc32(crc, (uchar *)*labels, strlen(*labels) + 1);
+	*crcp = crc;
+
+	return 0;
+}
+
+/**
+ * bootflow_cache_fmt() - Produce the cache record for a bootflow
+ *
+ * @bflow: Bootflow to record
+ * @rec: Returns the record
+ * Return: 0 if OK, -EINVAL if the bootflow cannot be cached, other -ve on
+ *	error
+ */
+static int bootflow_cache_fmt(const struct bootflow *bflow,
+			      char rec[CACHE_MAX_LEN])
+{
+	u32 crc = 0, order;
+	int len, ret;
+
+	/* global bootmeths select their own bootdev, so cannot be cached */
+	if (!bflow->dev || !bflow->fname || strchr(bflow->fname, ' '))
+		return -EINVAL;
+	if (bflow->buf)
+		crc = crc32(0, (uchar *)bflow->buf, bflow->size);
+	ret = bootflow_cache_order(&order);
+	if (ret)
+		return ret;
+
+	len = snprintf(rec, CACHE_MAX_LEN, "%s %d %s %s %x %08x %08x",
+		       bflow->dev->name, bflow->part, bflow->method->name,
+		       bflow->fname, bflow->size, crc, order);
+	if (len >= CACHE_MAX_LEN)
+		return -EINVAL;
+
+	return 0;
+}
+
+int bootflow_cache_save(const struct bootflow *bflow)
+{
+	char rec[CACHE_MAX_LEN];
+	const char *old;
+	int ret;
+
+	ret = bootflow_cache_fmt(bflow, rec);
+	if (ret)
+		return log_msg_ret("fmt", ret);
+
+	/* only write the environment when the record changes */
+	old = env_get(BOOTFLOW_CACHE_VAR);
+	ret = 0;
+	if (!old || strcmp(old, rec)) {
+		log_debug("Caching bootflow '%s'\n", rec);
+		ret = env_set(BOOTFLOW_CACHE_VAR, rec);
+		if (!ret && IS_ENABLED(CONFIG_BOOTSTD_CACHE_SAVE))
+			ret = env_save();
+	}
+	if (ret)
+		return log_msg_ret("env", ret);
+
+	return 0;
+}
+
+/**
+ * bootflow_cache_find_method() - Find a bootmeth in the iterator's ordering
+ *
+ * @iter: Iterator, with the bootmeth ordering set up
+ * @meth: Bootmeth to find
+ * Return: position of @meth in the ordering, or -ENOENT if not present
+ */
+static int bootflow_cache_find_method(const struct bootflow_iter *iter,
+				      struct udevice *meth)
+{
+	int i;
+
+	for (i = 0; i < iter->num_methods; i++) {
+		if (iter->method_order[i] == meth)
+			return i;
+	}
+
+	return -ENOENT;
+}
+
+int bootflow_cache_check(struct bootflow_iter *iter, struct bootflow *bflow)
+{
+	char *field[CACHE_FIELDS];
+	char fmt[CACHE_MAX_LEN];
+	struct bootflow_iter tmp;
+	struct udevice *dev, *meth, *blk;
+	const char *val;
+	char *str, *pos;
+	int i, part, seq, ret;
+
+	val = env_get(BOOTFLOW_CACHE_VAR);
+	if (!val)
+		return log_msg_ret("env", -ENOENT);
+	str = strdup(val);
+	if (!str)
+		return log_msg_ret("str", -ENOMEM);
+	for (pos = str, i = 0; i < CACHE_FIELDS; i++) {
+		field[i] = strsep(&pos, " ");
+		if (!field[i] || !*field[i]) {
+			ret = -EINVAL;
+			goto err;
+		}
+	}
+
+	/* the bootdev must be there already, since there is no hunting */
+	ret = uclass_find_device_by_name(UCLASS_BOOTDEV, field[0], &dev);
+	if (!ret)
+		ret = uclass_get_device_by_name(UCLASS_BOOTMETH, field[2],
+						&meth);
+	if (!ret) {
+		seq = bootflow_cache_find_method(iter, meth);
+		if (seq < 0)
+			ret = seq;
+	}
+	if (!ret)
+		ret = device_probe(dev);
+	if (ret)
+		goto err;
+	part = simple_strtol(field[1], NULL, 10);
+
+	bootflow_iter_init(&tmp, iter->flags);
+	tmp.dev = dev;
+	tmp.part = part;
+	tmp.method = meth;
+	tmp.max_part = part;
+	if (part && !bootdev_get_sibling_blk(dev, &blk)) {
+		struct blk_desc *desc = dev_get_uclass_plat(blk);
+
+		tmp.first_bootable = part_get_bootable(desc);
+	}
+
+	ret = bootdev_get_bootflow(dev, &tmp, bflow);
+	if (!ret && bflow->state != BOOTFLOWST_READY)
+		ret = -EPROTO;
+	if (ret) {
+		bootflow_free(bflow);
+		goto err;
+	}
+
+	/* the bootflow file must be the same as last time */
+	ret = bootflow_cache_fmt(bflow, fmt);
+	if (!ret && strcmp(fmt, val))
+		ret = -ESTALE;
+	if (ret) {
+		bootflow_free(bflow);
+		goto err;
+	}
+	free(str);
+	log_debug("Using cached bootflow '%s'\n", bflow->name);
+
+	iter->cache_dev = dev;
+	iter->cache_part = part;
+	iter->cache_method = meth;
+
+	/* allow the bootmeth to be dropped if it is not supported */
+	iter->cur_method = seq;
+	iter->method = meth;
+
+	return 0;
+err:
+	log_debug("Cached bootflow '%s' not usable (err=%d)\n", val, ret);
+	free(str);
+
+	return log_msg_ret("chk", ret);
+}
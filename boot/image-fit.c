@@ -1294,14 +1294,46 @@ int calculate_hash(const void *data, int data_len, const char *name,
 	return 0;
 }
 
+/**
+ * fit_image_compare_hash() - compare a hash with the one in a hash node
+ *
+ * @fit:	FIT to check
+ * @noffset:	Offset of the hash node
+ * @value:	Hash value to compare
+ * @value_len:	Length of @value in bytes
+ * @err_msgp:	Returns an error message on failure
+ * Return: 0 if the hashes match, -1 otherwise
+ */
+static int fit_image_compare_hash(const void *fit, int noffset,
+				  const uint8_t *value, int value_len,
+				  char **err_msgp)
+{
+	uint8_t *fit_value;
+	int fit_value_len;
+
+	if (fit_image_hash_get_value(fit, noffset, &fit_value,
+				     &fit_value_len)) {
+		*err_msgp = "Can't get hash value property";
+		return -1;
+	}
+
+	if (value_len != fit_value_len) {
+		*err_msgp = "Bad hash value len";
+		return -1;
+	} else if (memcmp(value, fit_value, value_len) != 0) {
+		*err_msgp = "Bad hash value";
+		return -1;
+	}
+
+	return 0;
+}
+
 static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 				size_t size, char **err_msgp)
 {
 	ALLOC_CACHE_ALIGN_BUFFER(uint8_t, value, FIT_MAX_HASH_LEN);
 	int value_len;
 	const char *algo;
-	uint8_t *fit_value;
-	int fit_value_len;
 	int ignore;
 
 	*err_msgp = NULL;
@@ -1320,26 +1352,13 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		}
 	}
 
-	if (fit_image_hash_get_value(fit, noffset, &fit_value,
-				     &fit_value_len)) {
-		*err_msgp = "Can't get hash value property";
-		return -1;
-	}
-
 	if (calculate_hash(data, size, algo, value, &value_len)) {
 		*err_msgp = "Unsupported hash algorithm";
 		return -1;
 	}
 
-	if (value_len != fit_value_len) {
-		*err_msgp = "Bad hash value len";
-		return -1;
-	} else if (memcmp(value, fit_value, value_len) != 0) {
-		*err_msgp = "Bad hash value";
-		return -1;
-	}
-
-	return 0;
+	return fit_image_compare_hash(fit, noffset, value, value_len,
+				      err_msgp);
 }
 
 int fit_image_verify_with_data(const void *fit, int image_noffset,
@@ -1974,6 +1993,151 @@ int fit_get_data_conf_prop(const void *fit, const char *prop_name,
 	return fit_get_data_tail(fit, noffset, data, size);
 }
 
+/**
+ * fit_image_get_decomp_hash() - find a hash to check while decompressing
+ *
+ * An image which fit_image_load() decompresses can have its hash checked as
+ * it is decompressed, so that the compressed data is only read once. This
+ * needs a single hash node, using an algorithm with progressive support.
+ * Images with signature or cipher nodes, or which the board may change
+ * before decompression, are verified in a separate pass first.
+ *
+ * @fit:	FIT to check
+ * @noffset:	Offset of the image node
+ * @algop:	Returns the hash algorithm to use
+ * Return: offset of the hash node, or -ve if the image must be verified
+ *	before it is decompressed
+ */
+static int fit_image_get_decomp_hash(const void *fit, int noffset,
+				     struct hash_algo **algop)
+{
+	int hash_noffset = -ENOENT;
+	const char *algo;
+	int subnode, ignore;
+
+	if (tools_build() || IS_ENABLED(CONFIG_FIT_IMAGE_POST_PROCESS))
+		return -ENOSYS;
+
+	fdt_for_each_subnode(subnode, fit, noffset) {
+		const char *name = fit_get_name(fit, subnode, NULL);
+
+		if (!strncmp(name, FIT_HASH_NODENAME,
+			     strlen(FIT_HASH_NODENAME))) {
+			if (hash_noffset >= 0)
+				return -E2BIG;
+			hash_noffset = subnode;
+		} else if (!strncmp(name, FIT_SIG_NODENAME,
+				    strlen(FIT_SIG_NODENAME)) ||
+			   !strncmp(name, FIT_CIPHER_NODENAME,
+				    strlen(FIT_CIPHER_NODENAME))) {
+			return -EPERM;
+		}
+	}
+	if (hash_noffset < 0)
+		return hash_noffset;
+
+	fit_image_hash_get_ignore(fit, hash_noffset, &ignore);
+	if (ignore || fit_image_hash_get_algo(fit, hash_noffset, &algo) ||
+	    hash_progressive_lookup_algo(algo, algop))
+		return -EPROTONOSUPPORT;
+
+	return hash_noffset;
+}
+
+/**
+ * fit_image_verify_no_hash() - verify an image, except for its hash
+ *
+ * This does the checks of fit_image_verify() apart from the hash, which
+ * fit_image_decomp_verify() checks later
+ *
+ * @fit:	FIT to check
+ * @noffset:	Offset of the image node
+ * Return: 0 if OK, -EACCES on failure
+ */
+static int fit_image_verify_no_hash(const void *fit, int noffset)
+{
+	const char *name = fit_get_name(fit, noffset, NULL);
+	const void *data;
+	size_t size;
+	int no_sigs;
+
+	if (IS_ENABLED(CONFIG_FIT_SIGNATURE) && strchr(name, '@')) {
+		printf("Node name contains @ in '%s' image node\n", name);
+		return -EACCES;
+	}
+	if (!FIT_IMAGE_ENABLE_VERIFY)
+		return 0;
+	if (fit_image_get_data_and_size(fit, noffset, &data, &size) ||
+	    fit_image_verify_required_sigs(fit, noffset, data, size,
+					   gd_fdt_blob(), &no_sigs)) {
+		printf("Unable to verify required signature in '%s' image node\n",
+		       name);
+		return -EACCES;
+	}
+
+	return 0;
+}
+
+/**
+ * fit_image_decomp_verify() - decompress an image and check its hash
+ *
+ * The hash is calculated as the image is decompressed, then compared with
+ * the one in the FIT. If it does not match, the decompressed data must not
+ * be used.
+ *
+ * @fit:	FIT containing the image
+ * @hash_noffset: Offset of the hash node to check
+ * @algo:	Hash algorithm used by the hash node
+ * @comp:	Compression algorithm that is used (IH_COMP_...)
+ * @load:	Destination load address in U-Boot memory
+ * @image_start: Image start address (where we are decompressing from)
+ * @type:	Image type (IH_TYPE_...)
+ * @load_buf:	Place to decompress to
+ * @image_buf:	Address to decompress from
+ * @image_len:	Number of bytes in @image_buf to decompress
+ * @unc_len:	Available space for decompression
+ * @load_end:	Returns the end of the decompressed data
+ * Return: 0 if OK, -EACCES if the hash does not match, other -ve if the
+ *	image could not be decompressed
+ */
+static int fit_image_decomp_verify(const void *fit, int hash_noffset,
+				   struct hash_algo *algo, int comp,
+				   ulong load, ulong image_start, int type,
+				   void *load_buf, void *image_buf,
+				   ulong image_len, uint unc_len,
+				   ulong *load_end)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(uint8_t, value, FIT_MAX_HASH_LEN);
+	char *err_msg;
+	void *ctx;
+	int ret;
+
+	ret = algo->hash_init(algo, &ctx);
+	if (ret)
+		return -ENOMEM;
+	ret = image_decomp_hash(comp, load, image_start, type, load_buf,
+				image_buf, image_len, unc_len, load_end, algo,
+				ctx);
+
+	/* this frees the context, so is needed even if decompression failed */
+	if (algo->hash_finish(algo, ctx, value, FIT_MAX_HASH_LEN) && !ret)
+		ret = -EIO;
+	if (ret)
+		return ret;
+
+	printf("   Verifying Hash Integrity ... %s", algo->name);
+	if (fit_image_compare_hash(fit, hash_noffset, value, algo->digest_size,
+				   &err_msg)) {
+		printf(" error!\n%s for '%s' hash node\n", err_msg,
+		       fit_get_name(fit, hash_noffset, NULL));
+		puts("Bad Data Hash\n");
+		return -EACCES;
+	}
+	puts("+ OK\n");
+
+	return 0;
+}
+
 static int fit_image_select(const void *fit, int rd_noffset, int verify)
 {
 	fit_image_print(fit, rd_noffset, "   ");
@@ -2071,6 +2235,9 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 	ulong load, load_end, data, len;
 	uint8_t os, comp;
 	const char *prop_name;
+	struct hash_algo *hash_algo;
+	int hash_noffset;
+	bool decomp;
 	int ret;
 
 	fit = map_sysmem(addr, 0);
@@ -2144,7 +2311,26 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 
 	printf("   Trying '%s' %s subimage\n", fit_uname, prop_name);
 
-	ret = fit_image_select(fit, noffset, images->verify);
+	/*
+	 * Kernel images get decompressed later in bootm_load_os(), others
+	 * here. Those can have their hash checked as they are decompressed,
+	 * rather than in a separate pass first.
+	 */
+	comp = IH_COMP_NONE;
+	decomp = !fit_image_get_comp(fit, noffset, &comp) &&
+		 comp != IH_COMP_NONE &&
+		 !(image_type == IH_TYPE_KERNEL ||
+		   image_type == IH_TYPE_KERNEL_NOLOAD ||
+		   image_type == IH_TYPE_RAMDISK);
+	hash_noffset = -ENOENT;
+	if (images->verify && decomp)
+		hash_noffset = fit_image_get_decomp_hash(fit, noffset,
+							 &hash_algo);
+
+	ret = fit_image_select(fit, noffset,
+			       images->verify && hash_noffset < 0);
+	if (!ret && hash_noffset >= 0)
+		ret = fit_image_verify_no_hash(fit, noffset);
 	if (ret) {
 		bootstage_error(bootstage_id + BOOTSTAGE_SUB_HASH);
 		return ret;
@@ -2261,14 +2447,8 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 		load = data;	/* No load address specified */
 	}
 
-	comp = IH_COMP_NONE;
 	loadbuf = buf;
-	/* Kernel images get decompressed later in bootm_load_os(). */
-	if (!fit_image_get_comp(fit, noffset, &comp) &&
-	    comp != IH_COMP_NONE &&
-	    !(image_type == IH_TYPE_KERNEL ||
-	      image_type == IH_TYPE_KERNEL_NOLOAD ||
-	      image_type == IH_TYPE_RAMDISK)) {
+	if (decomp) {
 		ulong max_decomp_len = len * 20;
 		if (load == data) {
 			loadbuf = malloc(max_decomp_len);
@@ -2276,8 +2456,21 @@ int fit_image_load(struct bootm_headers *images, ulong addr,
 		} else {
 			loadbuf = map_sysmem(load, max_decomp_len);
 		}
-		if (image_decomp(comp, load, data, image_type,
-				loadbuf, buf, len, max_decomp_len, &load_end)) {
+		if (hash_noffset >= 0)
+			ret = fit_image_decomp_verify(fit, hash_noffset,
+						      hash_algo, comp, load,
+						      data, image_type,
+						      loadbuf, buf, len,
+						      max_decomp_len,
+						      &load_end);
+		else
+			ret = image_decomp(comp, load, data, image_type,
+					   loadbuf, buf, len, max_decomp_len,
+					   &load_end);
+		if (ret == -EACCES) {
+			bootstage_error(bootstage_id + BOOTSTAGE_SUB_HASH);
+			return ret;
+		} else if (ret) {
 			printf("Error decompressing %s\n", prop_name);
 
 			return -ENOEXEC;
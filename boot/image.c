@@ -57,6 +57,7 @@ DECLARE_GLOBAL_DATA_PTR;
 #include <bzlib.h>
 #include <display_options.h>
 #include <gzip.h>
+#include <hash.h>
 #include <image.h>
 #include <imximage.h>
 #include <relocate.h>
@@ -439,15 +440,61 @@ int image_decomp_type(const unsigned char *buf, ulong len)
 	return cmagic->comp_id;
 }
 
-int image_decomp(int comp, ulong load, ulong image_start, int type,
-		 void *load_buf, void *image_buf, ulong image_len,
-		 uint unc_len, ulong *load_end)
+/**
+ * struct image_hash_feed - state for hashing compressed input on the fly
+ *
+ * @algo:	Hash algorithm
+ * @ctx:	Progressive hash context
+ * @done:	Number of input bytes hashed so far
+ * @err:	-EIO if the hash algorithm failed, else 0
+ */
+struct image_hash_feed {
+	struct hash_algo *algo;
+	void *ctx;
+	ulong done;
+	int err;
+};
+
+static void image_hash_input(void *priv, const void *buf, size_t len)
+{
+	struct image_hash_feed *feed = priv;
+	int ret;
+
+	/* the decompressors cannot be stopped, so just record the error */
+	if (feed->err)
+		return;
+	ret = feed->algo->hash_update(feed->algo, feed->ctx, buf, len, 0);
+	if (ret) {
+		printf("Hash update failed (err=%d)\n", ret);
+		feed->err = -EIO;
+		return;
+	}
+	feed->done += len;
+}
+
+int image_decomp_hash(int comp, ulong load, ulong image_start, int type,
+		      void *load_buf, void *image_buf, ulong image_len,
+		      uint unc_len, ulong *load_end, struct hash_algo *algo,
+		      void *hash_ctx)
 {
+	struct image_hash_feed feed = { algo, hash_ctx, 0, 0 };
+	ulong in_len = image_len;
 	int ret = -ENOSYS;
 
 	*load_end = load;
 	print_decomp_msg(comp, type, load == image_start);
 
+	/*
+	 * Codecs without a chunked implementation see the input only after it
+	 * has all been hashed
+	 */
+	if (algo && comp != IH_COMP_GZIP && comp != IH_COMP_LZMA &&
+	    comp != IH_COMP_LZ4 && comp != IH_COMP_ZSTD) {
+		image_hash_input(&feed, image_buf, in_len);
+		if (feed.err)
+			return feed.err;
+	}
+
 	/*
 	 * Load the image to the right place, decompressing if needed. After
 	 * this, image_len will be set to the number of uncompressed bytes
@@ -464,8 +511,15 @@ int image_decomp(int comp, ulong load, ulong image_start, int type,
 			ret = -ENOSPC;
 		break;
 	case IH_COMP_GZIP:
-		if (!tools_build() && CONFIG_IS_ENABLED(GZIP))
-			ret = gunzip(load_buf, unc_len, image_buf, &image_len);
+		if (!tools_build() && CONFIG_IS_ENABLED(GZIP)) {
+			if (algo)
+				ret = gunzip_cb(load_buf, unc_len, image_buf,
+						&image_len, image_hash_input,
+						&feed);
+			else
+				ret = gunzip(load_buf, unc_len, image_buf,
+					     &image_len);
+		}
 		break;
 	case IH_COMP_BZIP2:
 		if (!tools_build() && CONFIG_IS_ENABLED(BZIP2)) {
@@ -485,8 +539,15 @@ int image_decomp(int comp, ulong load, ulong image_start, int type,
 		if (!tools_build() && CONFIG_IS_ENABLED(LZMA)) {
 			SizeT lzma_len = unc_len;
 
-			ret = lzmaBuffToBuffDecompress(load_buf, &lzma_len,
-						       image_buf, image_len);
+			if (algo)
+				ret = lzmaBuffToBuffDecompressCb(load_buf,
+						&lzma_len, image_buf,
+						image_len, image_hash_input,
+						&feed);
+			else
+				ret = lzmaBuffToBuffDecompress(load_buf,
+						&lzma_len, image_buf,
+						image_len);
 			image_len = lzma_len;
 		}
 		break;
@@ -502,7 +563,8 @@ int image_decomp(int comp, ulong load, ulong image_start, int type,
 		if (!tools_build() && CONFIG_IS_ENABLED(LZ4)) {
 			size_t size = unc_len;
 
-			ret = ulz4fn(image_buf, image_len, load_buf, &size);
+			ret = ulz4fn_cb(image_buf, image_len, load_buf, &size,
+					algo ? image_hash_input : NULL, &feed);
 			image_len = size;
 		}
 		break;
@@ -512,7 +574,12 @@ int image_decomp(int comp, ulong load, ulong image_start, int type,
 
 			abuf_init_set(&in, image_buf, image_len);
 			abuf_init_set(&out, load_buf, unc_len);
-			ret = zstd_decompress(&in, &out);
+			if (algo)
+				ret = zstd_decompress_cb(&in, &out,
+							 image_hash_input,
+							 &feed);
+			else
+				ret = zstd_decompress(&in, &out);
 			if (ret >= 0) {
 				image_len = ret;
 				ret = 0;
@@ -527,11 +594,27 @@ int image_decomp(int comp, ulong load, ulong image_start, int type,
 	if (ret)
 		return ret;
 
+	/* Trailers and padding that the decompressor did not need */
+	if (algo && !feed.err && feed.done < in_len)
+		image_hash_input(&feed, image_buf + feed.done,
+				 in_len - feed.done);
+	if (feed.err)
+		return feed.err;
+
 	*load_end = load + image_len;
 
 	return 0;
 }
 
+int image_decomp(int comp, ulong load, ulong image_start, int type,
+		 void *load_buf, void *image_buf, ulong image_len,
+		 uint unc_len, ulong *load_end)
+{
+	return image_decomp_hash(comp, load, image_start, type, load_buf,
+				 image_buf, image_len, unc_len, load_end,
+				 NULL, NULL);
+}
+
 const table_entry_t *get_table_entry(const table_entry_t *table, int id)
 {
 	for (; table->id >= 0; ++table) {
@@ -522,11 +522,18 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		return 1;
 	}
 
+	/*
+	 * The kernel, initrd, FDT and overlays are fetched as a batch, so that
+	 * a network device is not set up again for each file
+	 */
+	if (IS_ENABLED(CONFIG_CMD_NET))
+		net_batch_start();
+
 	if (get_relfile_envaddr(ctx, label->kernel, "kernel_addr_r",
 				NULL) < 0) {
 		printf("Skipping %s for failure retrieving kernel\n",
 		       label->name);
-		return 1;
+		goto cleanup;
 	}
 
 	kernel_addr = env_get("kernel_addr_r");
@@ -537,7 +544,7 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		fit_addr = malloc(len);
 		if (!fit_addr) {
 			printf("malloc fail (FIT address)\n");
-			return 1;
+			goto cleanup;
 		}
 		snprintf(fit_addr, len, "%s%s", kernel_addr, label->config);
 		kernel_addr = fit_addr;
@@ -714,6 +721,9 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_CMD_NET))
+		net_batch_end();
+
 	bootm_argv[1] = kernel_addr;
 	zboot_argv[1] = kernel_addr;
 
@@ -756,8 +766,13 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		do_zboot_parent(ctx->cmdtp, 0, zboot_argc, zboot_argv, NULL);
 
 	unmap_sysmem(buf);
+	free(fit_addr);
+
+	return 1;
 
 cleanup:
+	if (IS_ENABLED(CONFIG_CMD_NET))
+		net_batch_end();
 	free(fit_addr);
 
 	return 1;
@@ -142,6 +142,8 @@ static int do_bootflow_scan(struct cmd_tbl *cmdtp, int flag, int argc,
 		flags |= BOOTFLOWF_SKIP_GLOBAL;
 	if (!no_hunter)
 		flags |= BOOTFLOWF_HUNT;
+	if (boot)
+		flags |= BOOTFLOWF_CACHE;
 
 	/*
 	 * If we have a device, just scan for bootflows attached to that device
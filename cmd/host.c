@@ -216,6 +216,73 @@ static int do_host_dev(struct cmd_tbl *cmdtp, int flag, int argc,
 	return 0;
 }
 
+static int do_host_timing(struct cmd_tbl *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	struct host_sb_timing *tim;
+	struct host_sb_plat *plat;
+	struct udevice *dev;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	dev = parse_host_label(argv[1]);
+	if (!dev)
+		return CMD_RET_FAILURE;
+
+	plat = dev_get_plat(dev);
+	tim = &plat->timing;
+	if (argc > 2) {
+		/* any values not given are set to 0 */
+		memset(tim, '\0', sizeof(*tim));
+		tim->latency_us = dectoul(argv[2], NULL);
+		if (argc > 3)
+			tim->rate_kbps = dectoul(argv[3], NULL);
+		if (argc > 4)
+			tim->max_blocks = dectoul(argv[4], NULL);
+		if (argc > 5)
+			tim->erase_blocks = dectoul(argv[5], NULL);
+		if (argc > 6)
+			tim->erase_us = dectoul(argv[6], NULL);
+	}
+
+	printf("latency: %u us\n"
+	       "rate: %u KiB/s\n"
+	       "max blocks/command: %u\n"
+	       "erase blocks: %u\n"
+	       "erase time: %u us\n",
+	       tim->latency_us, tim->rate_kbps, tim->max_blocks,
+	       tim->erase_blocks, tim->erase_us);
+
+	return 0;
+}
+
+static int do_host_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			 char *const argv[])
+{
+	struct host_sb_stats stats;
+	struct udevice *dev;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	dev = parse_host_label(argv[1]);
+	if (!dev)
+		return CMD_RET_FAILURE;
+
+	host_get_stats(dev, &stats);
+	printf("reads: %lu\n"
+	       "writes: %lu\n"
+	       "blocks read: %lu\n"
+	       "blocks written: %lu\n"
+	       "erases: %lu\n"
+	       "busy time: %llu us\n",
+	       stats.reads, stats.writes, stats.blks_read, stats.blks_written,
+	       stats.erases, (unsigned long long)stats.busy_us);
+
+	return 0;
+}
+
 static struct cmd_tbl cmd_host_sub[] = {
 	U_BOOT_CMD_MKENT(load, 7, 0, do_host_load, "", ""),
 	U_BOOT_CMD_MKENT(ls, 3, 0, do_host_ls, "", ""),
@@ -225,6 +292,8 @@ static struct cmd_tbl cmd_host_sub[] = {
 	U_BOOT_CMD_MKENT(unbind, 4, 0, do_host_unbind, "", ""),
 	U_BOOT_CMD_MKENT(info, 3, 0, do_host_info, "", ""),
 	U_BOOT_CMD_MKENT(dev, 0, 1, do_host_dev, "", ""),
+	U_BOOT_CMD_MKENT(timing, 7, 0, do_host_timing, "", ""),
+	U_BOOT_CMD_MKENT(stats, 2, 0, do_host_stats, "", ""),
 };
 
 static int do_host(struct cmd_tbl *cmdtp, int flag, int argc,
@@ -258,6 +327,9 @@ U_BOOT_CMD(
 	"host unbind <label>     - unbind file from \"host\" device\n"
 	"host info [<label>]     - show device binding & info\n"
 	"host dev [<label>]      - set or retrieve the current host device\n"
+	"host timing <label> [<latency_us> [<KiB/s> [<max_blocks>\n"
+	"     [<erase_blocks> [<erase_us>]]]]] - set or show the timing model\n"
+	"host stats <label>      - show and reset I/O statistics\n"
 	"host commands use the \"hostfs\" device. The \"host\" device is used\n"
 	"with standard IO commands such as fatls or ext2load"
 );
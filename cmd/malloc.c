@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Show malloc() statistics
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+
+static int do_malloc_info(struct cmd_tbl *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	struct malloc_slab_stats stats;
+	uint npages, nfree, cls;
+
+	printf("total bytes   = %#lx\n", mem_malloc_end - mem_malloc_start);
+	printf("heap top      = %#lx\n", mem_malloc_brk - mem_malloc_start);
+	if (!IS_ENABLED(CONFIG_SYS_MALLOC_SLAB) ||
+	    malloc_slab_get_pages(&npages, &nfree))
+		return 0;
+
+	printf("slab pages    = %u, %u free\n", npages, nfree);
+	printf("%5s %6s %7s %7s %9s %9s %5s\n", "size", "pages", "in use",
+	       "peak", "allocs", "fallback", "frag");
+	for (cls = 0; !malloc_slab_get_stats(cls, &stats); cls++) {
+		uint frag = 0;
+
+		/* free slots in pages assigned to this class */
+		if (stats.capacity)
+			frag = (stats.capacity - stats.inuse) * 100 /
+				stats.capacity;
+		printf("%5u %6u %7u %7u %9lu %9lu %4u%%\n", stats.size,
+		       stats.pages, stats.inuse, stats.peak, stats.allocs,
+		       stats.fallbacks, frag);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_SYS_LONGHELP
+static char malloc_help_text[] =
+	"info - show malloc() usage and slab statistics";
+#endif
+
+U_BOOT_CMD_WITH_SUBCMDS(malloc, "malloc information", malloc_help_text,
+	U_BOOT_SUBCMD_MKENT(info, 1, 1, do_malloc_info));
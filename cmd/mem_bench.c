@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Measure the throughput of the memory-copy primitives
+ *
+ * This is useful for comparing the generic lib/string.c routines with the
+ * architecture-specific ones, and for spotting unaligned-access penalties.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <div64.h>
+#include <malloc.h>
+#include <time.h>
+#include <linux/sizes.h>
+
+/* Amount of data to process for each measurement, unless told otherwise */
+#define BENCH_BYTES	SZ_16M
+
+enum bench_op {
+	BENCH_MEMCPY,
+	BENCH_MEMMOVE,
+	BENCH_MEMSET,
+	BENCH_MEMCMP,
+
+	BENCH_OP_COUNT,
+};
+
+static const char *const bench_op_name[BENCH_OP_COUNT] = {
+	"memcpy", "memmove", "memset", "memcmp",
+};
+
+/* Destination / source misalignments to try, in bytes */
+static const struct {
+	u8 dst;
+	u8 src;
+} bench_align[] = {
+	{ 0, 0 },
+	{ 1, 1 },
+	{ 0, 1 },
+	{ 3, 6 },
+};
+
+/* Sizes to use when none is given */
+static const ulong bench_default_size[] = { 64, SZ_4K, SZ_1M };
+
+/**
+ * bench_run() - Time one operation
+ *
+ * @op: Operation to run
+ * @dst: Destination buffer
+ * @src: Source buffer
+ * @size: Number of bytes to process in each call
+ * @count: Number of calls to make
+ * Return: elapsed time in microseconds
+ */
+static ulong bench_run(enum bench_op op, u8 *dst, u8 *src, ulong size,
+		       ulong count)
+{
+	static volatile int sink;
+	ulong start, i;
+
+	start = timer_get_us();
+	for (i = 0; i < count; i++) {
+		switch (op) {
+		case BENCH_MEMCPY:
+			memcpy(dst, src, size);
+			break;
+		case BENCH_MEMMOVE:
+			/* overlapping, so that memmove() must copy backwards */
+			memmove(dst + 8, dst, size);
+			break;
+		case BENCH_MEMSET:
+			memset(dst, i, size);
+			break;
+		case BENCH_MEMCMP:
+			sink = memcmp(dst, src, size);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return timer_get_us() - start;
+}
+
+/**
+ * bench_size() - Run all operations at all alignments for a given size
+ *
+ * @size: Number of bytes to process in each call
+ * @count: Number of calls to make, 0 to pick a suitable number
+ * Return: 0 if OK, -ENOMEM if out of memory
+ */
+static int bench_size(ulong size, ulong count)
+{
+	u8 *dst, *src;
+	int op, i;
+
+	if (!count)
+		count = max(BENCH_BYTES / size, 1UL);
+
+	/* leave room for the misalignment and the memmove() overlap */
+	dst = malloc(size + 16);
+	src = malloc(size + 16);
+	if (!dst || !src) {
+		free(dst);
+		free(src);
+		return -ENOMEM;
+	}
+	memset(src, 0xa5, size + 16);
+
+	for (op = 0; op < BENCH_OP_COUNT; op++) {
+		for (i = 0; i < ARRAY_SIZE(bench_align); i++) {
+			u64 bytes = (u64)size * count;
+			ulong us;
+
+			/* memcmp() must see equal buffers to scan them fully */
+			memset(dst, 0xa5, size + 16);
+			us = bench_run(op, dst + bench_align[i].dst,
+				       src + bench_align[i].src, size, count);
+			printf("%-8s %3d/%-3d %10lu %10lu ", bench_op_name[op],
+			       bench_align[i].dst, bench_align[i].src, size,
+			       us);
+			if (us)
+				printf("%10llu\n", lldiv(bytes, us));
+			else
+				printf("%10s\n", "-");
+		}
+	}
+	free(dst);
+	free(src);
+
+	return 0;
+}
+
+static int do_mem_bench(struct cmd_tbl *cmdtp, int flag, int argc,
+			char *const argv[])
+{
+	ulong size = 0, count = 0;
+	int ret, i;
+
+	if (argc > 1)
+		size = hextoul(argv[1], NULL);
+	if (argc > 2)
+		count = hextoul(argv[2], NULL);
+	if (argc > 1 && !size)
+		return CMD_RET_USAGE;
+
+	printf("%-8s %7s %10s %10s %10s\n", "op", "dst/src", "size", "us",
+	       "MB/s");
+	for (i = 0; i < ARRAY_SIZE(bench_default_size); i++) {
+		ret = bench_size(size ? size : bench_default_size[i], count);
+		if (ret) {
+			printf("Out of memory\n");
+			return CMD_RET_FAILURE;
+		}
+		if (size)
+			break;
+	}
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	membench, 3, 0, do_mem_bench,
+	"time memcpy/memmove/memset/memcmp",
+	"[<size> [<count>]]\n"
+	"    - <size>: bytes per call (hex), default 40, 1000 and 100000\n"
+	"    - <count>: calls per measurement (hex), default 16MiB worth"
+);
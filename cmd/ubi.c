@@ -73,6 +73,14 @@ static void display_ubi_info(struct ubi_device *ubi)
 	ubi_msg("number of PEBs reserved for bad PEB handling: %d",
 			ubi->beb_rsvd_pebs);
 	ubi_msg("max/mean erase counter: %d/%d", ubi->max_ec, ubi->mean_ec);
+	ubi_msg("attached from:              %s",
+		ubi->attach_stats.fastmap ? "fastmap" : "full scan");
+	ubi_msg("PEBs scanned:               %d",
+		ubi->attach_stats.scanned_pebs);
+	ubi_msg("attach time (us): scan %lu, vtbl %lu, wl %lu, eba %lu, fastmap write %lu",
+		ubi->attach_stats.scan_us, ubi->attach_stats.vtbl_us,
+		ubi->attach_stats.wl_us, ubi->attach_stats.eba_us,
+		ubi->attach_stats.fm_write_us);
 }
 
 static int ubi_info(int layout)
@@ -6,8 +6,10 @@
 
 #include <common.h>
 #include <command.h>
+#include <decomp_write.h>
 #include <env.h>
 #include <gzip.h>
+#include <image.h>
 #include <mapmem.h>
 #include <part.h>
 
@@ -91,3 +93,59 @@ U_BOOT_CMD(
 	"\t\tand is required for files with uncompressed lengths\n"
 	"\t\t4 GiB or larger\n"
 );
+
+#if IS_ENABLED(CONFIG_CMD_DECOMPWRITE)
+static int do_decompwrite(struct cmd_tbl *cmdtp, int flag,
+			  int argc, char *const argv[])
+{
+	struct blk_desc *bdev;
+	int comp, ret;
+	unsigned char *addr;
+	unsigned long length;
+	unsigned long writebuf = 1<<20;
+	u64 startoffs = 0;
+	u64 szexpected = 0;
+
+	if (argc < 5)
+		return CMD_RET_USAGE;
+	ret = blk_get_device_by_str(argv[1], argv[2], &bdev);
+	if (ret < 0)
+		return CMD_RET_FAILURE;
+
+	addr = map_sysmem(hextoul(argv[3], NULL), 0);
+	length = hextoul(argv[4], NULL);
+
+	if (5 < argc) {
+		writebuf = hextoul(argv[5], NULL);
+		if (6 < argc) {
+			startoffs = simple_strtoull(argv[6], NULL, 16);
+			if (7 < argc)
+				szexpected = simple_strtoull(argv[7],
+							     NULL, 16);
+		}
+	}
+
+	comp = image_decomp_type(addr, length);
+	if (comp <= IH_COMP_NONE) {
+		printf("Unknown compression format\n");
+		return CMD_RET_FAILURE;
+	}
+
+	ret = decomp_write(comp, addr, length, bdev, writebuf, startoffs,
+			   szexpected);
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	decompwrite, 8, 0, do_decompwrite,
+	"decompress and write memory to block device",
+	"<interface> <dev> <addr> length [wbuf=1M [offs=0 [outsize=0]]]\n"
+	"\tas gzwrite, but also accepts zstd, lz4 and lzma images\n"
+	"\twbuf is the size in bytes (hex) of write buffer\n"
+	"\t\tand should be padded to erase size for SSDs\n"
+	"\toffs is the output start offset in bytes (hex)\n"
+	"\toutsize is the size of the expected output (hex bytes)\n"
+	"\t\tand is checked once decompression is complete"
+);
+#endif
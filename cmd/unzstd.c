@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Decompress a Zstandard-compressed memory region
+ */
+
+#include <common.h>
+#include <abuf.h>
+#include <command.h>
+#include <env.h>
+#include <mapmem.h>
+#include <linux/zstd.h>
+
+static int do_unzstd(struct cmd_tbl *cmdtp, int flag, int argc,
+		     char *const argv[])
+{
+	const zstd_ddict *ddict = NULL;
+	ulong src, src_len, dst, dst_len = ~0UL;
+	struct abuf in, out;
+	int ret;
+
+	switch (argc) {
+	case 7:
+		ddict = zstd_ddict_create(map_sysmem(hextoul(argv[5], NULL), 0),
+					  hextoul(argv[6], NULL));
+		if (!ddict) {
+			printf("Cannot set up dictionary\n");
+			return CMD_RET_FAILURE;
+		}
+		/* fall through */
+	case 5:
+		dst_len = hextoul(argv[4], NULL);
+		/* fall through */
+	case 4:
+		src = hextoul(argv[1], NULL);
+		src_len = hextoul(argv[2], NULL);
+		dst = hextoul(argv[3], NULL);
+		break;
+	default:
+		return CMD_RET_USAGE;
+	}
+
+	/*
+	 * Decompression stops at the first thing after the last frame which
+	 * is not a frame, and never reads past the end of the source
+	 */
+	abuf_init_set(&in, map_sysmem(src, src_len), src_len);
+	abuf_init_set(&out, map_sysmem(dst, dst_len), dst_len);
+
+	ret = zstd_decompress_dict(&in, &out, ddict);
+	if (ddict)
+		zstd_ddict_free(ddict);
+	if (ret < 0) {
+		printf("Uncompressed err :%d\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	printf("Uncompressed size: %d = 0x%X\n", ret, ret);
+	env_set_hex("filesize", ret);
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(unzstd, 7, 1, do_unzstd,
+	   "Zstandard uncompress a memory region",
+	   "srcaddr srcsize dstaddr [dstsize [dictaddr dictsize]]\n"
+	   "  - all frames in srcsize bytes at srcaddr are decompressed,\n"
+	   "    skippable frames are ignored; the dictionary may be a zstd\n"
+	   "    dictionary or raw content"
+);
@@ -774,10 +774,7 @@ static int initf_bootstage(void)
 	if (ret)
 		return ret;
 	if (from_spl) {
-		const void *stash = map_sysmem(CONFIG_BOOTSTAGE_STASH_ADDR,
-					       CONFIG_BOOTSTAGE_STASH_SIZE);
-
-		ret = bootstage_unstash(stash, CONFIG_BOOTSTAGE_STASH_SIZE);
+		ret = bootstage_unstash_default();
 		if (ret && ret != -ENOENT) {
 			debug("Failed to unstash bootstage: err=%d\n", ret);
 			return ret;
@@ -841,9 +838,12 @@ static const init_fnc_t init_sequence_f[] = {
 #endif
 	initf_malloc,
 	log_init,
+#ifdef CONFIG_BOOTSTAGE_STASH_BLOBLIST
+	bloblist_init,		/* bootstage is stashed in the bloblist */
+#endif
 	initf_bootstage,	/* uses its own timer, so does not need DM */
 	event_init,
-#ifdef CONFIG_BLOBLIST
+#if defined(CONFIG_BLOBLIST) && !defined(CONFIG_BOOTSTAGE_STASH_BLOBLIST)
 	bloblist_init,
 #endif
 	setup_spl_handoff,
@@ -12,10 +12,12 @@
 #define LOG_CATEGORY	LOGC_BOOT
 
 #include <common.h>
+#include <bloblist.h>
 #include <bootstage.h>
 #include <hang.h>
 #include <log.h>
 #include <malloc.h>
+#include <mapmem.h>
 #include <sort.h>
 #include <spl.h>
 #include <asm/global_data.h>
@@ -502,6 +504,83 @@ int bootstage_unstash(const void *base, int size)
 	return 0;
 }
 
+/**
+ * bootstage_stash_size() - Get the number of bytes needed to stash the records
+ *
+ * Return: size of the stash, in bytes
+ */
+static int bootstage_stash_size(void)
+{
+	const struct bootstage_data *data = gd->bootstage;
+	const struct bootstage_record *rec;
+	char buf[20];
+	int size;
+	int i;
+
+	size = sizeof(struct bootstage_hdr) + data->rec_count * sizeof(*rec);
+	for (rec = data->record, i = 0; i < data->rec_count; i++, rec++)
+		size += strlen(get_record_name(buf, sizeof(buf), rec)) + 1;
+
+	return size;
+}
+
+/**
+ * use_bloblist() - Check whether the stash lives in the bloblist
+ *
+ * Return: true if the bloblist should be used for this phase
+ */
+static bool use_bloblist(void)
+{
+#if CONFIG_IS_ENABLED(BLOBLIST)
+	return IS_ENABLED(CONFIG_BOOTSTAGE_STASH_BLOBLIST) && gd->bloblist;
+#else
+	return false;
+#endif
+}
+
+int bootstage_stash_default(void)
+{
+	void *stash;
+	int size;
+	int ret;
+
+	if (!use_bloblist()) {
+		return bootstage_stash(map_sysmem(CONFIG_BOOTSTAGE_STASH_ADDR,
+						  CONFIG_BOOTSTAGE_STASH_SIZE),
+				       CONFIG_BOOTSTAGE_STASH_SIZE);
+	}
+
+	/* replace any records stashed by an earlier phase */
+	size = bootstage_stash_size();
+	if (bloblist_find(BLOBLISTT_U_BOOT_BOOTSTAGE, 0)) {
+		ret = bloblist_resize(BLOBLISTT_U_BOOT_BOOTSTAGE, size);
+		if (ret)
+			return log_msg_ret("res", ret);
+	}
+	stash = bloblist_ensure(BLOBLISTT_U_BOOT_BOOTSTAGE, size);
+	if (!stash)
+		return log_msg_ret("blob", -ENOSPC);
+
+	return bootstage_stash(stash, size);
+}
+
+int bootstage_unstash_default(void)
+{
+	const void *stash;
+
+	if (use_bloblist()) {
+		stash = bloblist_find(BLOBLISTT_U_BOOT_BOOTSTAGE, 0);
+		if (stash)
+			return bootstage_unstash(stash, -1);
+	}
+
+	/* the previous phase may not have had a bloblist */
+	stash = map_sysmem(CONFIG_BOOTSTAGE_STASH_ADDR,
+			   CONFIG_BOOTSTAGE_STASH_SIZE);
+
+	return bootstage_unstash(stash, CONFIG_BOOTSTAGE_STASH_SIZE);
+}
+
 int bootstage_get_size(void)
 {
 	struct bootstage_data *data = gd->bootstage;
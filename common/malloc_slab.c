@@ -0,0 +1,310 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Size-class slab front-end for malloc()
+ *
+ * Small allocations are served from pages of equal-sized objects, each size
+ * class having its own list of pages with free objects. This avoids the
+ * per-chunk header and minimum chunk size of dlmalloc and keeps the many
+ * small, long-lived driver-model allocations from fragmenting the main heap.
+ *
+ * The slab pages live in a fixed region at the start of the malloc() area,
+ * so that free() can tell a slab object from a dlmalloc chunk with a simple
+ * address check. When the region is full, requests fall back to dlmalloc.
+ */
+
+#define LOG_CATEGORY LOGC_ALLOC
+
+#include <common.h>
+#include <log.h>
+#include <malloc.h>
+#include <linux/list.h>
+#include <valgrind/memcheck.h>
+
+#define SLAB_PAGE_SHIFT		12
+#define SLAB_PAGE_SIZE		(1UL << SLAB_PAGE_SHIFT)
+
+/* Granule of the size lookup; all class sizes are multiples of this */
+#define SLAB_GRANULE_SHIFT	4
+
+static const u16 slab_size[] = {
+	16, 32, 48, 64, 96, 128, 192, 256, 384, MALLOC_SLAB_MAX
+};
+
+#define SLAB_CLASSES		ARRAY_SIZE(slab_size)
+
+/**
+ * struct slab_page - Descriptor for one page of the slab region
+ *
+ * @sibling: Node in the partial list of the class, or in the list of free
+ *	pages. A full page is on no list.
+ * @free: First free object in the page; each free object holds a pointer
+ *	to the next
+ * @class: Size class of the page
+ * @inuse: Number of objects allocated from the page
+ */
+struct slab_page {
+	struct list_head sibling;
+	void *free;
+	u16 class;
+	u16 inuse;
+};
+
+/**
+ * struct slab_class - State for one size class
+ *
+ * @partial: Pages of this class with at least one free object
+ * @stats: Statistics for this class
+ */
+struct slab_class {
+	struct list_head partial;
+	struct malloc_slab_stats stats;
+};
+
+/**
+ * struct slab_state - State of the slab allocator
+ *
+ * @ready: true once malloc_slab_init() has set up the region
+ * @desc: Page descriptors, one for each page
+ * @base: Address of the first page
+ * @end: Address just after the last page
+ * @npages: Total number of pages
+ * @nfree: Number of pages not assigned to any class
+ * @free: Pages not assigned to any class
+ * @lookup: Size class for each granule of request size
+ * @cls: Per-class state
+ */
+static struct slab_state {
+	bool ready;
+	struct slab_page *desc;
+	ulong base;
+	ulong end;
+	uint npages;
+	uint nfree;
+	struct list_head free;
+	u8 lookup[MALLOC_SLAB_MAX >> SLAB_GRANULE_SHIFT];
+	struct slab_class cls[SLAB_CLASSES];
+} slab;
+
+ulong malloc_slab_init(ulong start, ulong size)
+{
+	ulong len = CONFIG_SYS_MALLOC_SLAB_LEN;
+	uint i, cls;
+
+	memset(&slab, '\0', sizeof(slab));
+
+	/* leave most of a small malloc() area to dlmalloc */
+	if (len > size / 2) {
+		log_warning("malloc() area too small for slabs\n");
+		return 0;
+	}
+
+	slab.npages = len / (SLAB_PAGE_SIZE + sizeof(struct slab_page));
+	slab.desc = (struct slab_page *)start;
+	slab.base = ALIGN(start + slab.npages * sizeof(struct slab_page),
+			  SLAB_PAGE_SIZE);
+	while (slab.npages &&
+	       slab.base + slab.npages * SLAB_PAGE_SIZE > start + len)
+		slab.npages--;
+	if (!slab.npages)
+		return 0;
+	slab.end = slab.base + slab.npages * SLAB_PAGE_SIZE;
+
+	INIT_LIST_HEAD(&slab.free);
+	for (i = 0; i < slab.npages; i++)
+		list_add_tail(&slab.desc[i].sibling, &slab.free);
+	slab.nfree = slab.npages;
+
+	for (cls = 0, i = 0; i < ARRAY_SIZE(slab.lookup); i++) {
+		if (((i + 1) << SLAB_GRANULE_SHIFT) > slab_size[cls])
+			cls++;
+		slab.lookup[i] = cls;
+	}
+	for (cls = 0; cls < SLAB_CLASSES; cls++) {
+		INIT_LIST_HEAD(&slab.cls[cls].partial);
+		slab.cls[cls].stats.size = slab_size[cls];
+	}
+	slab.ready = true;
+	log_debug("%u slab pages at %lx\n", slab.npages, slab.base);
+
+	return slab.end - start;
+}
+
+static inline ulong slab_page_addr(struct slab_page *page)
+{
+	return slab.base + ((page - slab.desc) << SLAB_PAGE_SHIFT);
+}
+
+static inline struct slab_page *slab_page_of(const void *ptr)
+{
+	return &slab.desc[((ulong)ptr - slab.base) >> SLAB_PAGE_SHIFT];
+}
+
+/**
+ * slab_new_page() - Assign a free page to a size class
+ *
+ * @cls: Size class to assign the page to
+ * Return: page, or NULL if there are no free pages
+ */
+static struct slab_page *slab_new_page(uint cls)
+{
+	uint size = slab_size[cls];
+	struct slab_page *page;
+	void **obj;
+	ulong addr;
+
+	if (list_empty(&slab.free))
+		return NULL;
+	page = list_first_entry(&slab.free, struct slab_page, sibling);
+	list_del(&page->sibling);
+	slab.nfree--;
+
+	/* thread the free list through the objects, lowest address first */
+	addr = slab_page_addr(page);
+	page->free = (void *)addr;
+	for (; addr + 2 * size <= slab_page_addr(page) + SLAB_PAGE_SIZE;
+	     addr += size) {
+		obj = (void **)addr;
+		*obj = (void *)(addr + size);
+	}
+	*(void **)addr = NULL;
+	page->class = cls;
+	page->inuse = 0;
+	list_add(&page->sibling, &slab.cls[cls].partial);
+	slab.cls[cls].stats.pages++;
+
+	return page;
+}
+
+void *malloc_slab_alloc(size_t bytes)
+{
+	struct malloc_slab_stats *stats;
+	struct slab_page *page;
+	struct slab_class *sc;
+	void **obj;
+	uint cls;
+
+	if (!slab.ready || !bytes || bytes > MALLOC_SLAB_MAX)
+		return NULL;
+
+	cls = slab.lookup[(bytes - 1) >> SLAB_GRANULE_SHIFT];
+	sc = &slab.cls[cls];
+	stats = &sc->stats;
+	if (list_empty(&sc->partial)) {
+		page = slab_new_page(cls);
+		if (!page) {
+			stats->fallbacks++;
+			return NULL;
+		}
+	} else {
+		page = list_first_entry(&sc->partial, struct slab_page,
+					sibling);
+	}
+
+	obj = page->free;
+	page->free = *obj;
+	if (!page->free)
+		list_del(&page->sibling);
+	page->inuse++;
+	stats->inuse++;
+	stats->allocs++;
+	if (stats->inuse > stats->peak)
+		stats->peak = stats->inuse;
+	VALGRIND_MALLOCLIKE_BLOCK(obj, bytes, 0, false);
+
+	return obj;
+}
+
+bool malloc_slab_owns(const void *ptr)
+{
+	return slab.ready && (ulong)ptr >= slab.base && (ulong)ptr < slab.end;
+}
+
+bool malloc_slab_free(void *ptr)
+{
+	struct slab_page *page;
+	struct slab_class *sc;
+	bool was_full;
+
+	if (!malloc_slab_owns(ptr))
+		return false;
+
+	page = slab_page_of(ptr);
+	sc = &slab.cls[page->class];
+	was_full = !page->free;
+	*(void **)ptr = page->free;
+	page->free = ptr;
+	page->inuse--;
+	sc->stats.inuse--;
+	VALGRIND_FREELIKE_BLOCK(ptr, 0);
+
+	if (!page->inuse) {
+		/* give the page back so that any class can use it */
+		if (!was_full)
+			list_del(&page->sibling);
+		list_add(&page->sibling, &slab.free);
+		slab.nfree++;
+		sc->stats.pages--;
+	} else if (was_full) {
+		list_add(&page->sibling, &sc->partial);
+	}
+
+	return true;
+}
+
+size_t malloc_slab_usable_size(const void *ptr)
+{
+	if (!malloc_slab_owns(ptr))
+		return 0;
+
+	return slab_size[slab_page_of(ptr)->class];
+}
+
+void *malloc_slab_realloc(void *ptr, size_t bytes)
+{
+	size_t size = malloc_slab_usable_size(ptr);
+	void *new;
+
+	if (bytes && bytes <= size)
+		return ptr;
+
+	new = malloc(bytes);
+	if (!new)
+		return NULL;
+	memcpy(new, ptr, min(size, bytes));
+	free(ptr);
+
+	return new;
+}
+
+size_t malloc_slab_inuse_bytes(void)
+{
+	size_t total = 0;
+	uint cls;
+
+	for (cls = 0; cls < SLAB_CLASSES; cls++)
+		total += slab.cls[cls].stats.inuse * slab_size[cls];
+
+	return total;
+}
+
+int malloc_slab_get_stats(uint cls, struct malloc_slab_stats *stats)
+{
+	if (!slab.ready)
+		return -ENODEV;
+	if (cls >= SLAB_CLASSES)
+		return -ENOENT;
+	*stats = slab.cls[cls].stats;
+	stats->capacity = stats->pages * (SLAB_PAGE_SIZE / stats->size);
+
+	return 0;
+}
+
+int malloc_slab_get_pages(uint *npagesp, uint *nfreep)
+{
+	if (!slab.ready)
+		return -ENODEV;
+	*npagesp = slab.npages;
+	*nfreep = slab.nfree;
+
+	return 0;
+}
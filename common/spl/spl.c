@@ -459,6 +459,31 @@ __weak void __noreturn jump_to_image_no_args(struct spl_image_info *spl_image)
 	image_entry();
 }
 
+/**
+ * spl_bootstage_in_bloblist() - Check if bootstage records are in the bloblist
+ *
+ * Return: true if the records from the previous phase are in the bloblist, so
+ *	cannot be read until it is set up
+ */
+static bool spl_bootstage_in_bloblist(void)
+{
+	return IS_ENABLED(CONFIG_BOOTSTAGE_STASH_BLOBLIST) &&
+		CONFIG_IS_ENABLED(BLOBLIST);
+}
+
+/**
+ * spl_bootstage_unstash() - Read the bootstage records of the previous phase
+ */
+static void spl_bootstage_unstash(void)
+{
+	int ret;
+
+	ret = bootstage_unstash_default();
+	if (ret)
+		debug("%s: Failed to unstash bootstage: ret=%d\n", __func__,
+		      ret);
+}
+
 #if CONFIG_IS_ENABLED(HANDOFF)
 /**
  * Set up the SPL hand-off information
@@ -540,17 +565,10 @@ static int spl_common_init(bool setup_malloc)
 		      ret);
 		return ret;
 	}
-#ifdef CONFIG_BOOTSTAGE_STASH
-	if (!u_boot_first_phase()) {
-		const void *stash = map_sysmem(CONFIG_BOOTSTAGE_STASH_ADDR,
-					       CONFIG_BOOTSTAGE_STASH_SIZE);
-
-		ret = bootstage_unstash(stash, CONFIG_BOOTSTAGE_STASH_SIZE);
-		if (ret)
-			debug("%s: Failed to unstash bootstage: ret=%d\n",
-			      __func__, ret);
-	}
-#endif /* CONFIG_BOOTSTAGE_STASH */
+	/* with a bloblist, this waits until the bloblist is set up */
+	if (IS_ENABLED(CONFIG_BOOTSTAGE_STASH) && !u_boot_first_phase() &&
+	    !spl_bootstage_in_bloblist())
+		spl_bootstage_unstash();
 	bootstage_mark_name(get_bootstage_id(true),
 			    spl_phase_name(spl_phase()));
 #if CONFIG_IS_ENABLED(LOG)
@@ -776,6 +794,9 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 			hang();
 		}
 	}
+	if (IS_ENABLED(CONFIG_BOOTSTAGE_STASH) && !u_boot_first_phase() &&
+	    spl_bootstage_in_bloblist())
+		spl_bootstage_unstash();
 	if (CONFIG_IS_ENABLED(HANDOFF)) {
 		int ret;
 
@@ -828,6 +849,18 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 	}
 
 	spl_perform_fixups(&spl_image);
+
+	/*
+	 * Stash the bootstage records before the bloblist is finished, so they
+	 * are passed on whichever way the next image is started below
+	 */
+	bootstage_mark_name(get_bootstage_id(false), "end phase");
+	if (IS_ENABLED(CONFIG_BOOTSTAGE_STASH)) {
+		ret = bootstage_stash_default();
+		if (ret)
+			debug("Failed to stash bootstage: err=%d\n", ret);
+	}
+
 	if (CONFIG_IS_ENABLED(HANDOFF)) {
 		ret = write_spl_handoff();
 		if (ret)
@@ -881,14 +914,6 @@ void board_init_r(gd_t *dummy1, ulong dummy2)
 	debug("SPL malloc() used 0x%lx bytes (%ld KB)\n", gd->malloc_ptr,
 	      gd->malloc_ptr / 1024);
 #endif
-	bootstage_mark_name(get_bootstage_id(false), "end phase");
-#ifdef CONFIG_BOOTSTAGE_STASH
-	ret = bootstage_stash((void *)CONFIG_BOOTSTAGE_STASH_ADDR,
-			      CONFIG_BOOTSTAGE_STASH_SIZE);
-	if (ret)
-		debug("Failed to stash bootstage: err=%d\n", ret);
-#endif
-
 	spl_board_prepare_for_boot();
 	jump_to_image_no_args(&spl_image);
 }
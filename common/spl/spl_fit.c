@@ -10,6 +10,7 @@
 #include <gzip.h>
 #include <image.h>
 #include <log.h>
+#include <malloc.h>
 #include <memalign.h>
 #include <mapmem.h>
 #include <spl.h>
@@ -27,6 +28,38 @@ struct spl_fit_info {
 	int conf_node;		/* FDT offset to selected configuration node */
 };
 
+/* Number of blocks kept by struct spl_fit_blocks */
+#define SPL_FIT_SHARED_BLOCKS	8
+
+/* Marks an unused slot in struct spl_fit_blocks */
+#define SPL_FIT_NO_SECTOR	(~0UL)
+
+/**
+ * struct spl_fit_blocks - Copies of blocks read from the FIT
+ *
+ * With external data, mkimage packs the images one after another without
+ * padding, so the block holding the end of one image usually holds the start
+ * of another, and the last block of the FIT itself holds the start of the
+ * first image. The first and last block of each read are kept here, so that
+ * such a block is only read from the device once, whatever order the images
+ * are loaded in.
+ *
+ * @buf: Space for SPL_FIT_SHARED_BLOCKS blocks of @size bytes, or NULL
+ * @size: Size of each slot in @buf
+ * @bl_len: Size of the blocks being kept, 0 if none are kept
+ * @sector: Sector held in each slot, SPL_FIT_NO_SECTOR if none
+ * @next: Next slot to replace
+ */
+struct spl_fit_blocks {
+	u8 *buf;
+	int size;
+	int bl_len;
+	ulong sector[SPL_FIT_SHARED_BLOCKS];
+	int next;
+};
+
+static struct spl_fit_blocks fit_blocks;
+
 __weak void board_spl_fit_post_load(const void *fit)
 {
 }
@@ -172,6 +205,126 @@ static int spl_fit_get_image_node(const struct spl_fit_info *ctx,
 	return node;
 }
 
+/**
+ * spl_fit_blocks_init() - Prepare to keep blocks while loading a FIT
+ *
+ * Blocks are only kept for raw reads with a block size that leaves the rest
+ * of a read aligned for DMA once its first block is skipped.
+ *
+ * @info: Information about the device to load from
+ */
+static void spl_fit_blocks_init(struct spl_load_info *info)
+{
+	struct spl_fit_blocks *blks = &fit_blocks;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_SPL_LOAD_FIT_SHARED_BLOCKS))
+		return;
+
+	for (i = 0; i < SPL_FIT_SHARED_BLOCKS; i++)
+		blks->sector[i] = SPL_FIT_NO_SECTOR;
+	blks->next = 0;
+	blks->bl_len = 0;
+	if (info->filename || info->bl_len < 2 ||
+	    !IS_ALIGNED(info->bl_len, ARCH_DMA_MINALIGN))
+		return;
+
+	if (blks->size < info->bl_len) {
+		free(blks->buf);
+		blks->buf = malloc(SPL_FIT_SHARED_BLOCKS * info->bl_len);
+		blks->size = blks->buf ? info->bl_len : 0;
+	}
+	if (blks->buf)
+		blks->bl_len = info->bl_len;
+}
+
+/**
+ * spl_fit_block_find() - Find a kept block
+ *
+ * @sector: Sector number of the block
+ * Return: pointer to the copy of the block, or NULL if it is not kept
+ */
+static const u8 *spl_fit_block_find(ulong sector)
+{
+	struct spl_fit_blocks *blks = &fit_blocks;
+	int i;
+
+	for (i = 0; i < SPL_FIT_SHARED_BLOCKS; i++) {
+		if (blks->sector[i] == sector)
+			return blks->buf + i * blks->size;
+	}
+
+	return NULL;
+}
+
+/**
+ * spl_fit_block_keep() - Keep a copy of a block, replacing the oldest one
+ *
+ * @sector: Sector number of the block
+ * @data: Contents of the block
+ */
+static void spl_fit_block_keep(ulong sector, const void *data)
+{
+	struct spl_fit_blocks *blks = &fit_blocks;
+	int i;
+
+	if (spl_fit_block_find(sector))
+		return;
+	i = blks->next;
+	blks->next = (i + 1) % SPL_FIT_SHARED_BLOCKS;
+	memcpy(blks->buf + i * blks->size, data, blks->bl_len);
+	blks->sector[i] = sector;
+}
+
+/**
+ * spl_fit_read() - Read from the FIT, using kept blocks where possible
+ *
+ * This is a wrapper around @info->read which takes the first and last block
+ * from those kept by struct spl_fit_blocks when it can, so that only the
+ * blocks in between are read from the device.
+ *
+ * @info: Information about the device to load from
+ * @sector: Sector number to read from
+ * @count: Number of sectors to read
+ * @buf: Buffer to read into
+ * Return: number of sectors read, 0 on error
+ */
+static ulong spl_fit_read(struct spl_load_info *info, ulong sector,
+			  ulong count, void *buf)
+{
+	struct spl_fit_blocks *blks = &fit_blocks;
+	int bl_len = blks->bl_len;
+	ulong first = 0, last = count;
+	const u8 *blk;
+
+	if (!IS_ENABLED(CONFIG_SPL_LOAD_FIT_SHARED_BLOCKS) || !bl_len || !count)
+		return info->read(info, sector, count, buf);
+
+	blk = spl_fit_block_find(sector);
+	if (blk) {
+		memcpy(buf, blk, bl_len);
+		first++;
+	}
+	if (last > first) {
+		blk = spl_fit_block_find(sector + last - 1);
+		if (blk) {
+			memcpy(buf + (last - 1) * bl_len, blk, bl_len);
+			last--;
+		}
+	}
+	debug("fit read sector %lx, count %lx, %lx from device\n", sector,
+	      count, last - first);
+	if (last > first &&
+	    info->read(info, sector + first, last - first,
+		       buf + first * bl_len) != last - first)
+		return 0;
+
+	spl_fit_block_keep(sector, buf);
+	spl_fit_block_keep(sector + count - 1, buf + (count - 1) * bl_len);
+
+	return count;
+}
+
 static int get_aligned_image_offset(struct spl_load_info *info, int offset)
 {
 	/*
@@ -291,9 +444,9 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		overhead = get_aligned_image_overhead(info, offset);
 		nr_sectors = get_aligned_image_size(info, length, offset);
 
-		if (info->read(info,
-			       sector + get_aligned_image_offset(info, offset),
-			       nr_sectors, src_ptr) != nr_sectors)
+		if (spl_fit_read(info,
+				 sector + get_aligned_image_offset(info, offset),
+				 nr_sectors, src_ptr) != nr_sectors)
 			return -EIO;
 
 		debug("External data: dst=%p, offset=%x, size=%lx\n",
@@ -339,7 +492,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return -EIO;
 		}
 		length = size;
-	} else {
+	} else if (load_ptr != src) {
 		memcpy(load_ptr, src, length);
 	}
 
@@ -665,7 +818,7 @@ static int spl_simple_fit_read(struct spl_fit_info *ctx,
 	sectors = get_aligned_image_size(info, size, 0);
 	buf = board_spl_fit_buffer_addr(size, sectors, info->bl_len);
 
-	count = info->read(info, sector, sectors, buf);
+	count = spl_fit_read(info, sector, sectors, buf);
 	ctx->fit = buf;
 	debug("fit read sector %lx, sectors=%d, dst=%p, count=%lu, size=0x%lx\n",
 	      sector, sectors, buf, count, size);
@@ -709,6 +862,7 @@ int spl_load_simple_fit(struct spl_image_info *spl_image,
 	int index = 0;
 	int firmware_node;
 
+	spl_fit_blocks_init(info);
 	ret = spl_simple_fit_read(&ctx, info, sector, fit);
 	if (ret < 0)
 		return ret;
@@ -59,6 +59,7 @@ struct usb_device_scan {
 };
 
 static LIST_HEAD(usb_scan_list);
+static bool usb_scan_deferred;
 
 __weak void usb_hub_reset_devices(struct usb_hub_device *hub, int port)
 {
@@ -563,8 +564,11 @@ static int usb_device_list_scan(void)
 	static int running;
 	int ret = 0;
 
-	/* Only run this loop once for each controller */
-	if (running)
+	/*
+	 * Only run this loop once for each controller. While deferred, the
+	 * ports stay on the list for usb_hub_scan_ports() to pick up.
+	 */
+	if (running || usb_scan_deferred)
 		return 0;
 
 	running = 1;
@@ -595,6 +599,18 @@ out:
 	return ret;
 }
 
+void usb_hub_defer_port_scan(bool defer)
+{
+	usb_scan_deferred = defer;
+}
+
+int usb_hub_scan_ports(void)
+{
+	usb_scan_deferred = false;
+
+	return usb_device_list_scan();
+}
+
 static struct usb_hub_device *usb_get_hub_device(struct usb_device *dev)
 {
 	struct usb_hub_device *hub;
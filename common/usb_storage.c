@@ -44,6 +44,7 @@
 #include <asm/byteorder.h>
 #include <asm/cache.h>
 #include <asm/processor.h>
+#include <asm/unaligned.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 #include <linux/delay.h>
@@ -61,7 +62,7 @@
 static const unsigned char us_direction[256/8] = {
 	0x28, 0x81, 0x14, 0x14, 0x20, 0x01, 0x90, 0x77,
 	0x0C, 0x20, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01,
+	0x00, 0x01, 0x00, 0x40, 0x00, 0x01, 0x00, 0x01,
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 #define US_DIRECTION(x) ((us_direction[x>>3] >> (x & 7)) & 1)
@@ -974,9 +975,17 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 	 * Windows 7 limiting transfers to 128 sectors for both USB2 and USB3
 	 * and Apple Mac OS X 10.11 limiting transfers to 256 sectors for USB2
 	 * and 2048 for USB3 devices.
+	 *
+	 * SuperSpeed devices do not share the legacy IDE heritage, so follow
+	 * Mac OS X and allow 2048 sectors for them. Every command costs a full
+	 * CBW/data/CSW round trip, so this cuts the number of round trips for
+	 * large reads by nearly an order of magnitude.
 	 */
 	unsigned short blk = 240;
 
+	if (udev->speed >= USB_SPEED_SUPER)
+		blk = 2048;
+
 #if CONFIG_IS_ENABLED(DM_USB)
 	size_t size;
 	int ret;
@@ -1082,6 +1091,30 @@ static int usb_read_capacity(struct scsi_cmd *srb, struct us_data *ss)
 	return -1;
 }
 
+/*
+ * Read capacity (16) is used for devices with more than 2^32 blocks, where
+ * read capacity (10) reports 0xffffffff. The response holds a 64-bit last
+ * block address followed by the 32-bit block length.
+ */
+static int usb_read_capacity_16(struct scsi_cmd *srb, struct us_data *ss)
+{
+	int retry;
+
+	retry = 3;
+	do {
+		memset(&srb->cmd[0], 0, 16);
+		srb->cmd[0] = SCSI_RD_CAPAC16;
+		srb->cmd[1] = 0x10;	/* service action: read capacity */
+		srb->cmd[13] = 32;	/* allocation length */
+		srb->datalen = 32;
+		srb->cmdlen = 16;
+		if (ss->transport(srb, ss) == USB_STOR_TRANSPORT_GOOD)
+			return 0;
+	} while (retry--);
+
+	return -1;
+}
+
 static int usb_read_10(struct scsi_cmd *srb, struct us_data *ss,
 		       unsigned long start, unsigned short blocks)
 {
@@ -1116,6 +1149,57 @@ static int usb_write_10(struct scsi_cmd *srb, struct us_data *ss,
 	return ss->transport(srb, ss);
 }
 
+static void usb_setup_rw_16(struct scsi_cmd *srb, u8 opcode, lbaint_t start,
+			    unsigned short blocks)
+{
+	memset(&srb->cmd[0], 0, 16);
+	srb->cmd[0] = opcode;
+	put_unaligned_be64(start, &srb->cmd[2]);
+	put_unaligned_be32(blocks, &srb->cmd[10]);
+	srb->cmdlen = 16;
+}
+
+static int usb_read_16(struct scsi_cmd *srb, struct us_data *ss,
+		       lbaint_t start, unsigned short blocks)
+{
+	usb_setup_rw_16(srb, SCSI_READ16, start, blocks);
+	debug("read16: start " LBAF " blocks %x\n", start, blocks);
+	return ss->transport(srb, ss);
+}
+
+static int usb_write_16(struct scsi_cmd *srb, struct us_data *ss,
+			lbaint_t start, unsigned short blocks)
+{
+	usb_setup_rw_16(srb, SCSI_WRITE16, start, blocks);
+	debug("write16: start " LBAF " blocks %x\n", start, blocks);
+	return ss->transport(srb, ss);
+}
+
+/*
+ * READ(10) and WRITE(10) carry a 32-bit LBA, so anything ending beyond that
+ * must use the 16-byte variants.
+ */
+static bool usb_stor_need_16(lbaint_t start, unsigned short blocks)
+{
+	return (u64)start + blocks > 0x100000000ULL;
+}
+
+static int usb_stor_read_blocks(struct scsi_cmd *srb, struct us_data *ss,
+				lbaint_t start, unsigned short blocks)
+{
+	if (usb_stor_need_16(start, blocks))
+		return usb_read_16(srb, ss, start, blocks);
+	return usb_read_10(srb, ss, start, blocks);
+}
+
+static int usb_stor_write_blocks(struct scsi_cmd *srb, struct us_data *ss,
+				 lbaint_t start, unsigned short blocks)
+{
+	if (usb_stor_need_16(start, blocks))
+		return usb_write_16(srb, ss, start, blocks);
+	return usb_write_10(srb, ss, start, blocks);
+}
+
 
 #ifdef CONFIG_USB_BIN_FIXUP
 /*
@@ -1199,7 +1283,7 @@ retry_it:
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (usb_read_10(srb, ss, start, smallblks)) {
+		if (usb_stor_read_blocks(srb, ss, start, smallblks)) {
 			debug("Read ERROR\n");
 			ss->flags &= ~USB_READY;
 			usb_request_sense(srb, ss);
@@ -1208,6 +1292,8 @@ retry_it:
 			blkcnt -= blks;
 			break;
 		}
+		/* the device answered, so drop the not-ready settle delay */
+		ss->flags |= USB_READY;
 		start += smallblks;
 		blks -= smallblks;
 		buf_addr += srb->datalen;
@@ -1286,7 +1372,7 @@ retry_it:
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (usb_write_10(srb, ss, start, smallblks)) {
+		if (usb_stor_write_blocks(srb, ss, start, smallblks)) {
 			debug("Write ERROR\n");
 			ss->flags &= ~USB_READY;
 			usb_request_sense(srb, ss);
@@ -1295,6 +1381,7 @@ retry_it:
 			blkcnt -= blks;
 			break;
 		}
+		ss->flags |= USB_READY;
 		start += smallblks;
 		blks -= smallblks;
 		buf_addr += srb->datalen;
@@ -1438,9 +1525,10 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 		      struct blk_desc *dev_desc)
 {
 	unsigned char perq, modi;
-	ALLOC_CACHE_ALIGN_BUFFER(u32, cap, 2);
+	ALLOC_CACHE_ALIGN_BUFFER(u32, cap, 8);
 	ALLOC_CACHE_ALIGN_BUFFER(u8, usb_stor_buf, 36);
-	u32 capacity, blksz;
+	lbaint_t capacity;
+	u32 blksz;
 	struct scsi_cmd *pccb = &usb_ccb;
 
 	pccb->pdata = usb_stor_buf;
@@ -1510,7 +1598,19 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 	capacity = be32_to_cpu(cap[0]) + 1;
 	blksz = be32_to_cpu(cap[1]);
 
-	debug("Capacity = 0x%08x, blocksz = 0x%08x\n", capacity, blksz);
+	/*
+	 * Too large for read capacity (10), so ask for the 64-bit form, if
+	 * there is room for it in lbaint_t
+	 */
+	if (sizeof(lbaint_t) > sizeof(u32) && cap[0] == 0xffffffff) {
+		memset(pccb->pdata, 0, 32);
+		if (!usb_read_capacity_16(pccb, ss)) {
+			capacity = get_unaligned_be64(cap) + 1;
+			blksz = be32_to_cpu(cap[2]);
+		}
+	}
+
+	debug("Capacity = " LBAF ", blocksz = 0x%08x\n", capacity, blksz);
 	dev_desc->lba = capacity;
 	dev_desc->blksz = blksz;
 	dev_desc->log2blksz = LOG2(dev_desc->blksz);
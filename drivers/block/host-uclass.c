@@ -127,6 +127,14 @@ int host_detach_file(struct udevice *dev)
 	return ops->detach_file(dev);
 }
 
+void host_get_stats(struct udevice *dev, struct host_sb_stats *stats)
+{
+	struct host_sb_plat *plat = dev_get_plat(dev);
+
+	*stats = plat->stats;
+	memset(&plat->stats, '\0', sizeof(plat->stats));
+}
+
 struct udevice *host_find_by_label(const char *label)
 {
 	struct udevice *dev;
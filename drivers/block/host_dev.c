@@ -63,6 +63,7 @@ static int host_sb_attach_file(struct udevice *dev, const char *filename)
 	plat = dev_get_plat(dev);
 	plat->fd = fd;
 	plat->filename = fname;
+	memset(&plat->stats, '\0', sizeof(plat->stats));
 
 	return 0;
 
@@ -5,6 +5,7 @@
 
 #include <common.h>
 #include <blk.h>
+#include <div64.h>
 #include <dm.h>
 #include <fdtdec.h>
 #include <part.h>
@@ -14,10 +15,58 @@
 #include <asm/global_data.h>
 #include <dm/device_compat.h>
 #include <dm/device-internal.h>
+#include <linux/delay.h>
 #include <linux/errno.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/**
+ * host_block_account() - Record a transfer and wait for the time it takes
+ *
+ * This models the time taken by a real storage device, as set up in the
+ * host device's timing. The time is added to the statistics, so it can be
+ * compared between runs, and also waited for, so that it shows up in
+ * bootstage and other timing.
+ *
+ * @plat: Host device
+ * @start: First block transferred
+ * @blkcnt: Number of blocks transferred
+ * @blksz: Size of each block in bytes
+ * @write: true for a write, false for a read
+ */
+static void host_block_account(struct host_sb_plat *plat, lbaint_t start,
+			       lbaint_t blkcnt, ulong blksz, bool write)
+{
+	const struct host_sb_timing *tim = &plat->timing;
+	struct host_sb_stats *stats = &plat->stats;
+	ulong cmds, erases = 0;
+	u64 us;
+
+	if (!blkcnt)
+		return;
+	cmds = tim->max_blocks ? DIV_ROUND_UP(blkcnt, tim->max_blocks) : 1;
+	us = (u64)cmds * tim->latency_us;
+	if (tim->rate_kbps)
+		us += lldiv((u64)blkcnt * blksz * 1000000,
+			    tim->rate_kbps * 1024ULL);
+	if (write) {
+		if (tim->erase_blocks) {
+			erases = (start + blkcnt - 1) / tim->erase_blocks -
+				start / tim->erase_blocks + 1;
+			us += (u64)erases * tim->erase_us;
+		}
+		stats->writes += cmds;
+		stats->blks_written += blkcnt;
+		stats->erases += erases;
+	} else {
+		stats->reads += cmds;
+		stats->blks_read += blkcnt;
+	}
+	stats->busy_us += us;
+	if (us)
+		udelay(us);
+}
+
 static unsigned long host_block_read(struct udevice *dev,
 				     unsigned long start, lbaint_t blkcnt,
 				     void *buffer)
@@ -31,8 +80,11 @@ static unsigned long host_block_read(struct udevice *dev,
 		return -1;
 	}
 	ssize_t len = os_read(plat->fd, buffer, blkcnt * desc->blksz);
-	if (len >= 0)
+	if (len >= 0) {
+		host_block_account(plat, start, len / desc->blksz, desc->blksz,
+				   false);
 		return len / desc->blksz;
+	}
 
 	return -EIO;
 }
@@ -50,8 +102,11 @@ static unsigned long host_block_write(struct udevice *dev,
 		return -1;
 	}
 	ssize_t len = os_write(plat->fd, buffer, blkcnt * desc->blksz);
-	if (len >= 0)
+	if (len >= 0) {
+		host_block_account(plat, start, len / desc->blksz, desc->blksz,
+				   true);
 		return len / desc->blksz;
+	}
 
 	return -EIO;
 }
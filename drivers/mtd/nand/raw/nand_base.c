@@ -2316,6 +2316,87 @@ static int nand_setup_read_retry(struct mtd_info *mtd, int retry_mode)
 	return chip->setup_read_retry(mtd, retry_mode);
 }
 
+/**
+ * nand_can_cache_read - [INTERN] Check if READ CACHE SEQUENTIAL can be used
+ * @mtd: MTD device structure
+ * @ops: oob ops structure
+ *
+ * The cache read commands are issued through the default large page command
+ * function, and the page reader must only transfer data, never send commands
+ * of its own. Read retry is not supported: by the time a page fails ECC the
+ * next one is already being loaded with the old threshold.
+ */
+static bool nand_can_cache_read(struct mtd_info *mtd, struct mtd_oob_ops *ops)
+{
+	struct nand_chip *chip = mtd_to_nand(mtd);
+
+	if (!IS_ENABLED(CONFIG_SYS_NAND_CACHE_READ) || !chip->onfi_version ||
+	    !(le16_to_cpu(chip->onfi_params.opt_cmd) & ONFI_OPT_CMD_READ_CACHE))
+		return false;
+
+	if (ops->oobbuf || ops->mode == MTD_OPS_RAW)
+		return false;
+
+	if (chip->cmdfunc != nand_command_lp ||
+	    !nand_standard_page_accessors(&chip->ecc) ||
+	    chip->options & NAND_NEED_READRDY || chip->read_retries > 1)
+		return false;
+
+	return chip->ecc.read_page == nand_read_page_hwecc ||
+	       (chip->ecc.read_page == nand_read_page_swecc &&
+		chip->ecc.read_page_raw == nand_read_page_raw);
+}
+
+/**
+ * nand_cache_read_last - [INTERN] Find the last page of a cache read sequence
+ * @mtd: MTD device structure
+ * @page: first page of the sequence
+ * @col: column address of the first page
+ * @readlen: number of bytes left to read
+ *
+ * A sequence covers whole pages only and stops at the end of the block.
+ * Returns the last page, or -1 if fewer than two pages qualify.
+ */
+static int nand_cache_read_last(struct mtd_info *mtd, int page, int col,
+				uint32_t readlen)
+{
+	struct nand_chip *chip = mtd_to_nand(mtd);
+	int pages_per_block = 1 << (chip->phys_erase_shift - chip->page_shift);
+	int last;
+
+	if (col || readlen < 2 * mtd->writesize)
+		return -1;
+
+	last = page + readlen / mtd->writesize - 1;
+	last = min(last, (page | (pages_per_block - 1)));
+
+	return last > page ? last : -1;
+}
+
+/**
+ * nand_read_cache_op - [INTERN] Move a page to the cache register
+ * @chip: The NAND chip
+ * @page: page to read
+ * @start: @page is the first page of the sequence
+ * @end: @page is the last page of the sequence
+ *
+ * The first page is loaded with a regular READ PAGE. READ CACHE SEQUENTIAL
+ * then moves it to the cache register and starts loading the next page into
+ * the data register while the current one is transferred; READ CACHE END
+ * moves the last page without starting another array read.
+ */
+static void nand_read_cache_op(struct nand_chip *chip, int page, bool start,
+			       bool end)
+{
+	struct mtd_info *mtd = nand_to_mtd(chip);
+
+	if (start)
+		chip->cmdfunc(mtd, NAND_CMD_READ0, 0, page);
+
+	chip->cmdfunc(mtd, end ? NAND_CMD_READCACHEEND : NAND_CMD_READCACHESEQ,
+		      -1, -1);
+}
+
 /**
  * nand_do_read_ops - [INTERN] Read data with ECC
  * @mtd: MTD device structure
@@ -2339,6 +2420,8 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 	unsigned int max_bitflips = 0;
 	int retry_mode = 0;
 	bool ecc_fail = false;
+	bool cache_read, cache_start = false;
+	int cache_last = -1;
 
 	chipnr = (int)(from >> chip->chip_shift);
 	chip->select_chip(mtd, chipnr);
@@ -2352,6 +2435,8 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 	oob = ops->oobbuf;
 	oob_required = oob ? 1 : 0;
 
+	cache_read = nand_can_cache_read(mtd, ops);
+
 	while (1) {
 		unsigned int ecc_failures = mtd->ecc_stats.failed;
 
@@ -2367,8 +2452,11 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 		else
 			use_bufpoi = 0;
 
-		/* Is the current page in the buffer? */
-		if (realpage != chip->pagebuf || oob) {
+		/*
+		 * Is the current page in the buffer? A cache read sequence
+		 * must still move each of its pages out of the chip.
+		 */
+		if (realpage != chip->pagebuf || oob || cache_last >= 0) {
 			bufpoi = use_bufpoi ? chip->buffers->databuf : buf;
 
 			if (use_bufpoi && aligned)
@@ -2376,7 +2464,19 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 						 __func__, buf);
 
 read_retry:
-			if (nand_standard_page_accessors(&chip->ecc)) {
+			if (cache_read && cache_last < 0) {
+				cache_last = nand_cache_read_last(mtd, page,
+								  col, readlen);
+				cache_start = true;
+			}
+
+			if (cache_last >= 0) {
+				nand_read_cache_op(chip, page, cache_start,
+						   page == cache_last);
+				cache_start = false;
+				if (page == cache_last)
+					cache_last = -1;
+			} else if (nand_standard_page_accessors(&chip->ecc)) {
 				ret = nand_read_page_op(chip, page, 0, NULL, 0);
 				if (ret)
 					break;
@@ -2490,6 +2590,11 @@ read_retry:
 			chip->select_chip(mtd, chipnr);
 		}
 	}
+
+	/* Bailed out in the middle of a cache read sequence */
+	if (cache_last >= 0)
+		chip->cmdfunc(mtd, NAND_CMD_READCACHEEND, -1, -1);
+
 	chip->select_chip(mtd, -1);
 
 	ops->retlen = ops->len - (size_t) readlen;
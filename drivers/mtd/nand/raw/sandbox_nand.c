@@ -0,0 +1,485 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Sandbox raw NAND emulator
+ *
+ * This emulates a small ONFI chip with large pages behind a controller which
+ * passes commands, addresses and data straight through, so that the generic
+ * large-page command function and software ECC are used. Besides reading,
+ * programming and erasing pages it implements READ CACHE SEQUENTIAL and READ
+ * CACHE END with separate data and cache registers, and counts how they are
+ * used, so that cache reads can be checked against ordinary page reads.
+ */
+
+#define LOG_CATEGORY UCLASS_MTD
+
+#include <common.h>
+#include <dm.h>
+#include <log.h>
+#include <malloc.h>
+#include <nand.h>
+#include <asm/test.h>
+#include <linux/mtd/rawnand.h>
+
+#define SB_NAND_PAGE_SIZE	2048
+#define SB_NAND_OOB_SIZE	64
+#define SB_NAND_RAW_SIZE	(SB_NAND_PAGE_SIZE + SB_NAND_OOB_SIZE)
+#define SB_NAND_PAGES_PER_BLOCK	64
+#define SB_NAND_BLOCKS		16
+#define SB_NAND_PAGES		(SB_NAND_PAGES_PER_BLOCK * SB_NAND_BLOCKS)
+
+/* The device ID is not in nand_ids.c, so the ONFI parameter page is used */
+#define SB_NAND_MFR_ID		NAND_MFR_STMICRO
+#define SB_NAND_DEV_ID		0x7a
+
+/* Number of copies of the parameter page returned by NAND_CMD_PARAM */
+#define SB_NAND_PARAM_COPIES	3
+
+/**
+ * struct sandbox_nand_priv - Private data for the NAND emulator
+ *
+ * @chip: NAND chip, as seen by the NAND core
+ * @mem: Contents of the chip, SB_NAND_RAW_SIZE bytes for each page
+ * @cmd: Last command received
+ * @addr: Address cycles received since @cmd
+ * @addr_cycles: Number of address cycles in @addr
+ * @addr_done: true if the address has been acted upon
+ * @read_status: true if read_byte() returns the status register
+ * @out: Data returned by read_byte() and read_buf(), NULL if none
+ * @out_len: Number of bytes in @out
+ * @col: Column for the next read or write
+ * @data_page: Page in @data, or -1 if none
+ * @data: Data register, which holds the page last read from the array
+ * @cache: Cache register, which the host reads from
+ * @prog_page: Page being programmed, or -1 if none
+ * @prog: Data to be programmed
+ * @status: Value of the status register
+ * @id: Response to NAND_CMD_READID at address 0
+ * @param: Response to NAND_CMD_PARAM
+ * @stats: Usage counters
+ */
+struct sandbox_nand_priv {
+	struct nand_chip chip;
+	u8 *mem;
+	u8 cmd;
+	u8 addr[5];
+	int addr_cycles;
+	bool addr_done;
+	bool read_status;
+	const u8 *out;
+	int out_len;
+	int col;
+	int data_page;
+	u8 data[SB_NAND_RAW_SIZE];
+	u8 cache[SB_NAND_RAW_SIZE];
+	int prog_page;
+	u8 prog[SB_NAND_RAW_SIZE];
+	u8 status;
+	u8 id[8];
+	struct nand_onfi_params param[SB_NAND_PARAM_COPIES];
+	struct sandbox_nand_stats stats;
+};
+
+static struct sandbox_nand_priv *mtd_to_sandbox_nand(struct mtd_info *mtd)
+{
+	return nand_get_controller_data(mtd_to_nand(mtd));
+}
+
+static u8 *sandbox_nand_page(struct sandbox_nand_priv *priv, int page)
+{
+	return priv->mem + page * SB_NAND_RAW_SIZE;
+}
+
+static void sandbox_nand_set_out(struct sandbox_nand_priv *priv,
+				 const void *out, int len, int col)
+{
+	priv->out = out;
+	priv->out_len = len;
+	priv->col = col;
+}
+
+/* Column and row from a five-cycle (READ0, SEQIN) or two-cycle address */
+static int sandbox_nand_col(struct sandbox_nand_priv *priv)
+{
+	return priv->addr[0] | priv->addr[1] << 8;
+}
+
+static int sandbox_nand_row(struct sandbox_nand_priv *priv, int first)
+{
+	int row = 0;
+	int i;
+
+	for (i = priv->addr_cycles - 1; i >= first; i--)
+		row = row << 8 | priv->addr[i];
+
+	if (row >= SB_NAND_PAGES) {
+		log_debug("Page %#x out of range\n", row);
+		priv->stats.errors++;
+		return -1;
+	}
+
+	return row;
+}
+
+/* Load a page from the array into the data register */
+static void sandbox_nand_load(struct sandbox_nand_priv *priv, int page)
+{
+	priv->data_page = page;
+	if (page >= 0)
+		memcpy(priv->data, sandbox_nand_page(priv, page),
+		       SB_NAND_RAW_SIZE);
+}
+
+/*
+ * READ CACHE SEQUENTIAL and READ CACHE END move the data register to the cache
+ * register. READ CACHE SEQUENTIAL then loads the next page, which must be in
+ * the same block.
+ */
+static void sandbox_nand_cache_op(struct sandbox_nand_priv *priv, bool end)
+{
+	int page = priv->data_page;
+
+	if (page < 0) {
+		log_debug("Cache read without a page\n");
+		priv->stats.errors++;
+		return;
+	}
+
+	memcpy(priv->cache, priv->data, SB_NAND_RAW_SIZE);
+	sandbox_nand_set_out(priv, priv->cache, SB_NAND_RAW_SIZE, 0);
+
+	if (end) {
+		priv->stats.cache_end++;
+		page = -1;
+	} else {
+		priv->stats.cache_seq++;
+		page++;
+		if (!(page % SB_NAND_PAGES_PER_BLOCK)) {
+			log_debug("Cache read crosses into block %d\n",
+				  page / SB_NAND_PAGES_PER_BLOCK);
+			priv->stats.errors++;
+			page = -1;
+		}
+	}
+	sandbox_nand_load(priv, page);
+}
+
+/* Act on a command which takes effect as soon as its address is complete */
+static void sandbox_nand_addr_done(struct sandbox_nand_priv *priv)
+{
+	if (priv->addr_done || !priv->addr_cycles)
+		return;
+	priv->addr_done = true;
+
+	switch (priv->cmd) {
+	case NAND_CMD_READID:
+		if (priv->addr[0] == 0x20)
+			sandbox_nand_set_out(priv, "ONFI", 4, 0);
+		else
+			sandbox_nand_set_out(priv, priv->id, sizeof(priv->id),
+					     0);
+		break;
+	case NAND_CMD_PARAM:
+		sandbox_nand_set_out(priv, priv->param, sizeof(priv->param),
+				     0);
+		break;
+	case NAND_CMD_SEQIN:
+		priv->prog_page = sandbox_nand_row(priv, 2);
+		memset(priv->prog, 0xff, SB_NAND_RAW_SIZE);
+		priv->col = sandbox_nand_col(priv);
+		break;
+	case NAND_CMD_RNDIN:
+		priv->col = sandbox_nand_col(priv);
+		break;
+	default:
+		/* These act when the second command cycle arrives */
+		priv->addr_done = false;
+		break;
+	}
+}
+
+static void sandbox_nand_command(struct sandbox_nand_priv *priv, u8 cmd)
+{
+	int page;
+
+	priv->read_status = cmd == NAND_CMD_STATUS;
+
+	switch (cmd) {
+	case NAND_CMD_READSTART:
+		/* without an address this just ends a status read */
+		if (!priv->addr_cycles)
+			return;
+		page = sandbox_nand_row(priv, 2);
+		if (page < 0)
+			return;
+		sandbox_nand_load(priv, page);
+		memcpy(priv->cache, priv->data, SB_NAND_RAW_SIZE);
+		sandbox_nand_set_out(priv, priv->cache, SB_NAND_RAW_SIZE,
+				     sandbox_nand_col(priv));
+		priv->stats.page_reads++;
+		return;
+	case NAND_CMD_READCACHESEQ:
+		sandbox_nand_cache_op(priv, false);
+		break;
+	case NAND_CMD_READCACHEEND:
+		sandbox_nand_cache_op(priv, true);
+		break;
+	case NAND_CMD_RNDOUTSTART:
+		priv->col = sandbox_nand_col(priv);
+		return;
+	case NAND_CMD_PAGEPROG:
+		page = priv->prog_page;
+		if (page >= 0) {
+			u8 *dst = sandbox_nand_page(priv, page);
+			int i;
+
+			/* programming can only clear bits */
+			for (i = 0; i < SB_NAND_RAW_SIZE; i++)
+				dst[i] &= priv->prog[i];
+		}
+		priv->prog_page = -1;
+		return;
+	case NAND_CMD_ERASE2:
+		page = sandbox_nand_row(priv, 0);
+		if (page >= 0) {
+			page &= ~(SB_NAND_PAGES_PER_BLOCK - 1);
+			memset(sandbox_nand_page(priv, page), 0xff,
+			       SB_NAND_PAGES_PER_BLOCK * SB_NAND_RAW_SIZE);
+		}
+		return;
+	case NAND_CMD_RESET:
+		sandbox_nand_load(priv, -1);
+		priv->prog_page = -1;
+		sandbox_nand_set_out(priv, NULL, 0, 0);
+		break;
+	case NAND_CMD_READ0:
+	case NAND_CMD_RNDOUT:
+	case NAND_CMD_READID:
+	case NAND_CMD_PARAM:
+	case NAND_CMD_SEQIN:
+	case NAND_CMD_RNDIN:
+	case NAND_CMD_ERASE1:
+	case NAND_CMD_STATUS:
+		break;
+	default:
+		log_debug("Unsupported command %#x\n", cmd);
+		priv->stats.errors++;
+		break;
+	}
+
+	priv->cmd = cmd;
+	priv->addr_cycles = 0;
+	priv->addr_done = false;
+}
+
+static void sandbox_nand_cmd_ctrl(struct mtd_info *mtd, int dat,
+				  unsigned int ctrl)
+{
+	struct sandbox_nand_priv *priv = mtd_to_sandbox_nand(mtd);
+
+	if (dat == NAND_CMD_NONE) {
+		sandbox_nand_addr_done(priv);
+		return;
+	}
+
+	if (ctrl & NAND_CLE) {
+		sandbox_nand_command(priv, dat);
+	} else if (ctrl & NAND_ALE) {
+		if (priv->addr_cycles < sizeof(priv->addr))
+			priv->addr[priv->addr_cycles++] = dat;
+	}
+}
+
+static int sandbox_nand_dev_ready(struct mtd_info *mtd)
+{
+	return 1;
+}
+
+static uint8_t sandbox_nand_read_byte(struct mtd_info *mtd)
+{
+	struct sandbox_nand_priv *priv = mtd_to_sandbox_nand(mtd);
+
+	if (priv->read_status)
+		return priv->status;
+	if (!priv->out || priv->col >= priv->out_len)
+		return 0xff;
+
+	return priv->out[priv->col++];
+}
+
+static void sandbox_nand_read_buf(struct mtd_info *mtd, uint8_t *buf, int len)
+{
+	while (len--)
+		*buf++ = sandbox_nand_read_byte(mtd);
+}
+
+static void sandbox_nand_write_buf(struct mtd_info *mtd, const uint8_t *buf,
+				   int len)
+{
+	struct sandbox_nand_priv *priv = mtd_to_sandbox_nand(mtd);
+
+	for (; len && priv->col < SB_NAND_RAW_SIZE; len--)
+		priv->prog[priv->col++] = *buf++;
+}
+
+static void sandbox_nand_select_chip(struct mtd_info *mtd, int chipnr)
+{
+}
+
+static u16 sandbox_nand_onfi_crc16(const u8 *p, size_t len)
+{
+	u16 crc = ONFI_CRC_BASE;
+	int i;
+
+	while (len--) {
+		crc ^= *p++ << 8;
+		for (i = 0; i < 8; i++)
+			crc = (crc << 1) ^ ((crc & 0x8000) ? 0x8005 : 0);
+	}
+
+	return crc;
+}
+
+static void sandbox_nand_setup_param(struct sandbox_nand_priv *priv)
+{
+	struct nand_onfi_params *p = &priv->param[0];
+	u16 crc;
+	int i;
+
+	memcpy(p->sig, "ONFI", 4);
+	/* ONFI 2.3 */
+	p->revision = cpu_to_le16(1 << 5);
+	p->opt_cmd = cpu_to_le16(ONFI_OPT_CMD_READ_CACHE);
+	p->num_of_param_pages = SB_NAND_PARAM_COPIES;
+	memcpy(p->manufacturer, "SANDBOX     ", sizeof(p->manufacturer));
+	memcpy(p->model, "SANDBOX NAND        ", sizeof(p->model));
+	p->jedec_id = SB_NAND_MFR_ID;
+	p->byte_per_page = cpu_to_le32(SB_NAND_PAGE_SIZE);
+	p->spare_bytes_per_page = cpu_to_le16(SB_NAND_OOB_SIZE);
+	p->pages_per_block = cpu_to_le32(SB_NAND_PAGES_PER_BLOCK);
+	p->blocks_per_lun = cpu_to_le32(SB_NAND_BLOCKS);
+	p->lun_count = 1;
+	/* two column and two row address cycles */
+	p->addr_cycles = 0x22;
+	p->bits_per_cell = 1;
+	p->programs_per_page = 1;
+	p->ecc_bits = 1;
+	p->async_timing_mode = cpu_to_le16(1);
+	crc = sandbox_nand_onfi_crc16((u8 *)p, offsetof(typeof(*p), crc));
+	p->crc = cpu_to_le16(crc);
+
+	for (i = 1; i < SB_NAND_PARAM_COPIES; i++)
+		priv->param[i] = *p;
+}
+
+void sandbox_nand_get_stats(struct udevice *dev,
+			    struct sandbox_nand_stats *stats)
+{
+	struct sandbox_nand_priv *priv = dev_get_priv(dev);
+
+	*stats = priv->stats;
+}
+
+void sandbox_nand_reset_stats(struct udevice *dev)
+{
+	struct sandbox_nand_priv *priv = dev_get_priv(dev);
+
+	memset(&priv->stats, '\0', sizeof(priv->stats));
+}
+
+int sandbox_nand_flip_bit(struct udevice *dev, int page, int offset, int bit)
+{
+	struct sandbox_nand_priv *priv = dev_get_priv(dev);
+
+	if (page < 0 || page >= SB_NAND_PAGES || offset < 0 ||
+	    offset >= SB_NAND_RAW_SIZE || bit < 0 || bit > 7)
+		return -EINVAL;
+	sandbox_nand_page(priv, page)[offset] ^= 1 << bit;
+
+	return 0;
+}
+
+struct mtd_info *sandbox_nand_get_mtd(struct udevice *dev)
+{
+	struct sandbox_nand_priv *priv = dev_get_priv(dev);
+
+	return nand_to_mtd(&priv->chip);
+}
+
+static int sandbox_nand_probe(struct udevice *dev)
+{
+	struct sandbox_nand_priv *priv = dev_get_priv(dev);
+	struct nand_chip *chip = &priv->chip;
+	int ret;
+
+	priv->mem = malloc(SB_NAND_PAGES * SB_NAND_RAW_SIZE);
+	if (!priv->mem)
+		return -ENOMEM;
+	memset(priv->mem, 0xff, SB_NAND_PAGES * SB_NAND_RAW_SIZE);
+
+	priv->data_page = -1;
+	priv->prog_page = -1;
+	priv->status = NAND_STATUS_WP | NAND_STATUS_READY |
+		NAND_STATUS_TRUE_READY;
+	priv->id[0] = SB_NAND_MFR_ID;
+	priv->id[1] = SB_NAND_DEV_ID;
+	sandbox_nand_setup_param(priv);
+
+	nand_set_controller_data(chip, priv);
+	nand_set_flash_node(chip, dev_ofnode(dev));
+	chip->cmd_ctrl = sandbox_nand_cmd_ctrl;
+	chip->dev_ready = sandbox_nand_dev_ready;
+	chip->read_byte = sandbox_nand_read_byte;
+	chip->read_buf = sandbox_nand_read_buf;
+	chip->write_buf = sandbox_nand_write_buf;
+	chip->select_chip = sandbox_nand_select_chip;
+	chip->ecc.mode = NAND_ECC_SOFT;
+
+	ret = nand_scan(nand_to_mtd(chip), 1);
+	if (ret) {
+		free(priv->mem);
+		return log_msg_ret("scan", ret);
+	}
+
+	return 0;
+}
+
+static int sandbox_nand_remove(struct udevice *dev)
+{
+	struct sandbox_nand_priv *priv = dev_get_priv(dev);
+
+	kfree(priv->chip.buffers);
+	free(priv->mem);
+
+	return 0;
+}
+
+static const struct udevice_id sandbox_nand_ids[] = {
+	{ .compatible = "sandbox,nand" },
+	{ }
+};
+
+U_BOOT_DRIVER(sandbox_nand) = {
+	.name		= "sandbox_nand",
+	.id		= UCLASS_MTD,
+	.of_match	= sandbox_nand_ids,
+	.probe		= sandbox_nand_probe,
+	.remove		= sandbox_nand_remove,
+	.priv_auto	= sizeof(struct sandbox_nand_priv),
+};
+
+void board_nand_init(void)
+{
+	struct udevice *dev;
+	int ret;
+
+	ret = uclass_get_device_by_driver(UCLASS_MTD,
+					  DM_DRIVER_GET(sandbox_nand), &dev);
+	if (ret) {
+		if (ret != -ENODEV)
+			log_err("Failed to set up sandbox NAND (err=%d)\n",
+				ret);
+		return;
+	}
+
+	nand_register(0, sandbox_nand_get_mtd(dev));
+}
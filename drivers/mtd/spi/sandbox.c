@@ -94,6 +94,8 @@ struct sandbox_spi_flash {
 	const struct flash_info *data;
 	/* The file on disk to serv up data from */
 	int fd;
+	/* Read opcode which returns corrupted data, 0 if none */
+	uint bad_read_opcode;
 };
 
 struct sandbox_spi_flash_plat_data {
@@ -111,6 +113,13 @@ void sandbox_sf_set_block_protect(struct udevice *dev, int bp_mask)
 	sbsf->status |= bp_mask << STAT_BP_SHIFT;
 }
 
+void sandbox_sf_set_bad_read(struct udevice *dev, int opcode)
+{
+	struct sandbox_spi_flash *sbsf = dev_get_priv(dev);
+
+	sbsf->bad_read_opcode = opcode;
+}
+
 /**
  * This is a very strange probe function. If it has platform data (which may
  * have come from the device tree) then this function gets the filename and
@@ -247,6 +256,7 @@ static int sandbox_sf_process_cmd(struct sandbox_spi_flash *sbsf, const u8 *rx,
 		sbsf->cmd = SF_ID;
 		break;
 	case SPINOR_OP_READ_FAST:
+	case SPINOR_OP_READ_1_1_2:
 		sbsf->pad_addr_bytes = 1;
 	case SPINOR_OP_READ:
 	case SPINOR_OP_PP:
@@ -380,6 +390,7 @@ static int sandbox_sf_xfer(struct udevice *dev, unsigned int bitlen,
 			}
 			switch (sbsf->cmd) {
 			case SPINOR_OP_READ_FAST:
+			case SPINOR_OP_READ_1_1_2:
 			case SPINOR_OP_READ:
 				sbsf->state = SF_READ;
 				break;
@@ -408,6 +419,11 @@ static int sandbox_sf_xfer(struct udevice *dev, unsigned int bitlen,
 				puts("sandbox_sf: os_read() failed\n");
 				return -EIO;
 			}
+			/* emulate a stuck data line */
+			if (sbsf->cmd == sbsf->bad_read_opcode) {
+				for (cnt = 0; cnt < ret; cnt++)
+					tx[pos + cnt] |= 0x2;
+			}
 			pos += ret;
 			break;
 		case SF_READ_STATUS:
@@ -3909,6 +3909,156 @@ void spi_nor_set_fixups(struct spi_nor *nor)
 #endif /* SPI_FLASH_MACRONIX */
 }
 
+#ifdef CONFIG_SPI_FLASH_READ_TUNING
+/* Size of the window read back to verify a multi I/O read mode */
+#define SPI_NOR_TUNE_LEN	256
+
+static void spi_nor_tune_set_read(struct spi_nor *nor,
+				  const struct spi_nor_read_command *read,
+				  bool use_4b)
+{
+	nor->read_opcode = read->opcode;
+	if (use_4b)
+		nor->read_opcode = spi_nor_convert_3to4_read(read->opcode);
+	nor->read_proto = read->proto;
+	nor->read_dummy = read->num_mode_clocks + read->num_wait_states;
+}
+
+static bool spi_nor_tune_is_uniform(const u8 *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 1; i < len; i++)
+		if (buf[i] != buf[0])
+			return false;
+
+	return true;
+}
+
+/**
+ * spi_nor_tune_read() - verify the selected read mode on the actual board
+ * @nor:	pointer to a 'struct spi_nor'
+ * @params:	flash parameters the read settings were selected from
+ *
+ * The read mode is chosen from the capabilities advertised by the flash and
+ * the controller, which says nothing about whether the board can carry it at
+ * the configured frequency. Read a window at offset 0 with the single I/O
+ * Read command and compare it with the same window read in the selected
+ * mode. On mismatch step down through the slower shared read modes, and
+ * finally to 1-1-1, keeping the first one that returns the same data. The
+ * outcome stays in @nor, so the dirmap created afterwards uses it as well.
+ *
+ * Only 1-x-y SDR modes are verified: n-n-n and DTR modes need the flash to
+ * be switched over first. A window holding a single repeated byte, such as
+ * erased flash, cannot reveal lane errors and leaves the selection as is.
+ *
+ * Return: 0 on success, -errno otherwise.
+ */
+static int spi_nor_tune_read(struct spi_nor *nor,
+			     const struct spi_nor_flash_parameter *params)
+{
+	const struct spi_nor_read_command *read, *ref;
+	u8 opcode = nor->read_opcode, dummy = nor->read_dummy;
+	enum spi_nor_protocol proto = nor->read_proto;
+	u32 shared_mask, mask = 0;
+	bool use_4b = false;
+	int cmd, best, ret;
+	ssize_t len;
+	u8 *buf;
+
+	if (proto == SNOR_PROTO_1_1_1 || spi_nor_protocol_is_dtr(proto) ||
+	    spi_nor_get_protocol_inst_nbits(proto) != 1)
+		return 0;
+
+	spi_nor_adjust_hwcaps(nor, params, &shared_mask);
+	shared_mask &= SNOR_HWCAPS_READ_MASK &
+		       ~(SNOR_HWCAPS_X_X_X | SNOR_HWCAPS_DTR);
+
+	/* Find the selected mode; only the slower ones are candidates. */
+	read = NULL;
+	for (best = fls(shared_mask) - 1; best >= 0; best--) {
+		cmd = spi_nor_hwcaps_read2cmd(BIT(best));
+		if (cmd < 0 || params->reads[cmd].proto != proto)
+			continue;
+
+		read = &params->reads[cmd];
+		use_4b = opcode != read->opcode &&
+			 opcode == spi_nor_convert_3to4_read(read->opcode);
+		if (opcode == read->opcode || use_4b) {
+			mask = shared_mask & (BIT(best) - 1);
+			break;
+		}
+		read = NULL;
+	}
+
+	/* Set up by a manufacturer hook in a way we can't step down from */
+	if (!read)
+		return 0;
+
+	if (shared_mask & SNOR_HWCAPS_READ_FAST)
+		ref = &params->reads[SNOR_CMD_READ_FAST];
+	else
+		ref = &params->reads[SNOR_CMD_READ];
+
+	buf = kmalloc(2 * SPI_NOR_TUNE_LEN, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	spi_nor_tune_set_read(nor, ref, use_4b);
+	len = nor->read(nor, 0, SPI_NOR_TUNE_LEN, buf);
+	if (len < 0) {
+		ret = len;
+		goto restore;
+	}
+
+	if (spi_nor_tune_is_uniform(buf, SPI_NOR_TUNE_LEN)) {
+		dev_dbg(nor->dev, "no pattern to verify read mode against\n");
+		ret = 0;
+		goto restore;
+	}
+
+	while (read) {
+		spi_nor_tune_set_read(nor, read, use_4b);
+		len = nor->read(nor, 0, SPI_NOR_TUNE_LEN,
+				buf + SPI_NOR_TUNE_LEN);
+		if (len == SPI_NOR_TUNE_LEN &&
+		    !memcmp(buf, buf + SPI_NOR_TUNE_LEN, SPI_NOR_TUNE_LEN))
+			break;
+
+		dev_dbg(nor->dev, "read opcode 0x%02x failed verification\n",
+			nor->read_opcode);
+
+		read = NULL;
+		best = fls(mask) - 1;
+		if (best >= 0) {
+			mask &= ~BIT(best);
+			cmd = spi_nor_hwcaps_read2cmd(BIT(best));
+			if (cmd >= 0)
+				read = &params->reads[cmd];
+		}
+	}
+
+	/* Nothing faster works: stay with the reference read */
+	if (!read)
+		spi_nor_tune_set_read(nor, ref, use_4b);
+
+	if (nor->read_opcode != opcode)
+		dev_warn(nor->dev,
+			 "read opcode 0x%02x unreliable, using 0x%02x\n",
+			 opcode, nor->read_opcode);
+
+	kfree(buf);
+	return 0;
+
+restore:
+	nor->read_opcode = opcode;
+	nor->read_proto = proto;
+	nor->read_dummy = dummy;
+	kfree(buf);
+	return ret;
+}
+#endif /* CONFIG_SPI_FLASH_READ_TUNING */
+
 int spi_nor_scan(struct spi_nor *nor)
 {
 	struct spi_nor_flash_parameter params;
@@ -4080,6 +4230,12 @@ int spi_nor_scan(struct spi_nor *nor)
 	if (ret)
 		return ret;
 
+#ifdef CONFIG_SPI_FLASH_READ_TUNING
+	ret = spi_nor_tune_read(nor, &params);
+	if (ret)
+		return ret;
+#endif
+
 	nor->rdsr_dummy = params.rdsr_dummy;
 	nor->rdsr_addr_nbytes = params.rdsr_addr_nbytes;
 	nor->name = info->name;
@@ -79,6 +79,7 @@
 #include <u-boot/crc.h>
 #else
 #include <div64.h>
+#include <time.h>
 #include <linux/bug.h>
 #include <linux/err.h>
 #endif
@@ -822,6 +823,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	int err, bitflips = 0, vol_id = -1, ec_err = 0;
 
 	dbg_bld("scan PEB %d", pnum);
+	ubi->attach_stats.scanned_pebs++;
 
 	/* Skip bad physical eraseblocks */
 	err = ubi_io_is_bad(ubi, pnum);
@@ -1401,11 +1403,16 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 {
 	int err;
 	struct ubi_attach_info *ai;
+	struct ubi_attach_stats *stats = &ubi->attach_stats;
+	unsigned long start;
 
 	ai = alloc_ai();
 	if (!ai)
 		return -ENOMEM;
 
+	memset(stats, 0, sizeof(*stats));
+	start = timer_get_us();
+
 #ifdef CONFIG_MTD_UBI_FASTMAP
 	/* On small flash devices we disable fastmap in any case. */
 	if ((int)mtd_div_by_eb(ubi->mtd->size, ubi->mtd) <= UBI_FM_MAX_START) {
@@ -1436,6 +1443,9 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 	if (err)
 		goto out_ai;
 
+	stats->scan_us = timer_get_us() - start;
+	stats->fastmap = !!ubi->fm;
+
 	ubi->bad_peb_count = ai->bad_peb_count;
 	ubi->good_peb_count = ubi->peb_count - ubi->bad_peb_count;
 	ubi->corr_peb_count = ai->corr_peb_count;
@@ -1443,17 +1453,23 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 	ubi->mean_ec = ai->mean_ec;
 	dbg_gen("max. sequence number:       %llu", ai->max_sqnum);
 
+	start = timer_get_us();
 	err = ubi_read_volume_table(ubi, ai);
 	if (err)
 		goto out_ai;
+	stats->vtbl_us = timer_get_us() - start;
 
+	start = timer_get_us();
 	err = ubi_wl_init(ubi, ai);
 	if (err)
 		goto out_vtbl;
+	stats->wl_us = timer_get_us() - start;
 
+	start = timer_get_us();
 	err = ubi_eba_init(ubi, ai);
 	if (err)
 		goto out_wl;
+	stats->eba_us = timer_get_us() - start;
 
 #ifdef CONFIG_MTD_UBI_FASTMAP
 	if (ubi->fm && ubi_dbg_chk_fastmap(ubi)) {
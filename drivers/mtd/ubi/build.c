@@ -35,6 +35,7 @@
 #include <linux/log2.h>
 #endif
 #include <linux/err.h>
+#include <time.h>
 #include <ubi_uboot.h>
 #include <linux/mtd/partitions.h>
 
@@ -1060,6 +1061,17 @@ int ubi_attach_mtd_dev(struct mtd_info *mtd, int ubi_num,
 
 	spin_unlock(&ubi->wl_lock);
 
+#ifdef CONFIG_MTD_UBI_FASTMAP_WRITE_ON_ATTACH
+	if (!ubi->fm && !ubi->fm_disabled && !ubi->ro_mode) {
+		unsigned long start = timer_get_us();
+
+		err = ubi_update_fastmap(ubi);
+		if (err)
+			ubi_msg(ubi, "Unable to write a new fastmap: %i", err);
+		ubi->attach_stats.fm_write_us = timer_get_us() - start;
+	}
+#endif
+
 	ubi_devices[ubi_num] = ubi;
 	ubi_notify_all(ubi, UBI_VOLUME_ADDED, NULL);
 	return ubi_num;
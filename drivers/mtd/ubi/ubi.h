@@ -415,6 +415,26 @@ struct ubi_debug_info {
 	struct dentry *dfs_power_cut_max;
 };
 
+/**
+ * struct ubi_attach_stats - where the time went while attaching
+ * @scan_us: time spent scanning PEBs or loading the fastmap
+ * @vtbl_us: time spent reading the volume table
+ * @wl_us: time spent initializing the wear-leveling sub-system
+ * @eba_us: time spent building the EBA tables
+ * @fm_write_us: time spent writing a fresh fastmap after a full scan
+ * @scanned_pebs: number of PEBs whose EC and VID headers were read
+ * @fastmap: non-zero if the device was attached from a fastmap
+ */
+struct ubi_attach_stats {
+	unsigned long scan_us;
+	unsigned long vtbl_us;
+	unsigned long wl_us;
+	unsigned long eba_us;
+	unsigned long fm_write_us;
+	int scanned_pebs;
+	int fastmap;
+};
+
 /**
  * struct ubi_device - UBI device description structure
  * @dev: UBI device object to use the the Linux device model
@@ -528,6 +548,7 @@ struct ubi_debug_info {
  * @buf_mutex: protects @peb_buf
  * @ckvol_mutex: serializes static volume checking when opening
  *
+ * @attach_stats: time spent in each phase of attaching this device
  * @dbg: debugging information for this UBI device
  */
 struct ubi_device {
@@ -627,6 +648,7 @@ struct ubi_device {
 	struct mutex buf_mutex;
 	struct mutex ckvol_mutex;
 
+	struct ubi_attach_stats attach_stats;
 	struct ubi_debug_info dbg;
 };
 
@@ -326,6 +326,7 @@ static int sb_eth_start(struct udevice *dev)
 
 	debug("eth_sandbox: Start\n");
 
+	priv->started = true;
 	priv->recv_packets = 0;
 	for (int i = 0; i < PKTBUFSRX; i++) {
 		priv->recv_packet_buffer[i] = net_rx_packets[i];
@@ -389,7 +390,13 @@ static int sb_eth_free_pkt(struct udevice *dev, uchar *packet, int length)
 
 static void sb_eth_stop(struct udevice *dev)
 {
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+
 	debug("eth_sandbox: Stop\n");
+
+	/* a DSA port may stop its master after the master is removed */
+	if (priv)
+		priv->started = false;
 }
 
 static int sb_eth_write_hwaddr(struct udevice *dev)
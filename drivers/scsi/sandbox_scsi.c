@@ -50,7 +50,7 @@ static int sandbox_scsi_exec(struct udevice *dev, struct scsi_cmd *req)
 	} else if (ret == SCSI_EMUL_DO_READ && priv->fd != -1) {
 		long bytes_read;
 
-		log_debug("read %x %x\n", info->seek_block, info->read_len);
+		log_debug("read %llx %x\n", info->seek_block, info->read_len);
 		os_lseek(priv->fd, info->seek_block * info->block_size,
 			 OS_SEEK_SET);
 		bytes_read = os_read(priv->fd, req->pdata, info->buff_used);
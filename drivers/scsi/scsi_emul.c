@@ -16,6 +16,36 @@
 #include <log.h>
 #include <scsi.h>
 #include <scsi_emul.h>
+#include <asm/unaligned.h>
+
+/**
+ * emul_last_block() - Get the last block of the emulated device
+ *
+ * @info: Emulation information
+ * Return: last block number, or 0 if there is no backing file
+ */
+static u64 emul_last_block(struct scsi_emul_info *info)
+{
+	if (!info->file_size)
+		return 0;
+
+	return info->lba_base + info->file_size / info->block_size - 1;
+}
+
+/**
+ * emul_seek() - Work out the block in the backing file for a transfer
+ *
+ * @info: Emulation information
+ * @lba: Block number requested
+ * Return: block number within the backing file
+ */
+static u64 emul_seek(struct scsi_emul_info *info, u64 lba)
+{
+	if (info->lba_base && lba >= info->lba_base)
+		return lba - info->lba_base;
+
+	return lba;
+}
 
 int sb_scsi_emul_command(struct scsi_emul_info *info,
 			 const struct scsi_cmd *req, int len)
@@ -23,6 +53,7 @@ int sb_scsi_emul_command(struct scsi_emul_info *info,
 	int ret = 0;
 
 	info->buff_used = 0;
+	info->last_cmd = *req->cmd;
 	log_debug("emul %x\n", *req->cmd);
 	switch (*req->cmd) {
 	case SCSI_INQUIRY: {
@@ -42,21 +73,44 @@ int sb_scsi_emul_command(struct scsi_emul_info *info,
 		break;
 	case SCSI_RD_CAPAC: {
 		struct scsi_read_capacity_resp *resp = (void *)info->buff;
-		uint blocks;
 
-		if (info->file_size)
-			blocks = info->file_size / info->block_size - 1;
-		else
-			blocks = 0;
-		resp->last_block_addr = cpu_to_be32(blocks);
+		/* too large for 32 bits, so the host must use read capacity 16 */
+		resp->last_block_addr = cpu_to_be32(min(emul_last_block(info),
+							(u64)U32_MAX));
 		resp->block_len = cpu_to_be32(info->block_size);
 		info->buff_used = sizeof(*resp);
 		break;
 	}
+	case SCSI_RD_CAPAC16: {
+		if (req->cmd[1] != 0x10) {
+			ret = -EPROTONOSUPPORT;
+			break;
+		}
+		info->alloc_len = get_unaligned_be32(&req->cmd[10]);
+		memset(info->buff, '\0', 32);
+		put_unaligned_be64(emul_last_block(info), info->buff);
+		put_unaligned_be32(info->block_size, info->buff + 8);
+		info->buff_used = 32;
+		break;
+	}
+	case SCSI_READ16:
+		info->seek_block = emul_seek(info,
+					     get_unaligned_be64(&req->cmd[2]));
+		info->read_len = get_unaligned_be32(&req->cmd[10]);
+		info->buff_used = info->read_len * info->block_size;
+		ret = SCSI_EMUL_DO_READ;
+		break;
+	case SCSI_WRITE16:
+		info->seek_block = emul_seek(info,
+					     get_unaligned_be64(&req->cmd[2]));
+		info->write_len = get_unaligned_be32(&req->cmd[10]);
+		info->buff_used = info->write_len * info->block_size;
+		ret = SCSI_EMUL_DO_WRITE;
+		break;
 	case SCSI_READ10: {
 		const struct scsi_read10_req *read_req = (void *)req;
 
-		info->seek_block = be32_to_cpu(read_req->lba);
+		info->seek_block = emul_seek(info, be32_to_cpu(read_req->lba));
 		info->read_len = be16_to_cpu(read_req->xfer_len);
 		info->buff_used = info->read_len * info->block_size;
 		ret = SCSI_EMUL_DO_READ;
@@ -65,7 +119,7 @@ int sb_scsi_emul_command(struct scsi_emul_info *info,
 	case SCSI_WRITE10: {
 		const struct scsi_write10_req *write_req = (void *)req;
 
-		info->seek_block = be32_to_cpu(write_req->lba);
+		info->seek_block = emul_seek(info, be32_to_cpu(write_req->lba));
 		info->write_len = be16_to_cpu(write_req->xfer_len);
 		info->buff_used = info->write_len * info->block_size;
 		ret = SCSI_EMUL_DO_WRITE;
@@ -14,6 +14,7 @@
 #include <scsi.h>
 #include <scsi_emul.h>
 #include <usb.h>
+#include <asm/test.h>
 
 /*
  * This driver emulates a flash stick using the UFI command specification and
@@ -231,7 +232,7 @@ static int sandbox_flash_bulk(struct udevice *dev, struct usb_device *udev,
 			if ((cbw->bCBWFlags & CBWFLAGS_SBZ) ||
 			    cbw->bCBWLUN != 0)
 				goto err;
-			if (cbw->bCDBLength < 1 || cbw->bCDBLength >= 0x10)
+			if (cbw->bCDBLength < 1 || cbw->bCDBLength > 0x10)
 				goto err;
 			info->transfer_len = cbw->dCBWDataTransferLength;
 			priv->tag = cbw->dCBWTag;
@@ -353,10 +354,18 @@ static int sandbox_flash_probe(struct udevice *dev)
 	info->vendor = plat->flash_strings[STRINGID_MANUFACTURER -  1].s;
 	info->product = plat->flash_strings[STRINGID_PRODUCT - 1].s;
 	info->block_size = SANDBOX_FLASH_BLOCK_LEN;
+	info->lba_base = sandbox_flash_get_lba_base();
 
 	return 0;
 }
 
+int sandbox_flash_get_last_cmd(struct udevice *dev)
+{
+	struct sandbox_flash_priv *priv = dev_get_priv(dev);
+
+	return priv->eminfo.last_cmd;
+}
+
 static int sandbox_flash_remove(struct udevice *dev)
 {
 	struct sandbox_flash_priv *priv = dev_get_priv(dev);
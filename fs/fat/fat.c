@@ -305,26 +305,44 @@ get_cluster(fsdata *mydata, __u32 clustnum, __u8 *buffer, unsigned long size)
 }
 
 /**
- * get_contents() - read from file
+ * struct fat_file - a file opened with fat_file_open()
  *
- * Read at most 'maxsize' bytes from 'pos' in the file associated with 'dentptr'
- * into 'buffer'. Update the number of bytes read in *gotsize or return -1 on
- * fatal errors.
+ * @start:	first cluster of the file
+ * @size:	file size in bytes
+ * @clust:	cluster last seeked to, 0 if none
+ * @clust_pos:	position in the file of the start of @clust
+ */
+struct fat_file {
+	__u32 start;
+	loff_t size;
+	__u32 clust;
+	loff_t clust_pos;
+};
+
+/**
+ * get_contents_at() - read from file, starting from a known cluster
+ *
+ * Read at most 'maxsize' bytes from 'pos' in 'file' into 'buffer'. The cluster
+ * chain is followed from file->clust if that is not past 'pos', otherwise
+ * from the start of the file. The cluster containing 'pos' is recorded in
+ * 'file' so that a later read from there on does not walk the chain from the
+ * start of the file. Update the number of bytes read in *gotsize or return -1
+ * on fatal errors.
  *
  * @mydata:	file system description
- * @dentprt:	directory entry pointer
+ * @file:	file to read
  * @pos:	position from where to read
  * @buffer:	buffer into which to read
  * @maxsize:	maximum number of bytes to read
  * @gotsize:	number of bytes actually read
  * Return:	-1 on error, otherwise 0
  */
-static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
-			__u8 *buffer, loff_t maxsize, loff_t *gotsize)
+static int get_contents_at(fsdata *mydata, struct fat_file *file, loff_t pos,
+			   __u8 *buffer, loff_t maxsize, loff_t *gotsize)
 {
-	loff_t filesize = FAT2CPU32(dentptr->size);
+	loff_t filesize = file->size;
 	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
-	__u32 curclust = START(dentptr);
+	__u32 curclust = file->start;
 	__u32 endclust, newclust;
 	loff_t actsize;
 
@@ -342,6 +360,10 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 	debug("%llu bytes\n", filesize);
 
 	actsize = bytesperclust;
+	if (file->clust && file->clust_pos <= pos) {
+		curclust = file->clust;
+		actsize += file->clust_pos;
+	}
 
 	/* go to cluster at pos */
 	while (actsize <= pos) {
@@ -353,6 +375,8 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 		}
 		actsize += bytesperclust;
 	}
+	file->clust = curclust;
+	file->clust_pos = actsize - bytesperclust;
 
 	/* actsize > pos */
 	actsize -= bytesperclust;
@@ -438,6 +462,32 @@ getit:
 	} while (1);
 }
 
+/**
+ * get_contents() - read from file
+ *
+ * Read at most 'maxsize' bytes from 'pos' in the file associated with 'dentptr'
+ * into 'buffer'. Update the number of bytes read in *gotsize or return -1 on
+ * fatal errors.
+ *
+ * @mydata:	file system description
+ * @dentprt:	directory entry pointer
+ * @pos:	position from where to read
+ * @buffer:	buffer into which to read
+ * @maxsize:	maximum number of bytes to read
+ * @gotsize:	number of bytes actually read
+ * Return:	-1 on error, otherwise 0
+ */
+static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
+			__u8 *buffer, loff_t maxsize, loff_t *gotsize)
+{
+	struct fat_file file = {
+		.start = START(dentptr),
+		.size = FAT2CPU32(dentptr->size),
+	};
+
+	return get_contents_at(mydata, &file, pos, buffer, maxsize, gotsize);
+}
+
 /*
  * Extract the file name information from 'slotptr' into 'l_name',
  * starting at l_name[*idx].
@@ -1275,6 +1325,58 @@ out_free_itr:
 	return ret;
 }
 
+int fat_file_open(const char *filename, void **privp)
+{
+	struct fat_file *file;
+	fsdata fsdata, *mydata = &fsdata;
+	fat_itr *itr;
+	int ret;
+
+	itr = malloc_cache_aligned(sizeof(fat_itr));
+	if (!itr)
+		return -ENOMEM;
+	ret = fat_itr_root(itr, &fsdata);
+	if (ret)
+		goto out_free_itr;
+
+	ret = fat_itr_resolve(itr, filename, TYPE_FILE);
+	if (ret)
+		goto out_free_both;
+
+	file = calloc(1, sizeof(*file));
+	if (!file) {
+		ret = -ENOMEM;
+		goto out_free_both;
+	}
+	file->start = START(itr->dent);
+	file->size = FAT2CPU32(itr->dent->size);
+	*privp = file;
+
+out_free_both:
+	free(fsdata.fatbuf);
+out_free_itr:
+	free(itr);
+	return ret;
+}
+
+int fat_file_read(void *priv, void *buf, loff_t offset, loff_t len,
+		  loff_t *actread)
+{
+	struct fat_file *file = priv;
+	fsdata fsdata;
+	int ret;
+
+	ret = get_fs_info(&fsdata);
+	if (ret)
+		return ret;
+
+	debug("reading at pos %llu from cluster %x\n", offset, file->clust);
+	ret = get_contents_at(&fsdata, file, offset, buf, len, actread);
+	free(fsdata.fatbuf);
+
+	return ret;
+}
+
 int file_fat_read(const char *filename, void *buffer, int maxsize)
 {
 	loff_t actread;
@@ -13,6 +13,7 @@
 #include <env.h>
 #include <lmb.h>
 #include <log.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <part.h>
 #include <ext4fs.h>
@@ -36,6 +37,8 @@ static struct blk_desc *fs_dev_desc;
 static int fs_dev_part;
 static struct disk_partition fs_partition;
 static int fs_type = FS_TYPE_ANY;
+/* bumped on every change to any filesystem, so open files are looked up again */
+static uint fs_gen;
 
 void fs_set_type(int type)
 {
@@ -180,6 +183,14 @@ struct fstype_info {
 	int (*unlink)(const char *filename);
 	int (*mkdir)(const char *dirname);
 	int (*ln)(const char *filename, const char *target);
+	/*
+	 * Optional: look up a file for fs_file_open(), returning any state
+	 * needed to read it via 'privp'. The state is freed with free().
+	 */
+	int (*file_open)(const char *filename, void **privp);
+	/* Optional: read from a file opened with .file_open() */
+	int (*file_read)(void *priv, void *buf, loff_t offset, loff_t len,
+			 loff_t *actread);
 };
 
 static struct fstype_info fstypes[] = {
@@ -194,6 +205,8 @@ static struct fstype_info fstypes[] = {
 		.exists = fat_exists,
 		.size = fat_size,
 		.read = fat_read_file,
+		.file_open = fat_file_open,
+		.file_read = fat_file_read,
 #if CONFIG_IS_ENABLED(FAT_WRITE)
 		.write = file_fat_write,
 		.unlink = fat_unlink,
@@ -567,7 +580,9 @@ static int fs_read_lmb_check(const char *filename, ulong addr, loff_t offset,
 	lmb_init_and_reserve(&lmb, gd->bd, (void *)gd->fdt_blob);
 	lmb_dump_all(&lmb);
 
-	if (lmb_alloc_addr(&lmb, addr, read_len) == addr)
+	ret = lmb_alloc_addr(&lmb, addr, read_len) == addr;
+	lmb_uninit(&lmb);
+	if (ret)
 		return 0;
 
 	log_err("** Reading file would overwrite reserved memory **\n");
@@ -622,6 +637,7 @@ int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	buf = map_sysmem(addr, len);
 	ret = info->write(filename, buf, offset, len, actwrite);
 	unmap_sysmem(buf);
+	fs_gen++;
 
 	if (ret < 0 && len != *actwrite) {
 		log_err("** Unable to write file %s **\n", filename);
@@ -632,6 +648,127 @@ int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	return ret;
 }
 
+/**
+ * fs_file_lookup() - look up an open file on the current filesystem
+ *
+ * @file:	file to look up
+ * Return:	0 if OK, -ve on error
+ */
+static int fs_file_lookup(struct fs_file *file)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	int ret;
+
+	free(file->priv);
+	file->priv = NULL;
+	file->gen = fs_gen;
+
+	ret = info->size(file->name, &file->size);
+	if (ret)
+		return ret < 0 ? ret : -ENOENT;
+	if (info->file_open)
+		return info->file_open(file->name, &file->priv);
+
+	return 0;
+}
+
+/**
+ * fs_file_select() - select the device, partition and filesystem of a file
+ *
+ * Unlike fs_set_blk_dev_with_part() this uses the partition information and
+ * filesystem type recorded when the file was opened, so the partition table
+ * is not read and only the one filesystem is probed.
+ *
+ * @file:	file to select
+ * Return:	0 if OK, -ve on error
+ */
+static int fs_file_select(struct fs_file *file)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+
+	if (!file->desc && !info->null_dev_desc_ok)
+		return -ENODEV;
+
+	fs_dev_desc = file->desc;
+	fs_partition = file->partition;
+	if (info->probe(fs_dev_desc, &fs_partition))
+		return -EIO;
+	fs_type = file->fstype;
+	fs_dev_part = file->part;
+
+	return 0;
+}
+
+int fs_file_open(const char *filename, struct fs_file **filep)
+{
+	struct fs_file *file;
+	int ret;
+
+	file = calloc(1, sizeof(*file) + strlen(filename) + 1);
+	if (!file) {
+		fs_close();
+		return -ENOMEM;
+	}
+	strcpy(file->name, filename);
+	file->desc = fs_dev_desc;
+	file->part = fs_dev_part;
+	file->fstype = fs_type;
+	file->partition = fs_partition;
+
+	ret = fs_file_lookup(file);
+	fs_close();
+	if (ret) {
+		fs_file_close(file);
+		return ret;
+	}
+	*filep = file;
+
+	return 0;
+}
+
+int fs_file_read(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+		 loff_t *actread)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+	int ret;
+
+	ret = fs_file_select(file);
+	if (ret)
+		return ret;
+
+	if (file->gen != fs_gen) {
+		ret = fs_file_lookup(file);
+		if (ret)
+			goto out;
+	}
+
+	*actread = 0;
+	if (offset > file->size) {
+		ret = -EINVAL;
+		goto out;
+	}
+	if (!len || len > file->size - offset)
+		len = file->size - offset;
+
+	if (info->file_read)
+		ret = info->file_read(file->priv, buf, offset, len, actread);
+	else
+		ret = info->read(file->name, buf, offset, len, actread);
+out:
+	fs_close();
+
+	return ret;
+}
+
+void fs_file_close(struct fs_file *file)
+{
+	if (!file)
+		return;
+
+	free(file->priv);
+	free(file);
+}
+
 struct fs_dir_stream *fs_opendir(const char *filename)
 {
 	struct fstype_info *info = fs_get_info(fs_type);
@@ -691,6 +828,7 @@ int fs_unlink(const char *filename)
 	struct fstype_info *info = fs_get_info(fs_type);
 
 	ret = info->unlink(filename);
+	fs_gen++;
 
 	fs_close();
 
@@ -704,6 +842,7 @@ int fs_mkdir(const char *dirname)
 	struct fstype_info *info = fs_get_info(fs_type);
 
 	ret = info->mkdir(dirname);
+	fs_gen++;
 
 	fs_close();
 
@@ -716,6 +855,7 @@ int fs_ln(const char *fname, const char *target)
 	int ret;
 
 	ret = info->ln(fname, target);
+	fs_gen++;
 
 	if (ret < 0) {
 		log_err("** Unable to create link %s -> %s **\n", fname, target);
@@ -110,10 +110,13 @@ struct bootdev_hunter {
  *
  * @bootflows: List of available bootflows for this bootdev
  * @piro: Priority of this bootdev
+ * @old: true if this bootdev was there before the last hunter was run by
+ *	bootdev_next_prio()
  */
 struct bootdev_uc_plat {
 	struct list_head bootflow_head;
 	enum bootdev_prio_t prio;
+	bool old;
 };
 
 /** struct bootdev_ops - Operations for the bootdev uclass */
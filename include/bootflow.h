@@ -100,6 +100,8 @@ struct bootflow {
  * before using it
  * @BOOTFLOWF_ALL: Return bootflows with errors as well
  * @BOOTFLOWF_HUNT: Hunt for new bootdevs using the bootdrv hunters
+ * @BOOTFLOWF_CACHE: Try the bootflow in the bootflow cache before scanning
+ *	(see CONFIG_BOOTSTD_CACHE)
  *
  * Internal flags:
  * @BOOTFLOWF_SINGLE_DEV: (internal) Just scan one bootdev
@@ -108,12 +110,15 @@ struct bootflow {
  * this uclass (used with things like "mmc")
  * @BOOTFLOWF_SINGLE_MEDIA: (internal) Scan one media device in the uclass (used
  * with things like "mmc1")
+ * @BOOTFLOWF_CACHED: (internal) The bootflow from the cache was returned and
+ * scanning has not started yet
  */
 enum bootflow_flags_t {
 	BOOTFLOWF_FIXED		= 1 << 0,
 	BOOTFLOWF_SHOW		= 1 << 1,
 	BOOTFLOWF_ALL		= 1 << 2,
 	BOOTFLOWF_HUNT		= 1 << 3,
+	BOOTFLOWF_CACHE		= 1 << 4,
 
 	/*
 	 * flags used internally by standard boot - do not set these when
@@ -123,6 +128,7 @@ enum bootflow_flags_t {
 	BOOTFLOWF_SKIP_GLOBAL	= 1 << 17,
 	BOOTFLOWF_SINGLE_UCLASS	= 1 << 18,
 	BOOTFLOWF_SINGLE_MEDIA	= 1 << 19,
+	BOOTFLOWF_CACHED	= 1 << 20,
 };
 
 /**
@@ -186,12 +192,18 @@ enum bootflow_meth_flags_t {
  * @cur_method: Current method number, an index into @method_order
  * @first_glob_method: First global method, if any, else -1
  * @cur_prio: Current priority being scanned
+ * @cur_hunter: Position in the hunter linker list at which to look for the
+ *	next hunter of priority @cur_prio to run
  * @method_order: List of bootmeth devices to use, in order. The normal methods
  *	appear first, then the global ones, if any
  * @doing_global: true if we are iterating through the global bootmeths (which
  *	happens before the normal ones)
  * @method_flags: flags controlling which methods should be used for this @dev
  * (enum bootflow_meth_flags_t)
+ * @cache_dev: Bootdev of the bootflow returned from the bootflow cache, NULL if
+ *	none. The scan skips this bootflow, since it has already been returned
+ * @cache_part: Partition of the bootflow returned from the bootflow cache
+ * @cache_method: Bootmeth of the bootflow returned from the bootflow cache
  */
 struct bootflow_iter {
 	int flags;
@@ -210,9 +222,13 @@ struct bootflow_iter {
 	int cur_method;
 	int first_glob_method;
 	enum bootdev_prio_t cur_prio;
+	int cur_hunter;
 	struct udevice **method_order;
 	bool doing_global;
 	int method_flags;
+	struct udevice *cache_dev;
+	int cache_part;
+	struct udevice *cache_method;
 };
 
 /**
@@ -341,6 +357,41 @@ int bootflow_boot(struct bootflow *bflow);
  */
 int bootflow_run_boot(struct bootflow_iter *iter, struct bootflow *bflow);
 
+/* Environment variable holding the bootflow cache */
+#define BOOTFLOW_CACHE_VAR	"bootflow_cache"
+
+/**
+ * bootflow_cache_save() - Record a bootflow in the bootflow cache
+ *
+ * This records the bootdev, partition, bootmeth and filename of the bootflow,
+ * along with the size and CRC32 of the bootflow file and a CRC32 of the
+ * current bootdev order, in the environment. The
+ * environment is only changed (and saved, if CONFIG_BOOTSTD_CACHE_SAVE is
+ * enabled) if the record differs from the one already there.
+ *
+ * @bflow: Bootflow which is about to be booted
+ * Return: 0 if OK, -EINVAL if the bootflow cannot be cached (e.g. it uses a
+ *	global bootmeth), other -ve on error
+ */
+int bootflow_cache_save(const struct bootflow *bflow);
+
+/**
+ * bootflow_cache_check() - Obtain the bootflow in the bootflow cache
+ *
+ * This reads the bootflow recorded in the cache, without any scanning or
+ * hunting, and checks that its bootflow file and the bootdev order are
+ * unchanged. On success the bootflow is recorded in @iter so that the scan can
+ * skip it later, and @iter is set to its bootmeth, so that this can be dropped
+ * if it fails to boot.
+ *
+ * @iter: Iterator, already set up with bootflow_iter_init() and
+ *	bootmeth_setup_iter_order()
+ * @bflow: Returns the bootflow, in state BOOTFLOWST_READY
+ * Return: 0 if OK, -ENOENT if there is no cache or its bootdev or bootmeth is
+ *	not available, -ESTALE if the bootflow has changed, other -ve on error
+ */
+int bootflow_cache_check(struct bootflow_iter *iter, struct bootflow *bflow);
+
 /**
  * bootflow_state_get_name() - Get the name of a bootflow state
  *
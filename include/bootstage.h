@@ -364,6 +364,28 @@ int bootstage_stash(void *base, int size);
  */
 int bootstage_unstash(const void *base, int size);
 
+/**
+ * bootstage_stash_default() - Stash bootstage data for the next phase
+ *
+ * The data is written to the bloblist if CONFIG_BOOTSTAGE_STASH_BLOBLIST is
+ * enabled and this phase has a bloblist, otherwise it is written to
+ * CONFIG_BOOTSTAGE_STASH_ADDR
+ *
+ * Return: 0 if OK, -ENOSPC if there is not enough space, other -ve on error
+ */
+int bootstage_stash_default(void);
+
+/**
+ * bootstage_unstash_default() - Read bootstage data from the previous phase
+ *
+ * This looks in the bloblist first, if CONFIG_BOOTSTAGE_STASH_BLOBLIST is
+ * enabled and this phase has a bloblist, then at CONFIG_BOOTSTAGE_STASH_ADDR
+ *
+ * Return: 0 if OK, -ENOENT if no bootstage data was found, other -ve on error
+ *	(see bootstage_unstash())
+ */
+int bootstage_unstash_default(void);
+
 /**
  * bootstage_get_size() - Get the size of the bootstage data
  *
@@ -440,6 +462,16 @@ static inline int bootstage_unstash(const void *base, int size)
 	return 0;	/* Pretend to succeed */
 }
 
+static inline int bootstage_stash_default(void)
+{
+	return 0;	/* Pretend to succeed */
+}
+
+static inline int bootstage_unstash_default(void)
+{
+	return 0;	/* Pretend to succeed */
+}
+
 static inline int bootstage_get_size(void)
 {
 	return 0;
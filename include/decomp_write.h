@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Decompress an image from memory while writing it to a block device
+ */
+
+#ifndef __DECOMP_WRITE_H
+#define __DECOMP_WRITE_H
+
+#include <linux/types.h>
+
+struct blk_desc;
+
+/**
+ * decomp_write() - decompress an image from memory and write it to a device
+ *
+ * The image is decompressed into a write buffer of @szwritebuf bytes, which
+ * is written to @dev each time it fills up, so the decompressed image never
+ * needs to fit in memory. Progress is reported through the gzwrite_progress
+ * functions (see gzip.h).
+ *
+ * For gzip the uncompressed size and CRC in the trailer are checked. For
+ * the other formats the integrity checks of the format itself are used.
+ *
+ * @comp:	compression type (IH_COMP_GZIP, IH_COMP_ZSTD, IH_COMP_LZ4 or
+ *		IH_COMP_LZMA)
+ * @src:	compressed image address
+ * @len:	compressed image length in bytes
+ * @dev:	block device descriptor
+ * @szwritebuf:	bytes per write (pad to erase size)
+ * @startoffs:	offset in bytes of first write
+ * @szexpected:	expected uncompressed length, or zero if not known (gzip
+ *		then uses the trailer, for files under 4GiB)
+ * Return: 0 if OK, -EPROTONOSUPPORT if @comp is not supported, -EINVAL if
+ *	the arguments or data are invalid or the output does not match
+ *	@szexpected, -EFBIG or -ENOSPC if the output does not fit on @dev,
+ *	-EIO on write error, -EINTR if interrupted, -ENOMEM if out of memory
+ */
+int decomp_write(int comp, void *src, ulong len, struct blk_desc *dev,
+		 ulong szwritebuf, u64 startoffs, u64 szexpected);
+
+#endif
@@ -18,6 +18,7 @@
 #include <pe.h>
 #include <linux/list.h>
 #include <linux/oid_registry.h>
+#include <linux/sizes.h>
 
 struct blk_desc;
 struct jmp_buf_data;
@@ -269,6 +270,7 @@ extern const efi_guid_t efi_guid_host_dev;
 #endif
 /* GUID of the EFI_BLOCK_IO_PROTOCOL */
 extern const efi_guid_t efi_block_io_guid;
+extern const efi_guid_t efi_block_io2_guid;
 extern const efi_guid_t efi_global_variable_guid;
 extern const efi_guid_t efi_guid_console_control;
 extern const efi_guid_t efi_guid_device_path;
@@ -600,6 +602,67 @@ efi_status_t efi_set_watchdog(unsigned long timeout);
 
 /* Called from places to check whether a timer expired */
 void efi_timer_check(void);
+
+/**
+ * struct efi_io_request - asynchronous I/O request
+ *
+ * U-Boot has no interrupts or threads, so asynchronous I/O is carried out
+ * in steps, one step each time efi_timer_check() is called, e.g. while an
+ * application polls its events with CheckEvent().
+ *
+ * A request is embedded at the start of a structure allocated with malloc(),
+ * which holds the state of the transfer. It is freed when the request
+ * completes.
+ *
+ * @link:	entry in the queue of requests
+ * @owner:	object the request is for, used to complete or cancel all
+ *		requests for an object
+ * @step:	performs the next part of the request; returns EFI_NOT_READY
+ *		if there is more to do, otherwise the final status
+ * @event:	event to signal on completion, NULL to complete the request
+ *		before efi_io_submit() returns
+ * @status:	receives the final status, may be NULL
+ */
+struct efi_io_request {
+	struct list_head link;
+	void *owner;
+	efi_status_t (*step)(struct efi_io_request *req);
+	struct efi_event *event;
+	efi_status_t *status;
+};
+
+/* Size of the transfer done in each step of an asynchronous request */
+#define EFI_IO_STEP_SIZE	SZ_64K
+
+/**
+ * efi_io_submit() - submit an I/O request
+ *
+ * If the request has no event it is carried out straight away, after any
+ * queued requests for the same owner. Otherwise it is queued.
+ *
+ * @req:	request to submit
+ * Return:	status of the request if it has no event, else EFI_SUCCESS
+ */
+efi_status_t efi_io_submit(struct efi_io_request *req);
+
+/* Do the next step of the first queued I/O request, if any */
+void efi_io_poll(void);
+
+/**
+ * efi_io_flush() - complete queued I/O requests
+ *
+ * @owner:	object whose requests should be completed, NULL for all
+ */
+void efi_io_flush(void *owner);
+
+/**
+ * efi_io_cancel() - abort queued I/O requests
+ *
+ * The requests are completed with status EFI_ABORTED.
+ *
+ * @owner:	object whose requests should be aborted, NULL for all
+ */
+void efi_io_cancel(void *owner);
 /* Check if a buffer contains a PE-COFF image */
 efi_status_t efi_check_pe(void *buffer, size_t size, void **nt_header);
 /* PE loader implementation */
@@ -208,6 +208,34 @@ int file_fat_write(const char *filename, void *buf, loff_t offset, loff_t len,
 		   loff_t *actwrite);
 int fat_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 		  loff_t *actread);
+
+/**
+ * fat_file_open() - look up a file for reading with fat_file_read()
+ *
+ * @filename:	full path of the file
+ * @privp:	returns the state needed to read the file, to be freed with
+ *		free()
+ * Return:	0 if OK, -ve on error
+ */
+int fat_file_open(const char *filename, void **privp);
+
+/**
+ * fat_file_read() - read from a file opened with fat_file_open()
+ *
+ * The cluster containing @offset is remembered, so reading through the file
+ * in order does not walk the cluster chain from the start each time. Each
+ * link is still followed about twice: once while reading, then again when
+ * the next read seeks forward from the remembered cluster.
+ *
+ * @priv:	state returned by fat_file_open()
+ * @buf:	buffer to read into
+ * @offset:	offset in the file from where to start reading
+ * @len:	maximum number of bytes to read
+ * @actread:	returns the number of bytes read
+ * Return:	0 if OK, -ve on error
+ */
+int fat_file_read(void *priv, void *buf, loff_t offset, loff_t len,
+		  loff_t *actread);
 int fat_opendir(const char *filename, struct fs_dir_stream **dirsp);
 int fat_readdir(struct fs_dir_stream *dirs, struct fs_dirent **dentp);
 void fat_closedir(struct fs_dir_stream *dirs);
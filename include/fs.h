@@ -6,6 +6,7 @@
 #define _FS_H
 
 #include <common.h>
+#include <part.h>
 #include <rtc.h>
 
 struct cmd_tbl;
@@ -166,6 +167,70 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	     loff_t *actwrite);
 
+/**
+ * struct fs_file - an open file
+ *
+ * This is returned by fs_file_open() and remembers where the file is, so that
+ * it can be read repeatedly without looking up the partition, probing for
+ * the filesystem or resolving the path each time. Filesystems which support
+ * it keep their own cursor in @priv, e.g. FAT remembers the cluster where
+ * the last read started, so that reading through a file in chunks does not
+ * walk the cluster chain from the start for every chunk.
+ *
+ * Note: fs_file should be treated as opaque to the user of fs layer, except
+ * for @size
+ */
+struct fs_file {
+	/** @size: file size in bytes */
+	loff_t size;
+	/* private to fs. layer: */
+	struct blk_desc *desc;
+	int part;
+	int fstype;
+	struct disk_partition partition;
+	uint gen;
+	void *priv;
+	char name[];
+};
+
+/**
+ * fs_file_open() - open a file on the partition previously set by
+ *		    fs_set_blk_dev()
+ *
+ * Like the other file functions, this calls fs_close() before returning, so
+ * the file can be read without another call to fs_set_blk_dev().
+ *
+ * @filename:	full path of the file to open
+ * @filep:	returns the open file, to be freed with fs_file_close()
+ * Return:	0 if OK, -ENOMEM if out of memory, other -ve on error
+ */
+int fs_file_open(const char *filename, struct fs_file **filep);
+
+/**
+ * fs_file_read() - read from a file opened with fs_file_open()
+ *
+ * This selects the device and partition of the file itself, so there is no
+ * need to call fs_set_blk_dev() first. If any file on any filesystem has been
+ * written since the file was opened, it is looked up again.
+ *
+ * @file:	file to read from
+ * @buf:	buffer to write to
+ * @offset:	offset in the file from where to start reading
+ * @len:	the number of bytes to read. Use 0 to read up to the end of file.
+ * @actread:	returns the actual number of bytes read
+ * Return:	0 if OK with valid *actread, -EINVAL if @offset is past the end
+ *		of the file, other -ve on error
+ */
+int fs_file_read(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+		 loff_t *actread);
+
+/**
+ * fs_file_close() - close a file opened with fs_file_open()
+ *
+ * @file:	file to close, may be NULL
+ */
+void fs_file_close(struct fs_file *file);
+
 /*
  * Directory entry types, matches the subset of DT_x in posix readdir()
  * which apply to u-boot.
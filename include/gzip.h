@@ -31,6 +31,26 @@ int gzip_parse_header(const unsigned char *src, unsigned long len);
  */
 int gunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp);
 
+/**
+ * gunzip_cb() - Decompress gzipped data, reporting the input as it is consumed
+ *
+ * This is gunzip() with a callback which is handed consecutive pieces of
+ * @src, in order, each one just before inflate() gets to see it. The gzip
+ * trailer after the deflate stream is not passed to @in_fn.
+ *
+ * @dst: Destination for uncompressed data
+ * @dstlen: Size of destination buffer
+ * @src: Source data to decompress
+ * @lenp: On entry, length of data at @src. Returns length of uncompressed
+ *	data
+ * @in_fn: Function to call with each piece of input
+ * @priv: Private data passed to @in_fn
+ * Return: 0 if OK, -1 on error
+ */
+int gunzip_cb(void *dst, int dstlen, unsigned char *src, unsigned long *lenp,
+	      void (*in_fn)(void *priv, const void *buf, size_t len),
+	      void *priv);
+
 /**
  * zunzip() - Uncompress blocks compressed with zlib without headers
  *
@@ -53,6 +73,9 @@ int zunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp,
  *	gzwrite_progress called during decompress/write loop
  *	gzwrite_progress_finish called at end of loop to
  *		indicate success (retcode=0) or failure
+ *
+ * These are also used by decomp_write() for the other formats, which pass
+ * zero for both CRCs.
  */
 void gzwrite_progress_init(ulong expected_size);
 
@@ -943,6 +943,39 @@ int image_decomp(int comp, ulong load, ulong image_start, int type,
 		 void *load_buf, void *image_buf, ulong image_len,
 		 uint unc_len, ulong *load_end);
 
+struct hash_algo;
+
+/**
+ * image_decomp_hash() - decompress an image, hashing the compressed data
+ *
+ * This is image_decomp() which also feeds the whole of @image_buf through
+ * @algo. For gzip, lzma, lz4 and zstd each piece of compressed data is
+ * hashed just before the decompressor consumes it, so it is only brought
+ * into the cache once. Other formats are hashed in full first.
+ *
+ * The caller sets up @hash_ctx with @algo->hash_init() and collects the
+ * result with @algo->hash_finish(). Note that the data is decompressed
+ * before the caller gets to compare the hash. If @algo->hash_update() fails,
+ * decompression still runs to completion but its error is returned.
+ *
+ * @comp:	Compression algorithm that is used (IH_COMP_...)
+ * @load:	Destination load address in U-Boot memory
+ * @image_start Image start address (where we are decompressing from)
+ * @type:	OS type (IH_OS_...)
+ * @load_buf:	Place to decompress to
+ * @image_buf:	Address to decompress from
+ * @image_len:	Number of bytes in @image_buf to decompress
+ * @unc_len:	Available space for decompression
+ * @load_end:	Returns the end of the decompressed data
+ * @algo:	Hash algorithm to use, or NULL to behave as image_decomp()
+ * @hash_ctx:	Progressive hash context for @algo
+ * Return: 0 if OK, -ve on error (BOOTM_ERR_...)
+ */
+int image_decomp_hash(int comp, ulong load, ulong image_start, int type,
+		      void *load_buf, void *image_buf, ulong image_len,
+		      uint unc_len, ulong *load_end, struct hash_algo *algo,
+		      void *hash_ctx);
+
 /**
  * Set up properties in the FDT
  *
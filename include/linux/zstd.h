@@ -444,15 +444,153 @@ typedef ZSTD_frameHeader zstd_frame_header;
 size_t zstd_get_frame_header(zstd_frame_header *params, const void *src,
 	size_t src_size);
 
+/**
+ * zstd_is_skippable_frame() - tells if a buffer starts with a skippable frame
+ * @src:      The source buffer.
+ * @src_size: The size of the source buffer.
+ *
+ * Return:    1 if @src starts with a skippable frame, 0 otherwise.
+ */
+unsigned int zstd_is_skippable_frame(const void *src, size_t src_size);
+
+/* ======   Dictionaries   ====== */
+
+typedef ZSTD_DDict zstd_ddict;
+
+/**
+ * zstd_ddict_workspace_bound() - memory needed to initialize a zstd_ddict
+ * @dict_size: The size of the dictionary.
+ *
+ * Return:     A lower bound on the size of the workspace that is passed to
+ *             zstd_init_ddict().
+ */
+size_t zstd_ddict_workspace_bound(size_t dict_size);
+
+/**
+ * zstd_init_ddict() - initialize a digested decompression dictionary
+ * @dict:           The dictionary. It is referenced, not copied, so it must
+ *                  outlive the returned dictionary.
+ * @dict_size:      The size of the dictionary.
+ * @workspace:      The workspace to emplace the dictionary into. It must
+ *                  outlive the returned dictionary.
+ * @workspace_size: The size of workspace. Use zstd_ddict_workspace_bound() to
+ *                  determine how large the workspace must be.
+ *
+ * Both zstd dictionaries and raw content dictionaries are accepted.
+ *
+ * Return:          A zstd decompression dictionary or NULL on error.
+ */
+const zstd_ddict *zstd_init_ddict(const void *dict, size_t dict_size,
+	void *workspace, size_t workspace_size);
+
+/**
+ * zstd_decompress_using_ddict() - decompress src into dst using a dictionary
+ * @dctx:         The decompression context.
+ * @dst:          The buffer to decompress src into.
+ * @dst_capacity: The size of the destination buffer.
+ * @src:          The zstd compressed data to decompress.
+ * @src_size:     The exact size of the data to decompress.
+ * @ddict:        The dictionary to use.
+ *
+ * Return:        The decompressed size or an error, which can be checked using
+ *                zstd_is_error().
+ */
+size_t zstd_decompress_using_ddict(zstd_dctx *dctx, void *dst,
+	size_t dst_capacity, const void *src, size_t src_size,
+	const zstd_ddict *ddict);
+
+/**
+ * zstd_dctx_ref_ddict() - use a dictionary for the following frames
+ * @dctx:  The decompression context, which may also be a zstd_dstream.
+ * @ddict: The dictionary to use, or NULL to go back to no dictionary.
+ *
+ * Return: Zero or an error, which can be checked using zstd_is_error().
+ */
+size_t zstd_dctx_ref_ddict(zstd_dctx *dctx, const zstd_ddict *ddict);
+
 struct abuf;
 
 /**
  * zstd_decompress() - Decompress Zstandard data
  *
+ * All frames at the start of @in are decompressed one after the other and
+ * skippable frames are stepped over. Anything after the last frame is
+ * ignored.
+ *
  * @in: Input buffer to decompress
  * @out: Output buffer to hold the results (must be large enough)
  * Return: size of the decompressed data, or -ve on error
  */
 int zstd_decompress(struct abuf *in, struct abuf *out);
 
+/**
+ * zstd_decompress_dict() - Decompress Zstandard data using a dictionary
+ *
+ * This is zstd_decompress() with a dictionary, see zstd_ddict_create()
+ *
+ * @in: Input buffer to decompress
+ * @out: Output buffer to hold the results (must be large enough)
+ * @ddict: Dictionary to use, or NULL for none
+ * Return: size of the decompressed data, or -ve on error
+ */
+int zstd_decompress_dict(struct abuf *in, struct abuf *out,
+			 const zstd_ddict *ddict);
+
+/**
+ * zstd_decompress_window() - Decompress Zstandard data through a window
+ *
+ * This decompresses all frames in @in into @win, which can be much smaller
+ * than the decompressed data, calling @out_fn each time some output is ready
+ * so that it can be written out, e.g. to a block device. The decompressor
+ * keeps its own history buffer, sized from the frame headers.
+ *
+ * @in: Input buffer to decompress
+ * @win: Buffer to decompress into, reused for each piece of output
+ * @out_fn: Function to call with each piece of output. It returns 0 to
+ *	continue or -ve to stop decompression with that error
+ * @priv: Private data passed to @out_fn
+ * @ddict: Dictionary to use, or NULL for none
+ * @sizep: Returns the total size of the decompressed data, if not NULL
+ * Return: 0 if OK, or -ve on error
+ */
+int zstd_decompress_window(struct abuf *in, struct abuf *win,
+			   int (*out_fn)(void *priv, const void *buf,
+					 size_t len),
+			   void *priv, const zstd_ddict *ddict,
+			   unsigned long long *sizep);
+
+/**
+ * zstd_ddict_create() - Set up a dictionary for decompression
+ *
+ * @dict: Dictionary contents, either a zstd dictionary or raw content. This
+ *	is referenced, not copied, so must stay valid while the dictionary is
+ *	in use
+ * @dict_size: Size of the dictionary in bytes
+ * Return: dictionary, or NULL if out of memory or @dict is invalid
+ */
+const zstd_ddict *zstd_ddict_create(const void *dict, size_t dict_size);
+
+/**
+ * zstd_ddict_free() - Free a dictionary created by zstd_ddict_create()
+ *
+ * @ddict: Dictionary to free
+ */
+void zstd_ddict_free(const zstd_ddict *ddict);
+
+/**
+ * zstd_decompress_cb() - Decompress Zstandard data block by block
+ *
+ * This is zstd_decompress() with a callback which is handed consecutive
+ * pieces of @in, in order, each one just before it is decompressed.
+ *
+ * @in: Input buffer to decompress
+ * @out: Output buffer to hold the results (must be large enough)
+ * @in_fn: Function to call with each piece of input
+ * @priv: Private data passed to @in_fn
+ * Return: size of the decompressed data, or -ve on error
+ */
+int zstd_decompress_cb(struct abuf *in, struct abuf *out,
+		       void (*in_fn)(void *priv, const void *buf, size_t len),
+		       void *priv);
+
 #endif  /* LINUX_ZSTD_H */
@@ -38,18 +38,20 @@ struct lmb_property {
 /**
  * struct lmb_region - Description of a set of region.
  *
+ * The regions are kept sorted by base address and do not overlap, so they
+ * can be searched with a binary search.
+ *
  * @cnt: Number of regions.
  * @max: Size of the region array, max value of cnt.
  * @region: Array of the region properties
+ * @alloced: true if @region was allocated when the table grew, false if it
+ *	is the storage in struct lmb
  */
 struct lmb_region {
 	unsigned long cnt;
 	unsigned long max;
-#if IS_ENABLED(CONFIG_LMB_USE_MAX_REGIONS)
-	struct lmb_property region[CONFIG_LMB_MAX_REGIONS];
-#else
 	struct lmb_property *region;
-#endif
+	bool alloced;
 };
 
 /**
@@ -68,13 +70,27 @@ struct lmb_region {
 struct lmb {
 	struct lmb_region memory;
 	struct lmb_region reserved;
-#ifdef CONFIG_LMB_MEMORY_REGIONS
+#if IS_ENABLED(CONFIG_LMB_USE_MAX_REGIONS)
+	struct lmb_property memory_regions[CONFIG_LMB_MAX_REGIONS];
+	struct lmb_property reserved_regions[CONFIG_LMB_MAX_REGIONS];
+#elif defined(CONFIG_LMB_MEMORY_REGIONS)
 	struct lmb_property memory_regions[CONFIG_LMB_MEMORY_REGIONS];
 	struct lmb_property reserved_regions[CONFIG_LMB_RESERVED_REGIONS];
 #endif
 };
 
 void lmb_init(struct lmb *lmb);
+
+/**
+ * lmb_uninit() - Free any region tables which lmb has grown
+ *
+ * With CONFIG_LMB_DYNAMIC_REGIONS, the region tables are moved to the heap
+ * when they outgrow the storage in struct lmb. This frees them again. The
+ * struct must be initialised with lmb_init() before it is used again.
+ *
+ * @lmb:	the logical memory block struct
+ */
+void lmb_uninit(struct lmb *lmb);
 void lmb_init_and_reserve(struct lmb *lmb, struct bd_info *bd, void *fdt_blob);
 void lmb_init_and_reserve_range(struct lmb *lmb, phys_addr_t base,
 				phys_size_t size, void *fdt_blob);
@@ -999,6 +999,113 @@ extern ulong mem_malloc_brk;
 
 void mem_malloc_init(ulong start, ulong size);
 
+/* Largest request served by the slab front-end (SYS_MALLOC_SLAB) */
+#define MALLOC_SLAB_MAX		512
+
+/**
+ * struct malloc_slab_stats - Statistics for one slab size class
+ *
+ * @size: Object size for this class in bytes
+ * @pages: Number of pages currently assigned to this class
+ * @capacity: Number of objects that fit in those pages
+ * @inuse: Number of objects currently allocated
+ * @peak: Highest value of @inuse so far
+ * @allocs: Total number of allocations from this class
+ * @fallbacks: Number of requests passed to dlmalloc because there were no
+ *	free pages
+ */
+struct malloc_slab_stats {
+	uint size;
+	uint pages;
+	uint capacity;
+	uint inuse;
+	uint peak;
+	ulong allocs;
+	ulong fallbacks;
+};
+
+/**
+ * malloc_slab_init() - Set up the slab region
+ *
+ * The region is taken from the start of the malloc() area, which is then
+ * reduced accordingly
+ *
+ * @start: Start of the malloc() area
+ * @size: Size of the malloc() area in bytes
+ * Return: number of bytes used for the slab region, 0 if none
+ */
+ulong malloc_slab_init(ulong start, ulong size);
+
+/**
+ * malloc_slab_alloc() - Allocate a small object from the slabs
+ *
+ * @bytes: Number of bytes required
+ * Return: object, or NULL if @bytes is 0 or too large, or the slab region
+ *	is full, in which case the caller should use dlmalloc
+ */
+void *malloc_slab_alloc(size_t bytes);
+
+/**
+ * malloc_slab_owns() - Check whether a pointer is a slab object
+ *
+ * @ptr: Pointer returned by malloc()
+ * Return: true if @ptr is in the slab region
+ */
+bool malloc_slab_owns(const void *ptr);
+
+/**
+ * malloc_slab_free() - Free a slab object
+ *
+ * @ptr: Pointer returned by malloc()
+ * Return: true if @ptr was a slab object and has been freed, false if it
+ *	is not a slab object
+ */
+bool malloc_slab_free(void *ptr);
+
+/**
+ * malloc_slab_realloc() - Resize a slab object
+ *
+ * @ptr: Slab object
+ * @bytes: New size in bytes
+ * Return: @ptr if it is large enough, else a new allocation holding the
+ *	contents of @ptr (which is freed), or NULL if out of memory
+ */
+void *malloc_slab_realloc(void *ptr, size_t bytes);
+
+/**
+ * malloc_slab_usable_size() - Get the usable size of a slab object
+ *
+ * @ptr: Pointer returned by malloc()
+ * Return: size of the object's class, or 0 if @ptr is not a slab object
+ */
+size_t malloc_slab_usable_size(const void *ptr);
+
+/**
+ * malloc_slab_inuse_bytes() - Get the number of bytes allocated from slabs
+ *
+ * Return: total size of all allocated slab objects
+ */
+size_t malloc_slab_inuse_bytes(void);
+
+/**
+ * malloc_slab_get_stats() - Get the statistics for a size class
+ *
+ * @cls: Size class, starting at 0
+ * @stats: Returns the statistics
+ * Return: 0 if OK, -ENOENT if @cls is past the last class, -ENODEV if the
+ *	slab region is not set up
+ */
+int malloc_slab_get_stats(uint cls, struct malloc_slab_stats *stats);
+
+/**
+ * malloc_slab_get_pages() - Get the number of slab pages
+ *
+ * @npagesp: Returns the total number of pages
+ * @nfreep: Returns the number of pages not assigned to any size class
+ * Return: 0 if OK, -ENODEV if the slab region is not set up
+ */
+int malloc_slab_get_pages(uint *npagesp, uint *nfreep);
+
 #ifdef __cplusplus
 };  /* end of extern "C" */
 #endif
@@ -550,6 +550,34 @@ extern int net_ntp_time_offset;			/* offset time from UTC */
 int net_init(void);
 int net_loop(enum proto_t);
 
+/**
+ * net_batch_start() - Start a batch of transfers
+ *
+ * Between this call and the matching net_batch_end(), a successful transfer
+ * leaves the Ethernet device running so that the next transfer can start
+ * straight away, without initialising the device again. The device used is
+ * the one chosen by the first transfer in the batch.
+ *
+ * Calls may be nested.
+ */
+void net_batch_start(void);
+
+/**
+ * net_batch_end() - End a batch of transfers
+ *
+ * When the outermost batch ends, the Ethernet device is halted if a transfer
+ * left it running.
+ */
+void net_batch_end(void);
+
+/**
+ * net_batch_active() - Check if a batch of transfers is in progress
+ *
+ * Return: true if net_batch_start() has been called more often than
+ *	net_batch_end()
+ */
+bool net_batch_active(void);
+
 /* Load failed.	 Start again. */
 int net_start_again(void);
 
@@ -8,17 +8,64 @@
 #ifndef __SANDBOX_HOST__
 #define __SANDBOX_HOST__
 
+/**
+ * struct host_sb_timing - model of the time taken by a storage device
+ *
+ * All values are 0 by default, so that transfers take no extra time
+ *
+ * @latency_us: Time taken by each command, in microseconds
+ * @rate_kbps: Transfer rate in KiB per second, or 0 for no limit
+ * @max_blocks: Maximum number of blocks in each command, or 0 for no limit.
+ *	Larger transfers are split into several commands, each with its own
+ *	latency
+ * @erase_blocks: Size of an erase block in blocks, or 0 if writes do not
+ *	need an erase
+ * @erase_us: Time taken to erase each erase block touched by a write, in
+ *	microseconds
+ */
+struct host_sb_timing {
+	uint latency_us;
+	uint rate_kbps;
+	uint max_blocks;
+	uint erase_blocks;
+	uint erase_us;
+};
+
+/**
+ * struct host_sb_stats - I/O statistics for a host device
+ *
+ * @reads: Number of read commands
+ * @writes: Number of write commands
+ * @blks_read: Number of blocks read
+ * @blks_written: Number of blocks written
+ * @erases: Number of erase blocks erased
+ * @busy_us: Total time taken according to the timing model, in microseconds
+ */
+struct host_sb_stats {
+	ulong reads;
+	ulong writes;
+	ulong blks_read;
+	ulong blks_written;
+	ulong erases;
+	u64 busy_us;
+};
+
 /**
  * struct host_sb_plat - platform data for a host device
  *
  * @label: Label for this device (allocated)
  * @filename: Name of file this is attached to, or NULL (allocated)
  * @fd: File descriptor of file, or 0 for none (file is not open)
+ * @timing: Model of the time taken by transfers
+ * @stats: I/O statistics since the file was attached or the statistics were
+ *	last read
  */
 struct host_sb_plat {
 	char *label;
 	char *filename;
 	int fd;
+	struct host_sb_timing timing;
+	struct host_sb_stats stats;
 };
 
 /**
@@ -66,6 +113,15 @@ int host_attach_file(struct udevice *dev, const char *filename);
  */
 int host_detach_file(struct udevice *dev);
 
+/**
+ * host_get_stats() - Get the I/O statistics for a device and reset them
+ *
+ * @dev: Host device
+ * @stats: Returns the statistics since the file was attached or this function
+ *	was last called
+ */
+void host_get_stats(struct udevice *dev, struct host_sb_stats *stats);
+
 /**
  * host_create_device() - Create a new host device
  *
@@ -19,7 +19,11 @@
  * @product: Product name
  * @block_size: Block size of device in bytes (normally 512)
  * @file_size: Size of the backing file for this emulator, in bytes
+ * @lba_base: Number of extra blocks to report in front of the backing file,
+ *	so that large devices can be emulated. Block @lba_base and onwards map
+ *	to the start of the file, as do the blocks from 0.
  * @seek_block: Seek position for file (block number)
+ * @last_cmd: Opcode of the last command processed
  *
  * @phase: Current SCSI phase
  * @buff_used: Number of bytes ready to transfer back to host
@@ -35,7 +39,8 @@ struct scsi_emul_info {
 	const char *product;
 	int block_size;
 	loff_t file_size;
-	int seek_block;
+	u64 lba_base;
+	u64 seek_block;
 
 	/* state maintained by the emulator: */
 	enum scsi_cmd_phase phase;
@@ -45,6 +50,7 @@ struct scsi_emul_info {
 	uint seek_pos;
 	int alloc_len;
 	uint transfer_len;
+	u8 last_cmd;
 };
 
 /**
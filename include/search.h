@@ -42,11 +42,22 @@ struct env_entry {
  * functions all work on a single internal hash table.
  */
 
+/* Number of entries in the lookup cache of a hash table, a power of two */
+#define HSEARCH_CACHE_SIZE	16
+
 /* Data type for reentrant functions.  */
 struct hsearch_data {
-	struct env_entry_node *table;
-	unsigned int size;
-	unsigned int filled;
+	struct env_entry_node **table;	/* hash table, NULL if not created */
+	unsigned int size;		/* number of slots in table */
+	unsigned int filled;		/* number of entries */
+	unsigned int deleted;		/* number of deleted slots in table */
+	struct env_entry_node **old_table; /* table being moved into table */
+	unsigned int old_size;		/* number of slots in old_table */
+	unsigned int old_pos;		/* next slot of old_table to move */
+	struct env_entry_node **list;	/* entries, indexed by hsearch_r() */
+	struct env_entry_node **sorted;	/* entries sorted by key */
+	unsigned int list_size;		/* space in list and sorted */
+	struct env_entry_node *cache[HSEARCH_CACHE_SIZE]; /* recent lookups */
 /*
  * Callback function which will check whether the given change for variable
  * "item" to "newval" may be applied or not, and possibly apply such change.
@@ -58,7 +69,10 @@ struct hsearch_data {
 			 enum env_op, int flag);
 };
 
-/* Create a new hash table which will contain at most "nel" elements.  */
+/*
+ * Create a new hash table sized for "nel" elements. The table grows when it
+ * fills up.
+ */
 int hcreate_r(size_t nel, struct hsearch_data *htab);
 
 /* Destroy current internal hash table.  */
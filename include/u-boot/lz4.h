@@ -21,6 +21,46 @@
  */
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
 
+/**
+ * ulz4fn_cb() - Decompress LZ4 data, reporting the input as it is consumed
+ *
+ * This is ulz4fn() with a callback which is handed consecutive pieces of
+ * @src, in order, each one just before it is decompressed. The final piece
+ * ends with the end mark; anything after it is not passed to @in_fn.
+ *
+ * @src: Source data to decompress
+ * @srcn: Length of source data
+ * @dst: Destination for uncompressed data
+ * @dstn: Returns length of uncompressed data
+ * @in_fn: Function to call with each piece of input, or NULL
+ * @priv: Private data passed to @in_fn
+ * Return: see ulz4fn()
+ */
+int ulz4fn_cb(const void *src, size_t srcn, void *dst, size_t *dstn,
+	      void (*in_fn)(void *priv, const void *buf, size_t len),
+	      void *priv);
+
+/**
+ * ulz4fn_out() - Decompress LZ4 data a block at a time
+ *
+ * This decompresses each block of the frame into a buffer of the frame's
+ * maximum block size, then passes it to @out_fn, so the output can be much
+ * larger than the memory available for it. Stored (uncompressed) blocks are
+ * passed straight from @src.
+ *
+ * @src: Source data to decompress
+ * @srcn: Length of source data
+ * @out_fn: Function to call with each block of output. It returns 0 to
+ *	continue or -ve to stop decompression with that error
+ * @priv: Private data passed to @out_fn
+ * @dstn: Returns length of uncompressed data
+ * Return: see ulz4fn(); also -ENOMEM if the block buffer cannot be allocated,
+ *	or the error returned by @out_fn
+ */
+int ulz4fn_out(const void *src, size_t srcn,
+	       int (*out_fn)(void *priv, const void *buf, size_t len),
+	       void *priv, unsigned long long *dstn);
+
 /**
  * LZ4_decompress_safe() - Decompression protected against buffer overflow
  * @source: source address of the compressed data
@@ -652,11 +652,14 @@ struct usb_dev_plat {
  *		so this will be false.
  * @companion:  True if this is a companion controller to another USB
  *		controller
+ * @scan_err:	Result of starting the scan of this bus's root hub, reported
+ *		once the shared port scan of all buses has completed
  */
 struct usb_bus_priv {
 	int next_addr;
 	bool desc_before_addr;
 	bool companion;
+	int scan_err;
 };
 
 /**
@@ -935,6 +938,29 @@ bool usb_device_has_child_on_port(struct usb_device *parent, int port);
 int usb_hub_probe(struct usb_device *dev, int ifnum);
 void usb_hub_reset(void);
 
+/**
+ * usb_hub_defer_port_scan() - Queue hub ports instead of scanning them
+ *
+ * While deferred, configuring a hub powers on its ports and queues them for
+ * scanning but returns without waiting for them. This allows the ports of
+ * several root hubs to wait out their power-good and debounce delays at the
+ * same time. Call usb_hub_scan_ports() to scan everything that was queued.
+ *
+ * @defer: true to defer scanning, false to scan immediately (the default)
+ */
+void usb_hub_defer_port_scan(bool defer);
+
+/**
+ * usb_hub_scan_ports() - Scan all queued hub ports
+ *
+ * This ends any deferral started by usb_hub_defer_port_scan() and scans the
+ * queued ports, including those of hubs found along the way, until each has
+ * either enumerated a device or timed out.
+ *
+ * Return: 0 if OK, -ve on error
+ */
+int usb_hub_scan_ports(void);
+
 /*
  * usb_find_usb2_hub_address_port() - Get hub address and port for TT setting
  *
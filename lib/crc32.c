@@ -31,7 +31,17 @@
 
 #define tole(x) cpu_to_le32(x)
 
-#ifdef CONFIG_DYNAMIC_CRC_TABLE
+#if !defined(USE_HOSTCC) && !defined(CONFIG_ARM64_CRC32)
+#if defined(CONFIG_RISCV_ISA_ZBC)
+#define CRC32_ZBC
+#elif CONFIG_IS_ENABLED(CRC32_SLICE_BY_8)
+#define CRC32_SLICE_BY_8
+#endif
+#endif
+
+#ifdef CRC32_SLICE_BY_8
+#include "crc32_slice.h"
+#elif defined(CONFIG_DYNAMIC_CRC_TABLE)
 
 static int __efi_runtime_data crc_table_empty = 1;
 static uint32_t __efi_runtime_data crc_table[256];
@@ -170,6 +180,78 @@ const uint32_t * ZEXPORT get_crc_table()
 }
 #endif
 
+#ifdef CRC32_SLICE_BY_8
+/**
+ * crc32_slice_by_8() - Calculate a CRC32 eight bytes at a time
+ *
+ * @crc: Initial CRC value (no ones complement)
+ * @buf: Data to process
+ * @len: Number of bytes in @buf
+ * Return: updated CRC value
+ */
+static uint32_t __efi_runtime crc32_slice_by_8(uint32_t crc, const Bytef *buf,
+					       uInt len)
+{
+	const uint32_t (*t)[256] = crc_slice;
+	uint32_t lo, hi;
+
+	/* align so that the eight-byte loads below are aligned */
+	for (; len && ((ulong)buf & 7); len--)
+		crc = t[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+
+	for (; len >= 8; len -= 8, buf += 8) {
+		lo = crc ^ le32_to_cpu(*(const uint32_t *)buf);
+		hi = le32_to_cpu(*(const uint32_t *)(buf + 4));
+		crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+		      t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+		      t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^
+		      t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+	}
+
+	while (len--)
+		crc = t[0][(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+
+	return crc;
+}
+#endif
+
+#ifdef CRC32_ZBC
+/* The CRC32 polynomial, bit-reflected */
+#define CRC32_POLY_LE	0xedb88320
+
+/*
+ * floor(x^96 / P(x)) without its x^64 term, bit-reflected. The low half is
+ * floor(x^64 / P(x)) without its x^32 term, which is what RV32 needs.
+ */
+#define CRC32_POLY_QT_LE	0x5a72d812fb808b20ULL
+
+/**
+ * crc32_zbc_word() - Add a register-sized word to a CRC32
+ *
+ * This works out (crc ^ word) * x^32 mod P(x) by Barrett reduction, with all
+ * values bit-reflected: clmul gives the quotient and clmulr the remainder.
+ *
+ * @crc: Initial CRC value (no ones complement)
+ * @word: Next sizeof(ulong) bytes of data, loaded little-endian
+ * Return: updated CRC value
+ */
+static inline uint32_t __efi_runtime crc32_zbc_word(uint32_t crc, ulong word)
+{
+	ulong s = crc ^ word;
+	ulong t;
+
+	asm ("clmul	%0, %1, %2\n\t"
+	     "slli	%0, %0, 1\n\t"
+	     "xor	%0, %0, %1\n\t"
+	     "clmulr	%0, %0, %3"
+	     : "=&r" (t)
+	     : "r" (s), "r" ((ulong)CRC32_POLY_QT_LE),
+	       "r" ((ulong)CRC32_POLY_LE << (BITS_PER_LONG - 32)));
+
+	return t >> (BITS_PER_LONG - 32);
+}
+#endif
+
 /* ========================================================================= */
 # if __BYTE_ORDER == __LITTLE_ENDIAN
 #  define DO_CRC(x) crc = tab[(crc ^ (x)) & 255] ^ (crc >> 8)
@@ -186,9 +268,31 @@ uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
 {
 #ifdef CONFIG_ARM64_CRC32
     crc = cpu_to_le32(crc);
+    /* align, then use the 64-bit form of the instruction */
+    for (; len && ((ulong)buf & 7); len--)
+        crc = __builtin_aarch64_crc32b(crc, *buf++);
+    for (; len >= 8; len -= 8, buf += 8)
+        crc = __builtin_aarch64_crc32x(crc, *(const uint64_t *)buf);
     while (len--)
         crc = __builtin_aarch64_crc32b(crc, *buf++);
     return le32_to_cpu(crc);
+#elif defined(CRC32_SLICE_BY_8)
+    return crc32_slice_by_8(crc, buf, len);
+#elif defined(CRC32_ZBC)
+    const uint32_t *tab = crc_table;
+
+#ifdef CONFIG_DYNAMIC_CRC_TABLE
+    if (crc_table_empty)
+      make_crc_table();
+#endif
+    /* align, then add a whole register at a time */
+    for (; len && ((ulong)buf & (sizeof(ulong) - 1)); len--)
+        DO_CRC(*buf++);
+    for (; len >= sizeof(ulong); len -= sizeof(ulong), buf += sizeof(ulong))
+        crc = crc32_zbc_word(crc, *(const ulong *)buf);
+    while (len--)
+        DO_CRC(*buf++);
+    return crc;
 #else
     const uint32_t *tab = crc_table;
     const uint32_t *b =(const uint32_t *)buf;
@@ -0,0 +1,354 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Decompress an image from memory while writing it to a block device
+ *
+ * Based on gzwrite() from lib/gunzip.c:
+ * (C) Copyright 2000-2006
+ * Wolfgang Denk, DENX Software Engineering, wd@denx.de.
+ */
+
+#include <common.h>
+#include <abuf.h>
+#include <blk.h>
+#include <console.h>
+#include <decomp_write.h>
+#include <div64.h>
+#include <gzip.h>
+#include <image.h>
+#include <log.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <watchdog.h>
+#include <asm/unaligned.h>
+#include <linux/sizes.h>
+#include <linux/zstd.h>
+#include <lzma/LzmaTypes.h>
+#include <lzma/LzmaTools.h>
+#include <u-boot/crc.h>
+#include <u-boot/lz4.h>
+#include <u-boot/zlib.h>
+
+/* Output window used by the zstd decoder, in front of the write buffer */
+#define ZSTD_WINDOW		SZ_128K
+
+/**
+ * struct decomp_writer - State for writing decompressed data to a device
+ *
+ * @dev: Block device to write to
+ * @buf: Write buffer, @size bytes
+ * @size: Number of bytes written to the device at a time
+ * @fill: Number of bytes currently in @buf
+ * @outblock: Next block to write on @dev
+ * @total: Number of decompressed bytes so far
+ * @expected: Expected number of decompressed bytes, 0 if not known
+ * @iteration: Number of writes so far, for progress reporting
+ */
+struct decomp_writer {
+	struct blk_desc *dev;
+	u8 *buf;
+	ulong size;
+	ulong fill;
+	lbaint_t outblock;
+	u64 total;
+	u64 expected;
+	int iteration;
+};
+
+/**
+ * dw_start() - Check the expected size, once known, and start progress
+ *
+ * @dw: Writer state
+ * Return: 0 if OK, -EFBIG if the output would not fit on the device
+ */
+static int dw_start(struct decomp_writer *dw)
+{
+	if (lldiv(dw->expected, dw->dev->blksz) >
+	    dw->dev->lba - dw->outblock) {
+		printf("%s: uncompressed size %llu exceeds device size\n",
+		       __func__, dw->expected);
+		return -EFBIG;
+	}
+	gzwrite_progress_init(dw->expected);
+
+	return 0;
+}
+
+/**
+ * dw_flush() - Write out the contents of the write buffer
+ *
+ * A partly filled buffer (at the end of the data) is padded with zeroes up
+ * to a whole number of blocks.
+ *
+ * @dw: Writer state
+ * Return: 0 if OK, -ENOSPC if the device is full, -EIO on write error,
+ *	-EINTR if the user pressed Ctrl-C
+ */
+static int dw_flush(struct decomp_writer *dw)
+{
+	lbaint_t blocks, written;
+
+	if (!dw->fill)
+		return 0;
+
+	blocks = DIV_ROUND_UP(dw->fill, dw->dev->blksz);
+	memset(dw->buf + dw->fill, '\0', blocks * dw->dev->blksz - dw->fill);
+	if (blocks > dw->dev->lba - dw->outblock) {
+		printf("%s: output exceeds device size\n", __func__);
+		return -ENOSPC;
+	}
+
+	gzwrite_progress(dw->iteration++, dw->total, dw->expected);
+	written = blk_dwrite(dw->dev, dw->outblock, blocks, dw->buf);
+	dw->outblock += written;
+	dw->fill = 0;
+	if (written != blocks) {
+		printf("%s: write error at block " LBAF "\n", __func__,
+		       dw->outblock);
+		return -EIO;
+	}
+	if (ctrlc()) {
+		puts("abort\n");
+		return -EINTR;
+	}
+	schedule();
+
+	return 0;
+}
+
+/**
+ * dw_out() - Add decompressed data to the write buffer
+ *
+ * This is used as the output callback for decoders which produce data in
+ * their own buffers. The write buffer is written out each time it fills up.
+ *
+ * @priv: Writer state
+ * @buf: Decompressed data
+ * @len: Number of bytes in @buf
+ * Return: 0 if OK, else see dw_flush()
+ */
+static int dw_out(void *priv, const void *buf, size_t len)
+{
+	struct decomp_writer *dw = priv;
+	int ret;
+
+	while (len) {
+		size_t chunk = min_t(size_t, len, dw->size - dw->fill);
+
+		memcpy(dw->buf + dw->fill, buf, chunk);
+		dw->fill += chunk;
+		dw->total += chunk;
+		buf += chunk;
+		len -= chunk;
+		if (dw->fill == dw->size) {
+			ret = dw_flush(dw);
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * dw_gzip() - Decompress gzip data into the write buffer
+ *
+ * inflate() writes straight into the write buffer, so no copy is needed.
+ * The expected size defaults to the size in the gzip trailer, and the
+ * output is checked against the trailer CRC.
+ *
+ * @dw: Writer state
+ * @src: Compressed data
+ * @len: Size of @src in bytes
+ * Return: 0 if OK, -ve on error
+ */
+static int dw_gzip(struct decomp_writer *dw, u8 *src, ulong len)
+{
+	u32 expected_crc, szuncompressed;
+	unsigned crc = 0;
+	z_stream s;
+	int i, r, ret;
+
+	i = gzip_parse_header(src, len);
+	if (i < 0)
+		return -EINVAL;
+	if (i >= len - 8) {
+		puts("Error: gunzip out of data in header");
+		return -EINVAL;
+	}
+
+	expected_crc = get_unaligned_le32(src + len - 8);
+	szuncompressed = get_unaligned_le32(src + len - 4);
+	if (!dw->expected) {
+		dw->expected = szuncompressed;
+	} else if (szuncompressed != (u32)dw->expected) {
+		printf("size of %llx doesn't match trailer low bits %x\n",
+		       dw->expected, szuncompressed);
+		return -EINVAL;
+	}
+	ret = dw_start(dw);
+	if (ret)
+		return ret;
+
+	s.zalloc = gzalloc;
+	s.zfree = gzfree;
+	r = inflateInit2(&s, -MAX_WBITS);
+	if (r != Z_OK) {
+		printf("Error: inflateInit2() returned %d\n", r);
+		return -EINVAL;
+	}
+	s.next_in = src + i;
+	s.avail_in = len - i;
+
+	/* decompress until deflate stream ends or end of file */
+	do {
+		ulong numfilled;
+
+		if (!s.avail_in) {
+			printf("%s: weird termination with result %d\n",
+			       __func__, r);
+			break;
+		}
+		s.next_out = dw->buf + dw->fill;
+		s.avail_out = dw->size - dw->fill;
+		r = inflate(&s, Z_SYNC_FLUSH);
+		if (r != Z_OK && r != Z_STREAM_END) {
+			printf("Error: inflate() returned %d\n", r);
+			ret = -EINVAL;
+			goto out;
+		}
+		numfilled = dw->size - dw->fill - s.avail_out;
+		crc = crc32(crc, dw->buf + dw->fill, numfilled);
+		dw->fill += numfilled;
+		dw->total += numfilled;
+		if (dw->fill == dw->size) {
+			ret = dw_flush(dw);
+			if (ret)
+				goto out;
+		}
+		/* done when inflate() says it's done */
+	} while (r != Z_STREAM_END);
+
+	ret = dw_flush(dw);
+	if (!ret && (dw->expected != dw->total || crc != expected_crc))
+		ret = -EINVAL;
+out:
+	gzwrite_progress_finish(ret, dw->total, dw->expected, expected_crc,
+				crc);
+	inflateEnd(&s);
+
+	return ret;
+}
+
+/**
+ * dw_zstd() - Decompress zstd data into the write buffer
+ *
+ * @dw: Writer state
+ * @src: Compressed data
+ * @len: Size of @src in bytes
+ * Return: 0 if OK, -ve on error
+ */
+static int dw_zstd(struct decomp_writer *dw, u8 *src, ulong len)
+{
+	unsigned long long size;
+	struct abuf in, win;
+	int ret;
+
+	ret = dw_start(dw);
+	if (ret)
+		return ret;
+
+	abuf_init_set(&in, src, len);
+	abuf_init(&win);
+	if (!abuf_realloc(&win, ZSTD_WINDOW))
+		return -ENOMEM;
+	ret = zstd_decompress_window(&in, &win, dw_out, dw, NULL, &size);
+	abuf_uninit(&win);
+
+	return ret;
+}
+
+int decomp_write(int comp, void *src, ulong len, struct blk_desc *dev,
+		 ulong szwritebuf, u64 startoffs, u64 szexpected)
+{
+	struct decomp_writer dw;
+	unsigned long long size;
+	int ret;
+
+	if (!szwritebuf ||
+	    (szwritebuf % dev->blksz) ||
+	    (szwritebuf < dev->blksz)) {
+		printf("%s: size %lu not a multiple of %lu\n",
+		       __func__, szwritebuf, dev->blksz);
+		return -EINVAL;
+	}
+
+	if (startoffs & (dev->blksz - 1)) {
+		printf("%s: start offset %llu not a multiple of %lu\n",
+		       __func__, startoffs, dev->blksz);
+		return -EINVAL;
+	}
+
+	memset(&dw, '\0', sizeof(dw));
+	dw.dev = dev;
+	dw.size = szwritebuf;
+	dw.outblock = lldiv(startoffs, dev->blksz);
+	dw.expected = szexpected;
+	dw.buf = malloc_cache_aligned(szwritebuf);
+	if (!dw.buf)
+		return -ENOMEM;
+
+	switch (comp) {
+	case IH_COMP_GZIP:
+		ret = -EPROTONOSUPPORT;
+		if (IS_ENABLED(CONFIG_GZIP))
+			ret = dw_gzip(&dw, src, len);
+		/* dw_gzip() reports its own progress and result */
+		goto out;
+	case IH_COMP_ZSTD:
+		ret = -EPROTONOSUPPORT;
+		if (IS_ENABLED(CONFIG_ZSTD))
+			ret = dw_zstd(&dw, src, len);
+		break;
+	case IH_COMP_LZ4:
+		ret = -EPROTONOSUPPORT;
+		if (IS_ENABLED(CONFIG_LZ4)) {
+			ret = dw_start(&dw);
+			if (!ret)
+				ret = ulz4fn_out(src, len, dw_out, &dw, &size);
+		}
+		break;
+	case IH_COMP_LZMA:
+		ret = -EPROTONOSUPPORT;
+		if (IS_ENABLED(CONFIG_LZMA)) {
+			ret = dw_start(&dw);
+			if (!ret)
+				ret = lzmaBuffToCbDecompress(src, len, dw_out,
+							     &dw, &size);
+			if (ret > 0)	/* SZ_ERROR_... */
+				ret = -EINVAL;
+		}
+		break;
+	default:
+		ret = -EPROTONOSUPPORT;
+		break;
+	}
+	if (ret == -EPROTONOSUPPORT)
+		printf("%s: unsupported compression type %s\n", __func__,
+		       genimg_get_comp_name(comp));
+	if (!ret)
+		ret = dw_flush(&dw);
+	if (!ret && dw.expected && dw.total != dw.expected)
+		ret = -EINVAL;
+	gzwrite_progress_finish(ret, dw.total, dw.expected, 0, 0);
+out:
+	free(dw.buf);
+
+	return ret;
+}
+
+int gzwrite(unsigned char *src, int len, struct blk_desc *dev,
+	    ulong szwritebuf, ulong startoffs, ulong szexpected)
+{
+	return decomp_write(IH_COMP_GZIP, src, len, dev, szwritebuf,
+			    startoffs, szexpected) ? -1 : 0;
+}
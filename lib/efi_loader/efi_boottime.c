@@ -806,7 +806,7 @@ static efi_status_t EFIAPI efi_create_event_ext(
  * efi_timer_check() - check if a timer event has occurred
  *
  * Check if a timer event has occurred or a queued notification function should
- * be called.
+ * be called. Also carry out the next step of any queued asynchronous I/O.
  *
  * Our timers have to work without interrupts, so we check whenever keyboard
  * input or disk accesses happen if enough time elapsed for them to fire.
@@ -834,6 +834,7 @@ void efi_timer_check(void)
 		evt->is_signaled = false;
 		efi_signal_event(evt);
 	}
+	efi_io_poll();
 	efi_process_event_queue();
 	schedule();
 }
@@ -2133,6 +2134,9 @@ static efi_status_t EFIAPI efi_exit_boot_services(efi_handle_t image_handle,
 	if (!systab.boottime)
 		goto out;
 
+	/* Complete any asynchronous I/O still in progress */
+	efi_io_flush(NULL);
+
 	/* Notify EFI_EVENT_GROUP_BEFORE_EXIT_BOOT_SERVICES event group. */
 	list_for_each_entry(evt, &efi_events, link) {
 		if (evt->group &&
@@ -25,6 +25,7 @@ struct efi_system_partition efi_system_partition = {
 };
 
 const efi_guid_t efi_block_io_guid = EFI_BLOCK_IO_PROTOCOL_GUID;
+const efi_guid_t efi_block_io2_guid = EFI_BLOCK_IO2_PROTOCOL_GUID;
 const efi_guid_t efi_system_partition_guid = PARTITION_SYSTEM_GUID;
 
 /**
@@ -32,6 +33,7 @@ const efi_guid_t efi_system_partition_guid = PARTITION_SYSTEM_GUID;
  *
  * @header:	EFI object header
  * @ops:	EFI disk I/O protocol interface
+ * @ops2:	EFI block I/O 2 protocol interface
  * @dev_index:	device index of block device
  * @media:	block I/O media information
  * @dp:		device path to the block device
@@ -42,6 +44,7 @@ const efi_guid_t efi_system_partition_guid = PARTITION_SYSTEM_GUID;
 struct efi_disk_obj {
 	struct efi_object header;
 	struct efi_block_io ops;
+	struct efi_block_io2 ops2;
 	int dev_index;
 	struct efi_block_io_media media;
 	struct efi_device_path *dp;
@@ -103,6 +106,40 @@ enum efi_disk_direction {
 	EFI_DISK_WRITE,
 };
 
+/**
+ * efi_disk_check_rw() - check the parameters of a block transfer
+ *
+ * @media:		media information of the device
+ * @media_id:		id of the medium to transfer to or from
+ * @lba:		starting logical block
+ * @buffer_size:	size of the buffer
+ * @buffer:		buffer to transfer to or from
+ * @direction:		direction of the transfer
+ * Return:		status code
+ */
+static efi_status_t efi_disk_check_rw(struct efi_block_io_media *media,
+				      u32 media_id, u64 lba,
+				      efi_uintn_t buffer_size, void *buffer,
+				      enum efi_disk_direction direction)
+{
+	if (direction == EFI_DISK_WRITE && media->read_only)
+		return EFI_WRITE_PROTECTED;
+	/* TODO: check for media changes */
+	if (media_id != media->media_id)
+		return EFI_MEDIA_CHANGED;
+	if (!media->media_present)
+		return EFI_NO_MEDIA;
+	/* media->io_align is a power of 2 or 0 */
+	if (media->io_align &&
+	    (uintptr_t)buffer & (media->io_align - 1))
+		return EFI_INVALID_PARAMETER;
+	if (lba * media->block_size + buffer_size >
+	    (media->last_block + 1) * media->block_size)
+		return EFI_INVALID_PARAMETER;
+
+	return EFI_SUCCESS;
+}
+
 static efi_status_t efi_disk_rw_blocks(struct efi_block_io *this,
 			u32 media_id, u64 lba, unsigned long buffer_size,
 			void *buffer, enum efi_disk_direction direction)
@@ -177,18 +214,10 @@ static efi_status_t EFIAPI efi_disk_read_blocks(struct efi_block_io *this,
 
 	if (!this)
 		return EFI_INVALID_PARAMETER;
-	/* TODO: check for media changes */
-	if (media_id != this->media->media_id)
-		return EFI_MEDIA_CHANGED;
-	if (!this->media->media_present)
-		return EFI_NO_MEDIA;
-	/* media->io_align is a power of 2 or 0 */
-	if (this->media->io_align &&
-	    (uintptr_t)buffer & (this->media->io_align - 1))
-		return EFI_INVALID_PARAMETER;
-	if (lba * this->media->block_size + buffer_size >
-	    (this->media->last_block + 1) * this->media->block_size)
-		return EFI_INVALID_PARAMETER;
+	r = efi_disk_check_rw(this->media, media_id, lba, buffer_size, buffer,
+			      EFI_DISK_READ);
+	if (r != EFI_SUCCESS)
+		return r;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 	if (buffer_size > EFI_LOADER_BOUNCE_BUFFER_SIZE) {
@@ -208,6 +237,9 @@ static efi_status_t EFIAPI efi_disk_read_blocks(struct efi_block_io *this,
 	EFI_ENTRY("%p, %x, %llx, %zx, %p", this, media_id, lba,
 		  buffer_size, buffer);
 
+	/* Complete queued transfers first, they may use the bounce buffer */
+	efi_io_flush(container_of(this, struct efi_disk_obj, ops));
+
 	r = efi_disk_rw_blocks(this, media_id, lba, buffer_size, real_buffer,
 			       EFI_DISK_READ);
 
@@ -243,20 +275,10 @@ static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
 
 	if (!this)
 		return EFI_INVALID_PARAMETER;
-	if (this->media->read_only)
-		return EFI_WRITE_PROTECTED;
-	/* TODO: check for media changes */
-	if (media_id != this->media->media_id)
-		return EFI_MEDIA_CHANGED;
-	if (!this->media->media_present)
-		return EFI_NO_MEDIA;
-	/* media->io_align is a power of 2 or 0 */
-	if (this->media->io_align &&
-	    (uintptr_t)buffer & (this->media->io_align - 1))
-		return EFI_INVALID_PARAMETER;
-	if (lba * this->media->block_size + buffer_size >
-	    (this->media->last_block + 1) * this->media->block_size)
-		return EFI_INVALID_PARAMETER;
+	r = efi_disk_check_rw(this->media, media_id, lba, buffer_size, buffer,
+			      EFI_DISK_WRITE);
+	if (r != EFI_SUCCESS)
+		return r;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 	if (buffer_size > EFI_LOADER_BOUNCE_BUFFER_SIZE) {
@@ -276,6 +298,9 @@ static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
 	EFI_ENTRY("%p, %x, %llx, %zx, %p", this, media_id, lba,
 		  buffer_size, buffer);
 
+	/* Complete queued transfers first, they may use the bounce buffer */
+	efi_io_flush(container_of(this, struct efi_disk_obj, ops));
+
 	/* Populate bounce buffer if necessary */
 	if (real_buffer != buffer)
 		memcpy(real_buffer, buffer, buffer_size);
@@ -292,7 +317,8 @@ static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
  * This function implements the FlushBlocks service of the
  * EFI_BLOCK_IO_PROTOCOL.
  *
- * As we always write synchronously nothing is done here.
+ * As we always write synchronously only queued asynchronous transfers have
+ * to be completed here.
  *
  * See the Unified Extensible Firmware Interface (UEFI) specification for
  * details.
@@ -303,6 +329,10 @@ static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
 static efi_status_t EFIAPI efi_disk_flush_blocks(struct efi_block_io *this)
 {
 	EFI_ENTRY("%p", this);
+
+	if (this)
+		efi_io_flush(container_of(this, struct efi_disk_obj, ops));
+
 	return EFI_EXIT(EFI_SUCCESS);
 }
 
@@ -313,6 +343,243 @@ static const struct efi_block_io block_io_disk_template = {
 	.flush_blocks = &efi_disk_flush_blocks,
 };
 
+/**
+ * struct efi_disk_io - block transfer for the EFI_BLOCK_IO2_PROTOCOL
+ *
+ * @req:	I/O request
+ * @diskobj:	disk to transfer to or from
+ * @lba:	next logical block to transfer
+ * @size:	number of bytes still to transfer
+ * @buffer:	buffer for the next block
+ * @direction:	direction of the transfer
+ */
+struct efi_disk_io {
+	struct efi_io_request req;
+	struct efi_disk_obj *diskobj;
+	u64 lba;
+	efi_uintn_t size;
+	void *buffer;
+	enum efi_disk_direction direction;
+};
+
+/**
+ * efi_disk_io_step() - transfer the next part of a block transfer
+ *
+ * @req:	I/O request of the transfer
+ * Return:	EFI_NOT_READY if there is more to transfer, else status code
+ */
+static efi_status_t efi_disk_io_step(struct efi_io_request *req)
+{
+	struct efi_disk_io *io = container_of(req, struct efi_disk_io, req);
+	struct efi_block_io *this = &io->diskobj->ops;
+	u32 blksz = this->media->block_size;
+	void *real_buffer = io->buffer;
+	efi_uintn_t size;
+	efi_status_t r;
+
+	if (!io->size)
+		return EFI_SUCCESS;
+
+	size = max_t(efi_uintn_t, EFI_IO_STEP_SIZE / blksz, 1) * blksz;
+	size = min(size, io->size);
+
+#ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
+	real_buffer = efi_bounce_buffer;
+	if (io->direction == EFI_DISK_WRITE)
+		memcpy(real_buffer, io->buffer, size);
+#endif
+
+	r = efi_disk_rw_blocks(this, this->media->media_id, io->lba, size,
+			       real_buffer, io->direction);
+	if (r != EFI_SUCCESS)
+		return r;
+
+	/* Copy from bounce buffer to real buffer if necessary */
+	if (io->direction == EFI_DISK_READ && real_buffer != io->buffer)
+		memcpy(io->buffer, real_buffer, size);
+
+	io->lba += size / blksz;
+	io->buffer += size;
+	io->size -= size;
+
+	return io->size ? EFI_NOT_READY : EFI_SUCCESS;
+}
+
+/**
+ * efi_disk_rw_blocks_ex() - start a block transfer
+ *
+ * If @token has an event the transfer is queued, otherwise it is carried out
+ * before returning.
+ *
+ * @this:		pointer to the BLOCK_IO2_PROTOCOL
+ * @media_id:		id of the medium to transfer to or from
+ * @lba:		starting logical block
+ * @token:		transaction token, may be NULL
+ * @buffer_size:	size of the buffer
+ * @buffer:		buffer to transfer to or from
+ * @direction:		direction of the transfer
+ * Return:		status code
+ */
+static efi_status_t efi_disk_rw_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba, struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer,
+			enum efi_disk_direction direction)
+{
+	struct efi_disk_io *io;
+	efi_status_t r;
+
+	if (!this)
+		return EFI_INVALID_PARAMETER;
+	r = efi_disk_check_rw(this->media, media_id, lba, buffer_size, buffer,
+			      direction);
+	if (r != EFI_SUCCESS)
+		return r;
+	/* We only support full block access */
+	if (buffer_size & (this->media->block_size - 1))
+		return EFI_BAD_BUFFER_SIZE;
+
+	io = calloc(1, sizeof(*io));
+	if (!io)
+		return EFI_OUT_OF_RESOURCES;
+	io->diskobj = container_of(this, struct efi_disk_obj, ops2);
+	io->lba = lba;
+	io->size = buffer_size;
+	io->buffer = buffer;
+	io->direction = direction;
+	io->req.owner = io->diskobj;
+	io->req.step = efi_disk_io_step;
+	if (token && token->event) {
+		io->req.event = token->event;
+		io->req.status = &token->transaction_status;
+		token->transaction_status = EFI_NOT_READY;
+	}
+
+	return efi_io_submit(&io->req);
+}
+
+/**
+ * efi_disk_reset2() - reset block device
+ *
+ * This function implements the Reset service of the EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * Queued transfers are aborted. As U-Boot's block devices do not have a reset
+ * function nothing else is done.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @extended_verification:	extended verification
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_reset2(struct efi_block_io2 *this,
+					   bool extended_verification)
+{
+	EFI_ENTRY("%p, %x", this, extended_verification);
+
+	if (!this)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+	efi_io_cancel(container_of(this, struct efi_disk_obj, ops2));
+
+	return EFI_EXIT(EFI_SUCCESS);
+}
+
+/**
+ * efi_disk_read_blocks_ex() - reads blocks from device
+ *
+ * This function implements the ReadBlocksEx service of the
+ * EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @media_id:			id of the medium to be read from
+ * @lba:			starting logical block for reading
+ * @token:			transaction token
+ * @buffer_size:		size of the read buffer
+ * @buffer:			pointer to the destination buffer
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_read_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba, struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer)
+{
+	EFI_ENTRY("%p, %x, %llx, %p, %zx, %p", this, media_id, lba, token,
+		  buffer_size, buffer);
+
+	return EFI_EXIT(efi_disk_rw_blocks_ex(this, media_id, lba, token,
+					      buffer_size, buffer,
+					      EFI_DISK_READ));
+}
+
+/**
+ * efi_disk_write_blocks_ex() - writes blocks to device
+ *
+ * This function implements the WriteBlocksEx service of the
+ * EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @media_id:			id of the medium to be written to
+ * @lba:			starting logical block for writing
+ * @token:			transaction token
+ * @buffer_size:		size of the write buffer
+ * @buffer:			pointer to the source buffer
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_write_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba, struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer)
+{
+	EFI_ENTRY("%p, %x, %llx, %p, %zx, %p", this, media_id, lba, token,
+		  buffer_size, buffer);
+
+	return EFI_EXIT(efi_disk_rw_blocks_ex(this, media_id, lba, token,
+					      buffer_size, buffer,
+					      EFI_DISK_WRITE));
+}
+
+/**
+ * efi_disk_flush_blocks_ex() - flushes modified data to the device
+ *
+ * This function implements the FlushBlocksEx service of the
+ * EFI_BLOCK_IO2_PROTOCOL.
+ *
+ * Queued transfers are completed before the token is signalled.
+ *
+ * See the Unified Extensible Firmware Interface (UEFI) specification for
+ * details.
+ *
+ * @this:			pointer to the BLOCK_IO2_PROTOCOL
+ * @token:			transaction token
+ * Return:			status code
+ */
+static efi_status_t EFIAPI efi_disk_flush_blocks_ex(struct efi_block_io2 *this,
+			struct efi_block_io2_token *token)
+{
+	EFI_ENTRY("%p, %p", this, token);
+
+	if (!this)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+	efi_io_flush(container_of(this, struct efi_disk_obj, ops2));
+	if (token && token->event) {
+		token->transaction_status = EFI_SUCCESS;
+		efi_signal_event(token->event);
+	}
+
+	return EFI_EXIT(EFI_SUCCESS);
+}
+
+static const struct efi_block_io2 block_io2_disk_template = {
+	.reset = &efi_disk_reset2,
+	.read_blocks_ex = &efi_disk_read_blocks_ex,
+	.write_blocks_ex = &efi_disk_write_blocks_ex,
+	.flush_blocks_ex = &efi_disk_flush_blocks_ex,
+};
+
 /**
  * efi_fs_from_path() - retrieve simple file system protocol
  *
@@ -497,7 +764,17 @@ static efi_status_t efi_disk_add_dev(
 			return ret;
 		}
 	}
+	if (IS_ENABLED(CONFIG_EFI_BLOCK_IO2_PROTOCOL)) {
+		ret = efi_add_protocol(&diskobj->header, &efi_block_io2_guid,
+				       &diskobj->ops2);
+		if (ret != EFI_SUCCESS) {
+			log_debug("block IO 2 failed\n");
+			return ret;
+		}
+	}
 	diskobj->ops = block_io_disk_template;
+	diskobj->ops2 = block_io2_disk_template;
+	diskobj->ops2.media = &diskobj->media;
 	diskobj->dev_index = dev_index;
 
 	/* Fill in EFI IO Media info (for read/write callbacks) */
@@ -709,12 +986,12 @@ static int efi_disk_delete_raw(struct udevice *dev)
 	if (dev_tag_get_ptr(dev, DM_TAG_EFI, (void **)&handle))
 		return -1;
 
+	diskobj = container_of(handle, struct efi_disk_obj, header);
 	desc = dev_get_uclass_plat(dev);
-	if (desc->uclass_id != UCLASS_EFI_LOADER) {
-		diskobj = container_of(handle, struct efi_disk_obj, header);
+	if (desc->uclass_id != UCLASS_EFI_LOADER)
 		efi_free_pool(diskobj->dp);
-	}
 
+	efi_io_cancel(diskobj);
 	efi_delete_handle(handle);
 	dev_tag_del(dev, DM_TAG_EFI);
 
@@ -742,6 +1019,7 @@ static int efi_disk_delete_part(struct udevice *dev)
 	diskobj = container_of(handle, struct efi_disk_obj, header);
 
 	efi_free_pool(diskobj->dp);
+	efi_io_cancel(diskobj);
 	efi_delete_handle(handle);
 	dev_tag_del(dev, DM_TAG_EFI);
 
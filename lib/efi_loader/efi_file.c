@@ -35,6 +35,9 @@ struct file_handle {
 	int isdir;
 	u64 open_mode;
 
+	/* for reading a file, opened on first read: */
+	struct fs_file *file;
+
 	/* for reading a directory: */
 	struct fs_dir_stream *dirs;
 	struct fs_dirent *dent;
@@ -364,7 +367,10 @@ out:
 
 static efi_status_t file_close(struct file_handle *fh)
 {
+	/* complete any asynchronous reads before the handle goes away */
+	efi_io_flush(fh);
 	fs_closedir(fh->dirs);
+	fs_file_close(fh->file);
 	free(fh);
 	return EFI_SUCCESS;
 }
@@ -389,6 +395,7 @@ static efi_status_t EFIAPI efi_file_delete(struct efi_file_handle *file)
 
 	EFI_ENTRY("%p", file);
 
+	efi_io_flush(fh);
 	if (set_blk_dev(fh) || fs_unlink(fh->path))
 		ret = EFI_WARN_DELETE_FAILURE;
 
@@ -458,26 +465,18 @@ static efi_status_t file_read(struct file_handle *fh, u64 *buffer_size,
 		void *buffer)
 {
 	loff_t actread;
-	efi_status_t ret;
-	loff_t file_size;
-
-	if (!buffer) {
-		ret = EFI_INVALID_PARAMETER;
-		return ret;
-	}
 
-	ret = efi_get_file_size(fh, &file_size);
-	if (ret != EFI_SUCCESS)
-		return ret;
-	if (file_size < fh->offset) {
-		ret = EFI_DEVICE_ERROR;
-		return ret;
-	}
+	if (!buffer)
+		return EFI_INVALID_PARAMETER;
 
-	if (set_blk_dev(fh))
+	/*
+	 * Keep the file open between reads, so that reading it in chunks does
+	 * not look up the partition and the path each time
+	 */
+	if (!fh->file &&
+	    (set_blk_dev(fh) || fs_file_open(fh->path, &fh->file)))
 		return EFI_DEVICE_ERROR;
-	if (fs_read(fh->path, map_to_sysmem(buffer), fh->offset,
-		    *buffer_size, &actread))
+	if (fs_file_read(fh->file, buffer, fh->offset, *buffer_size, &actread))
 		return EFI_DEVICE_ERROR;
 
 	*buffer_size = actread;
@@ -578,6 +577,7 @@ efi_status_t efi_file_read_int(struct efi_file_handle *this,
 	if (!this || !buffer_size)
 		return EFI_INVALID_PARAMETER;
 
+	efi_io_flush(fh);
 	bs = *buffer_size;
 	if (fh->isdir)
 		ret = dir_read(fh, &bs, buffer);
@@ -616,11 +616,58 @@ static efi_status_t EFIAPI efi_file_read(struct efi_file_handle *this,
 	return EFI_EXIT(ret);
 }
 
+/**
+ * struct efi_file_io - asynchronous read for ReadEx()
+ *
+ * @req:	I/O request
+ * @fh:		file handle to read from
+ * @token:	transaction token of the read
+ * @done:	number of bytes read so far
+ */
+struct efi_file_io {
+	struct efi_io_request req;
+	struct file_handle *fh;
+	struct efi_file_io_token *token;
+	u64 done;
+};
+
+/**
+ * efi_file_io_step() - read the next part of an asynchronous read
+ *
+ * @req:	I/O request of the read
+ * Return:	EFI_NOT_READY if there is more to read, else status code
+ */
+static efi_status_t efi_file_io_step(struct efi_io_request *req)
+{
+	struct efi_file_io *io = container_of(req, struct efi_file_io, req);
+	struct efi_file_io_token *token = io->token;
+	u64 size, want;
+	efi_status_t ret;
+
+	want = min_t(u64, token->buffer_size - io->done, EFI_IO_STEP_SIZE);
+	size = want;
+	if (size) {
+		ret = file_read(io->fh, &size, token->buffer + io->done);
+		if (ret != EFI_SUCCESS)
+			return ret;
+		io->done += size;
+	}
+	if (size == want && io->done < token->buffer_size)
+		return EFI_NOT_READY;
+	token->buffer_size = io->done;
+
+	return EFI_SUCCESS;
+}
+
 /**
  * efi_file_read_ex() - read file asynchonously
  *
  * This function implements the ReadEx() service of the EFI_FILE_PROTOCOL.
  *
+ * If the token has an event the read is queued and carried out a piece at a
+ * time while the application polls for events. The event is signalled when
+ * the read is complete.
+ *
  * See the Unified Extensible Firmware Interface (UEFI) specification for
  * details.
  *
@@ -631,21 +678,45 @@ static efi_status_t EFIAPI efi_file_read(struct efi_file_handle *this,
 static efi_status_t EFIAPI efi_file_read_ex(struct efi_file_handle *this,
 					    struct efi_file_io_token *token)
 {
+	struct file_handle *fh = to_fh(this);
+	struct efi_file_io *io;
 	efi_status_t ret;
 
 	EFI_ENTRY("%p, %p", this, token);
 
-	if (!token) {
+	if (!this || !token) {
 		ret = EFI_INVALID_PARAMETER;
 		goto out;
 	}
 
-	ret = efi_file_read_int(this, &token->buffer_size, token->buffer);
+	/* directory entries are read one at a time, so do that straight away */
+	if (!token->event || fh->isdir) {
+		ret = efi_file_read_int(this, &token->buffer_size,
+					token->buffer);
+		if (ret == EFI_SUCCESS && token->event) {
+			token->status = EFI_SUCCESS;
+			efi_signal_event(token->event);
+		}
+		goto out;
+	}
 
-	if (ret == EFI_SUCCESS && token->event) {
-		token->status = EFI_SUCCESS;
-		efi_signal_event(token->event);
+	if (!token->buffer) {
+		ret = EFI_INVALID_PARAMETER;
+		goto out;
+	}
+	io = calloc(1, sizeof(*io));
+	if (!io) {
+		ret = EFI_OUT_OF_RESOURCES;
+		goto out;
 	}
+	io->fh = fh;
+	io->token = token;
+	io->req.owner = fh;
+	io->req.step = efi_file_io_step;
+	io->req.event = token->event;
+	io->req.status = &token->status;
+	token->status = EFI_NOT_READY;
+	ret = efi_io_submit(&io->req);
 
 out:
 	return EFI_EXIT(ret);
@@ -662,6 +733,7 @@ static efi_status_t efi_file_write_int(struct efi_file_handle *this,
 		ret = EFI_INVALID_PARAMETER;
 		goto out;
 	}
+	efi_io_flush(fh);
 	if (fh->isdir) {
 		ret = EFI_UNSUPPORTED;
 		goto out;
@@ -774,6 +846,7 @@ static efi_status_t EFIAPI efi_file_getpos(struct efi_file_handle *file,
 		goto out;
 	}
 
+	efi_io_flush(fh);
 	*pos = fh->offset;
 out:
 	return EFI_EXIT(ret);
@@ -784,6 +857,7 @@ efi_status_t efi_file_setpos_int(struct efi_file_handle *file, u64 pos)
 	struct file_handle *fh = to_fh(file);
 	efi_status_t ret = EFI_SUCCESS;
 
+	efi_io_flush(fh);
 	if (fh->isdir) {
 		if (pos != 0) {
 			ret = EFI_UNSUPPORTED;
@@ -1013,6 +1087,7 @@ static efi_status_t efi_file_flush_int(struct efi_file_handle *this)
 	if (!this)
 		return EFI_INVALID_PARAMETER;
 
+	efi_io_flush(fh);
 	if (!(fh->open_mode & EFI_FILE_MODE_WRITE))
 		return EFI_ACCESS_DENIED;
 
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ *  EFI asynchronous I/O
+ *
+ *  Requests with an event are queued and carried out a step at a time from
+ *  efi_timer_check(), so that an application can get on with other work
+ *  while its I/O is in progress.
+ */
+
+#define LOG_CATEGORY LOGC_EFI
+
+#include <common.h>
+#include <efi_loader.h>
+#include <malloc.h>
+
+/* Queued requests, oldest first */
+static LIST_HEAD(efi_io_queue);
+
+/* Set while a step is in progress, as steps may call efi_timer_check() */
+static bool efi_io_busy;
+
+/**
+ * efi_io_complete() - report the status of a request and free it
+ *
+ * @req:	request
+ * @status:	final status of the request
+ */
+static void efi_io_complete(struct efi_io_request *req, efi_status_t status)
+{
+	list_del_init(&req->link);
+	if (req->status)
+		*req->status = status;
+	if (req->event)
+		efi_signal_event(req->event);
+	free(req);
+}
+
+/**
+ * efi_io_finish() - carry out all remaining steps of a request
+ *
+ * @req:	request, which must not be on the queue
+ * Return:	final status of the request
+ */
+static efi_status_t efi_io_finish(struct efi_io_request *req)
+{
+	bool busy = efi_io_busy;
+	efi_status_t ret;
+
+	efi_io_busy = true;
+	do {
+		ret = req->step(req);
+	} while (ret == EFI_NOT_READY);
+	efi_io_busy = busy;
+
+	return ret;
+}
+
+/**
+ * efi_io_find() - find the oldest queued request for an object
+ *
+ * @owner:	object, NULL for any
+ * Return:	request, which is removed from the queue, or NULL if none
+ */
+static struct efi_io_request *efi_io_find(void *owner)
+{
+	struct efi_io_request *req;
+
+	list_for_each_entry(req, &efi_io_queue, link) {
+		if (!owner || req->owner == owner) {
+			list_del_init(&req->link);
+			return req;
+		}
+	}
+
+	return NULL;
+}
+
+efi_status_t efi_io_submit(struct efi_io_request *req)
+{
+	efi_status_t ret;
+
+	INIT_LIST_HEAD(&req->link);
+	if (req->event) {
+		list_add_tail(&req->link, &efi_io_queue);
+		return EFI_SUCCESS;
+	}
+
+	/* blocking I/O must not overtake queued requests */
+	efi_io_flush(req->owner);
+	ret = efi_io_finish(req);
+	efi_io_complete(req, ret);
+
+	return ret;
+}
+
+void efi_io_poll(void)
+{
+	struct efi_io_request *req;
+	efi_status_t ret;
+
+	if (efi_io_busy || list_empty(&efi_io_queue))
+		return;
+
+	/*
+	 * Take the request off the queue while it runs, so that a flush from
+	 * an event notification function cannot run it a second time
+	 */
+	req = list_first_entry(&efi_io_queue, struct efi_io_request, link);
+	list_del_init(&req->link);
+	efi_io_busy = true;
+	ret = req->step(req);
+	efi_io_busy = false;
+	if (ret == EFI_NOT_READY)
+		list_add(&req->link, &efi_io_queue);
+	else
+		efi_io_complete(req, ret);
+}
+
+void efi_io_flush(void *owner)
+{
+	struct efi_io_request *req;
+
+	while ((req = efi_io_find(owner)))
+		efi_io_complete(req, efi_io_finish(req));
+}
+
+void efi_io_cancel(void *owner)
+{
+	struct efi_io_request *req;
+
+	while ((req = efi_io_find(owner)))
+		efi_io_complete(req, EFI_ABORTED);
+}
@@ -13,7 +13,7 @@
 #include <watchdog.h>
 #include <asm/cache.h>
 #include <asm/global_data.h>
-#include <linux/list_sort.h>
+#include <linux/rbtree_augmented.h>
 #include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -23,17 +23,25 @@ DECLARE_GLOBAL_DATA_PTR;
 
 efi_uintn_t efi_memory_map_key;
 
+/**
+ * struct efi_mem_list - entry of the memory map
+ *
+ * @node:	node in the tree of entries, sorted by address
+ * @desc:	memory descriptor
+ * @free_pages:	size of the largest area of free RAM in the subtree under
+ *		this node, in pages; used to find free memory quickly
+ */
 struct efi_mem_list {
-	struct list_head link;
+	struct rb_node node;
 	struct efi_mem_desc desc;
+	u64 free_pages;
 };
 
-#define EFI_CARVE_NO_OVERLAP		-1
-#define EFI_CARVE_LOOP_AGAIN		-2
-#define EFI_CARVE_OVERLAPS_NONRAM	-3
+/* This tree contains all memory map items, ordered by address */
+static struct rb_root efi_mem = RB_ROOT;
 
-/* This list contains all memory map items */
-LIST_HEAD(efi_mem);
+/* Number of entries in the memory map */
+static efi_uintn_t efi_mem_count;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 void *efi_bounce_buffer;
@@ -79,174 +87,219 @@ static u64 checksum(struct efi_pool_allocation *alloc)
 }
 
 /**
- * efi_mem_cmp() - comparator function for sorting memory map
- *
- * Sorts the memory list from highest address to lowest address
+ * desc_get_end() - get end address of memory area
  *
- * When allocating memory we should always start from the highest
- * address chunk, so sort the memory list such that the first list
- * iterator gets the highest address and goes lower from there.
+ * @desc:	memory descriptor
+ * Return:	end address + 1
+ */
+static uint64_t desc_get_end(struct efi_mem_desc *desc)
+{
+	return desc->physical_start + (desc->num_pages << EFI_PAGE_SHIFT);
+}
+
+/**
+ * efi_mem_compute_free() - compute the largest free area under a node
  *
- * @priv:	unused
- * @a:		first memory area
- * @b:		second memory area
- * Return:	1 if @a is before @b, -1 if @b is before @a, 0 if equal
+ * @mem:	memory map entry
+ * Return:	size of the largest area of free RAM in the subtree, in pages
  */
-static int efi_mem_cmp(void *priv, struct list_head *a, struct list_head *b)
+static u64 efi_mem_compute_free(struct efi_mem_list *mem)
 {
-	struct efi_mem_list *mema = list_entry(a, struct efi_mem_list, link);
-	struct efi_mem_list *memb = list_entry(b, struct efi_mem_list, link);
+	u64 free_pages = 0;
+
+	if (mem->desc.type == EFI_CONVENTIONAL_MEMORY)
+		free_pages = mem->desc.num_pages;
+	if (mem->node.rb_left)
+		free_pages = max(free_pages, rb_entry(mem->node.rb_left,
+				 struct efi_mem_list, node)->free_pages);
+	if (mem->node.rb_right)
+		free_pages = max(free_pages, rb_entry(mem->node.rb_right,
+				 struct efi_mem_list, node)->free_pages);
+
+	return free_pages;
+}
 
-	if (mema->desc.physical_start == memb->desc.physical_start)
-		return 0;
-	else if (mema->desc.physical_start < memb->desc.physical_start)
-		return 1;
-	else
-		return -1;
+RB_DECLARE_CALLBACKS(static, efi_mem_augment, struct efi_mem_list, node,
+		     u64, free_pages, efi_mem_compute_free)
+
+static struct efi_mem_list *efi_mem_next(struct efi_mem_list *mem)
+{
+	return rb_entry_safe(rb_next(&mem->node), struct efi_mem_list, node);
+}
+
+static struct efi_mem_list *efi_mem_prev(struct efi_mem_list *mem)
+{
+	return rb_entry_safe(rb_prev(&mem->node), struct efi_mem_list, node);
 }
 
 /**
- * desc_get_end() - get end address of memory area
+ * efi_mem_update() - update the tree after an entry has been resized
  *
- * @desc:	memory descriptor
- * Return:	end address + 1
+ * @mem:	memory map entry which has changed
  */
-static uint64_t desc_get_end(struct efi_mem_desc *desc)
+static void efi_mem_update(struct efi_mem_list *mem)
 {
-	return desc->physical_start + (desc->num_pages << EFI_PAGE_SHIFT);
+	efi_mem_augment_propagate(&mem->node, NULL);
 }
 
 /**
- * efi_mem_sort() - sort memory map
+ * efi_mem_find() - find the first memory map entry ending after an address
  *
- * Sort the memory map and then try to merge adjacent memory areas.
+ * As the entries do not overlap, this is the entry containing @addr, if
+ * there is one, else the next entry above @addr.
+ *
+ * @addr:	address
+ * Return:	memory map entry or NULL if there is none
  */
-static void efi_mem_sort(void)
+static struct efi_mem_list *efi_mem_find(u64 addr)
 {
-	struct list_head *lhandle;
-	struct efi_mem_list *prevmem = NULL;
-	bool merge_again = true;
-
-	list_sort(NULL, &efi_mem, efi_mem_cmp);
-
-	/* Now merge entries that can be merged */
-	while (merge_again) {
-		merge_again = false;
-		list_for_each(lhandle, &efi_mem) {
-			struct efi_mem_list *lmem;
-			struct efi_mem_desc *prev = &prevmem->desc;
-			struct efi_mem_desc *cur;
-			uint64_t pages;
-
-			lmem = list_entry(lhandle, struct efi_mem_list, link);
-			if (!prevmem) {
-				prevmem = lmem;
-				continue;
-			}
+	struct rb_node *rb = efi_mem.rb_node;
+	struct efi_mem_list *found = NULL;
 
-			cur = &lmem->desc;
-
-			if ((desc_get_end(cur) == prev->physical_start) &&
-			    (prev->type == cur->type) &&
-			    (prev->attribute == cur->attribute)) {
-				/* There is an existing map before, reuse it */
-				pages = cur->num_pages;
-				prev->num_pages += pages;
-				prev->physical_start -= pages << EFI_PAGE_SHIFT;
-				prev->virtual_start -= pages << EFI_PAGE_SHIFT;
-				list_del(&lmem->link);
-				free(lmem);
-
-				merge_again = true;
-				break;
-			}
+	while (rb) {
+		struct efi_mem_list *mem = rb_entry(rb, struct efi_mem_list,
+						    node);
 
-			prevmem = lmem;
+		if (addr < desc_get_end(&mem->desc)) {
+			found = mem;
+			rb = rb->rb_left;
+		} else {
+			rb = rb->rb_right;
 		}
 	}
+
+	return found;
 }
 
 /**
- * efi_mem_carve_out() - unmap memory region
+ * efi_mem_insert() - add an entry to the memory map
  *
- * @map:		memory map
- * @carve_desc:		memory region to unmap
- * @overlap_only_ram:	the carved out region may only overlap RAM
- * Return:		the number of overlapping pages which have been
- *			removed from the map,
- *			EFI_CARVE_NO_OVERLAP, if the regions don't overlap,
- *			EFI_CARVE_OVERLAPS_NONRAM, if the carve and map overlap,
- *			and the map contains anything but free ram
- *			(only when overlap_only_ram is true),
- *			EFI_CARVE_LOOP_AGAIN, if the mapping list should be
- *			traversed again, as it has been altered.
- *
- * Unmaps all memory occupied by the carve_desc region from the list entry
- * pointed to by map.
- *
- * In case of EFI_CARVE_OVERLAPS_NONRAM it is the callers responsibility
- * to re-add the already carved out pages to the mapping.
+ * @mem:	memory map entry, which must not overlap any other entry
  */
-static s64 efi_mem_carve_out(struct efi_mem_list *map,
-			     struct efi_mem_desc *carve_desc,
-			     bool overlap_only_ram)
+static void efi_mem_insert(struct efi_mem_list *mem)
 {
-	struct efi_mem_list *newmap;
-	struct efi_mem_desc *map_desc = &map->desc;
-	uint64_t map_start = map_desc->physical_start;
-	uint64_t map_end = map_start + (map_desc->num_pages << EFI_PAGE_SHIFT);
-	uint64_t carve_start = carve_desc->physical_start;
-	uint64_t carve_end = carve_start +
-			     (carve_desc->num_pages << EFI_PAGE_SHIFT);
-
-	/* check whether we're overlapping */
-	if ((carve_end <= map_start) || (carve_start >= map_end))
-		return EFI_CARVE_NO_OVERLAP;
-
-	/* We're overlapping with non-RAM, warn the caller if desired */
-	if (overlap_only_ram && (map_desc->type != EFI_CONVENTIONAL_MEMORY))
-		return EFI_CARVE_OVERLAPS_NONRAM;
-
-	/* Sanitize carve_start and carve_end to lie within our bounds */
-	carve_start = max(carve_start, map_start);
-	carve_end = min(carve_end, map_end);
-
-	/* Carving at the beginning of our map? Just move it! */
-	if (carve_start == map_start) {
-		if (map_end == carve_end) {
-			/* Full overlap, just remove map */
-			list_del(&map->link);
-			free(map);
-		} else {
-			map->desc.physical_start = carve_end;
-			map->desc.virtual_start = carve_end;
-			map->desc.num_pages = (map_end - carve_end)
-					      >> EFI_PAGE_SHIFT;
-		}
-
-		return (carve_end - carve_start) >> EFI_PAGE_SHIFT;
+	struct rb_node **link = &efi_mem.rb_node;
+	struct rb_node *parent = NULL;
+
+	while (*link) {
+		parent = *link;
+		if (mem->desc.physical_start <
+		    rb_entry(parent, struct efi_mem_list,
+			     node)->desc.physical_start)
+			link = &parent->rb_left;
+		else
+			link = &parent->rb_right;
 	}
+	rb_link_node(&mem->node, parent, link);
+	mem->free_pages = efi_mem_compute_free(mem);
+	efi_mem_augment_propagate(parent, NULL);
+	rb_insert_augmented(&mem->node, &efi_mem, &efi_mem_augment);
+	efi_mem_count++;
+}
 
-	/*
-	 * Overlapping maps, just split the list map at carve_start,
-	 * it will get moved or removed in the next iteration.
-	 *
-	 * [ map_desc |__carve_start__| newmap ]
-	 */
+/**
+ * efi_mem_remove() - remove an entry from the memory map and free it
+ *
+ * @mem:	memory map entry
+ */
+static void efi_mem_remove(struct efi_mem_list *mem)
+{
+	rb_erase_augmented(&mem->node, &efi_mem, &efi_mem_augment);
+	efi_mem_count--;
+	free(mem);
+}
 
-	/* Create a new map from [ carve_start ... map_end ] */
-	newmap = calloc(1, sizeof(*newmap));
-	newmap->desc = map->desc;
-	newmap->desc.physical_start = carve_start;
-	newmap->desc.virtual_start = carve_start;
-	newmap->desc.num_pages = (map_end - carve_start) >> EFI_PAGE_SHIFT;
-	/* Insert before current entry (descending address order) */
-	list_add_tail(&newmap->link, &map->link);
+/**
+ * efi_mem_can_merge() - check if two memory areas can be merged
+ *
+ * @lower:	lower memory area
+ * @upper:	upper memory area
+ * Return:	true if @upper directly follows @lower and both have the same
+ *		type and attributes
+ */
+static bool efi_mem_can_merge(struct efi_mem_desc *lower,
+			      struct efi_mem_desc *upper)
+{
+	return desc_get_end(lower) == upper->physical_start &&
+	       lower->type == upper->type &&
+	       lower->attribute == upper->attribute;
+}
+
+/**
+ * efi_mem_merge() - merge a memory map entry with its neighbours
+ *
+ * As each change merges the entries it touches, adjacent entries which could
+ * be merged can only arise next to the entry that was added.
+ *
+ * @mem:	memory map entry
+ */
+static void efi_mem_merge(struct efi_mem_list *mem)
+{
+	struct efi_mem_list *prev = efi_mem_prev(mem);
+	struct efi_mem_list *next = efi_mem_next(mem);
 
-	/* Shrink the map to [ map_start ... carve_start ] */
-	map_desc->num_pages = (carve_start - map_start) >> EFI_PAGE_SHIFT;
+	if (next && efi_mem_can_merge(&mem->desc, &next->desc)) {
+		mem->desc.num_pages += next->desc.num_pages;
+		efi_mem_remove(next);
+		efi_mem_update(mem);
+	}
+	if (prev && efi_mem_can_merge(&prev->desc, &mem->desc)) {
+		prev->desc.num_pages += mem->desc.num_pages;
+		efi_mem_remove(mem);
+		efi_mem_update(prev);
+	}
+}
 
-	return EFI_CARVE_LOOP_AGAIN;
+/**
+ * efi_mem_carve_out() - unmap memory region
+ *
+ * Removes the range [@start, @end) from all entries of the memory map.
+ * Entries overlapping the range are shrunk or removed. An entry which
+ * extends on both sides of the range is split in two, using @split for the
+ * upper part.
+ *
+ * @start:	start address of the region
+ * @end:	end address of the region
+ * @split:	spare entry, needed if an entry extends on both sides of the
+ *		region
+ */
+static void efi_mem_carve_out(u64 start, u64 end,
+			      struct efi_mem_list *split)
+{
+	struct efi_mem_list *mem, *next;
+
+	for (mem = efi_mem_find(start);
+	     mem && mem->desc.physical_start < end; mem = next) {
+		struct efi_mem_desc *desc = &mem->desc;
+		u64 map_start = desc->physical_start;
+		u64 map_end = desc_get_end(desc);
+
+		next = efi_mem_next(mem);
+		if (map_start < start) {
+			/* Keep [ map_start ... start ] */
+			desc->num_pages = (start - map_start) >> EFI_PAGE_SHIFT;
+			efi_mem_update(mem);
+			if (map_end > end) {
+				/* and [ end ... map_end ] */
+				split->desc = *desc;
+				split->desc.physical_start = end;
+				split->desc.virtual_start = end;
+				split->desc.num_pages = (map_end - end) >>
+							EFI_PAGE_SHIFT;
+				efi_mem_insert(split);
+				return;
+			}
+		} else if (map_end > end) {
+			/* Carving at the beginning of our map? Just move it! */
+			desc->physical_start = end;
+			desc->virtual_start = end;
+			desc->num_pages = (map_end - end) >> EFI_PAGE_SHIFT;
+			efi_mem_update(mem);
+		} else {
+			/* Full overlap, just remove map */
+			efi_mem_remove(mem);
+		}
+	}
 }
 
 /**
@@ -262,10 +315,8 @@ static efi_status_t efi_add_memory_map_pg(u64 start, u64 pages,
 					  int memory_type,
 					  bool overlap_only_ram)
 {
-	struct list_head *lhandle;
-	struct efi_mem_list *newlist;
-	bool carve_again;
-	uint64_t carved_pages = 0;
+	struct efi_mem_list *newlist, *mem, *split = NULL;
+	u64 end = start + (pages << EFI_PAGE_SHIFT);
 	struct efi_event *evt;
 
 	EFI_PRINT("%s: 0x%llx 0x%llx %d %s\n", __func__,
@@ -278,7 +329,31 @@ static efi_status_t efi_add_memory_map_pg(u64 start, u64 pages,
 		return EFI_SUCCESS;
 
 	++efi_memory_map_key;
+
+	if (overlap_only_ram) {
+		u64 ram_pages = 0;
+
+		/*
+		 * The user requested to only have RAM overlaps, so the whole
+		 * region must lie within free RAM. Check this before changing
+		 * anything.
+		 */
+		for (mem = efi_mem_find(start);
+		     mem && mem->desc.physical_start < end;
+		     mem = efi_mem_next(mem)) {
+			if (mem->desc.type != EFI_CONVENTIONAL_MEMORY)
+				return EFI_NO_MAPPING;
+			ram_pages += (min(end, desc_get_end(&mem->desc)) -
+				      max(start, mem->desc.physical_start)) >>
+				     EFI_PAGE_SHIFT;
+		}
+		if (ram_pages != pages)
+			return EFI_NO_MAPPING;
+	}
+
 	newlist = calloc(1, sizeof(*newlist));
+	if (!newlist)
+		return EFI_OUT_OF_RESOURCES;
 	newlist->desc.type = memory_type;
 	newlist->desc.physical_start = start;
 	newlist->desc.virtual_start = start;
@@ -297,60 +372,21 @@ static efi_status_t efi_add_memory_map_pg(u64 start, u64 pages,
 		break;
 	}
 
-	/* Add our new map */
-	do {
-		carve_again = false;
-		list_for_each(lhandle, &efi_mem) {
-			struct efi_mem_list *lmem;
-			s64 r;
-
-			lmem = list_entry(lhandle, struct efi_mem_list, link);
-			r = efi_mem_carve_out(lmem, &newlist->desc,
-					      overlap_only_ram);
-			switch (r) {
-			case EFI_CARVE_OVERLAPS_NONRAM:
-				/*
-				 * The user requested to only have RAM overlaps,
-				 * but we hit a non-RAM region. Error out.
-				 */
-				return EFI_NO_MAPPING;
-			case EFI_CARVE_NO_OVERLAP:
-				/* Just ignore this list entry */
-				break;
-			case EFI_CARVE_LOOP_AGAIN:
-				/*
-				 * We split an entry, but need to loop through
-				 * the list again to actually carve it.
-				 */
-				carve_again = true;
-				break;
-			default:
-				/* We carved a number of pages */
-				carved_pages += r;
-				carve_again = true;
-				break;
-			}
-
-			if (carve_again) {
-				/* The list changed, we need to start over */
-				break;
-			}
+	/* An entry extending on both sides of the new one is split in two */
+	mem = efi_mem_find(start);
+	if (mem && mem->desc.physical_start < start &&
+	    desc_get_end(&mem->desc) > end) {
+		split = calloc(1, sizeof(*split));
+		if (!split) {
+			free(newlist);
+			return EFI_OUT_OF_RESOURCES;
 		}
-	} while (carve_again);
-
-	if (overlap_only_ram && (carved_pages != pages)) {
-		/*
-		 * The payload wanted to have RAM overlaps, but we overlapped
-		 * with an unallocated region. Error out.
-		 */
-		return EFI_NO_MAPPING;
 	}
 
 	/* Add our new map */
-        list_add_tail(&newlist->link, &efi_mem);
-
-	/* And make sure memory is listed in descending order */
-	efi_mem_sort();
+	efi_mem_carve_out(start, end, split);
+	efi_mem_insert(newlist);
+	efi_mem_merge(newlist);
 
 	/* Notify that the memory map was changed */
 	list_for_each_entry(evt, &efi_events, link) {
@@ -404,22 +440,57 @@ efi_status_t efi_add_memory_map(u64 start, u64 size, int memory_type)
  */
 static efi_status_t efi_check_allocated(u64 addr, bool must_be_allocated)
 {
-	struct efi_mem_list *item;
-
-	list_for_each_entry(item, &efi_mem, link) {
-		u64 start = item->desc.physical_start;
-		u64 end = start + (item->desc.num_pages << EFI_PAGE_SHIFT);
-
-		if (addr >= start && addr < end) {
-			if (must_be_allocated ^
-			    (item->desc.type == EFI_CONVENTIONAL_MEMORY))
-				return EFI_SUCCESS;
-			else
-				return EFI_NOT_FOUND;
+	struct efi_mem_list *item = efi_mem_find(addr);
+
+	if (!item || addr < item->desc.physical_start)
+		return EFI_NOT_FOUND;
+
+	if (must_be_allocated ^ (item->desc.type == EFI_CONVENTIONAL_MEMORY))
+		return EFI_SUCCESS;
+	else
+		return EFI_NOT_FOUND;
+}
+
+/**
+ * efi_mem_find_free() - find free memory pages in a subtree
+ *
+ * The subtree is searched from the highest address down, skipping subtrees
+ * without a large enough area of free RAM.
+ *
+ * @rb:		root of the subtree
+ * @len:	size of memory area needed
+ * @max_addr:	highest address to allocate, page aligned
+ * Return:	pointer to free memory area or 0
+ */
+static u64 efi_mem_find_free(struct rb_node *rb, u64 len, u64 max_addr)
+{
+	struct efi_mem_list *mem;
+	u64 ret;
+
+	if (!rb)
+		return 0;
+	mem = rb_entry(rb, struct efi_mem_list, node);
+	if ((mem->free_pages << EFI_PAGE_SHIFT) < len)
+		return 0;
+
+	/* This entry and all above it are out of bounds for max_addr */
+	if (mem->desc.physical_start < max_addr) {
+		ret = efi_mem_find_free(rb->rb_right, len, max_addr);
+		if (ret)
+			return ret;
+
+		/* We only take memory from free RAM */
+		if (mem->desc.type == EFI_CONVENTIONAL_MEMORY) {
+			u64 curmax = min(max_addr, desc_get_end(&mem->desc));
+
+			/* Return the highest address in this map within bounds */
+			if (curmax >= len &&
+			    curmax - len >= mem->desc.physical_start)
+				return curmax - len;
 		}
 	}
 
-	return EFI_NOT_FOUND;
+	return efi_mem_find_free(rb->rb_left, len, max_addr);
 }
 
 /**
@@ -431,44 +502,13 @@ static efi_status_t efi_check_allocated(u64 addr, bool must_be_allocated)
  */
 static uint64_t efi_find_free_memory(uint64_t len, uint64_t max_addr)
 {
-	struct list_head *lhandle;
-
 	/*
 	 * Prealign input max address, so we simplify our matching
 	 * logic below and can just reuse it as return pointer.
 	 */
 	max_addr &= ~EFI_PAGE_MASK;
 
-	list_for_each(lhandle, &efi_mem) {
-		struct efi_mem_list *lmem = list_entry(lhandle,
-			struct efi_mem_list, link);
-		struct efi_mem_desc *desc = &lmem->desc;
-		uint64_t desc_len = desc->num_pages << EFI_PAGE_SHIFT;
-		uint64_t desc_end = desc->physical_start + desc_len;
-		uint64_t curmax = min(max_addr, desc_end);
-		uint64_t ret = curmax - len;
-
-		/* We only take memory from free RAM */
-		if (desc->type != EFI_CONVENTIONAL_MEMORY)
-			continue;
-
-		/* Out of bounds for max_addr */
-		if ((ret + len) > max_addr)
-			continue;
-
-		/* Out of bounds for upper map limit */
-		if ((ret + len) > desc_end)
-			continue;
-
-		/* Out of bounds for lower map limit */
-		if (ret < desc->physical_start)
-			continue;
-
-		/* Return the highest address in this map within bounds */
-		return ret;
-	}
-
-	return 0;
+	return efi_mem_find_free(efi_mem.rb_node, len, max_addr);
 }
 
 /**
@@ -724,8 +764,8 @@ efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
 				uint32_t *descriptor_version)
 {
 	efi_uintn_t map_size = 0;
-	int map_entries = 0;
-	struct list_head *lhandle;
+	efi_uintn_t map_entries = efi_mem_count;
+	struct rb_node *rb;
 	efi_uintn_t provided_map_size;
 
 	if (!memory_map_size)
@@ -733,9 +773,6 @@ efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
 
 	provided_map_size = *memory_map_size;
 
-	list_for_each(lhandle, &efi_mem)
-		map_entries++;
-
 	map_size = map_entries * sizeof(struct efi_mem_desc);
 
 	*memory_map_size = map_size;
@@ -752,16 +789,9 @@ efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
 	if (!memory_map)
 		return EFI_INVALID_PARAMETER;
 
-	/* Copy list into array */
-	/* Return the list in ascending order */
-	memory_map = &memory_map[map_entries - 1];
-	list_for_each(lhandle, &efi_mem) {
-		struct efi_mem_list *lmem;
-
-		lmem = list_entry(lhandle, struct efi_mem_list, link);
-		*memory_map = lmem->desc;
-		memory_map--;
-	}
+	/* Copy tree into array, in ascending order */
+	for (rb = rb_first(&efi_mem); rb; rb = rb_next(rb))
+		*memory_map++ = rb_entry(rb, struct efi_mem_list, node)->desc;
 
 	if (map_key)
 		*map_key = efi_memory_map_key;
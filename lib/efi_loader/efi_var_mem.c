@@ -8,16 +8,77 @@
 #include <common.h>
 #include <efi_loader.h>
 #include <efi_variable.h>
+#include <linux/log2.h>
 #include <u-boot/crc.h>
 
+/**
+ * struct efi_var_slot - slot of the variable index
+ *
+ * @offset:	offset of the variable from the start of efi_var_buf,
+ *		0 for an empty slot
+ * @hash:	hash of the GUID and name of the variable
+ */
+struct efi_var_slot {
+	u32 offset;
+	u32 hash;
+};
+
 /*
- * The variables efi_var_file and efi_var_entry must be static to avoid
- * referencing them via the global offset table (section .got). The GOT
- * is neither mapped as EfiRuntimeServicesData nor do we support its
- * relocation during SetVirtualAddressMap().
+ * The variables efi_var_buf, efi_var_index and efi_var_index_mask must be
+ * static to avoid referencing them via the global offset table (section
+ * .got). The GOT is neither mapped as EfiRuntimeServicesData nor do we
+ * support its relocation during SetVirtualAddressMap().
+ *
+ * efi_var_index is an open addressing hash table with linear probing. It
+ * holds offsets rather than pointers, so that only the pointer to the table
+ * itself has to be converted by SetVirtualAddressMap().
  */
 static struct efi_var_file __efi_runtime_data *efi_var_buf;
-static struct efi_var_entry __efi_runtime_data *efi_current_var;
+static struct efi_var_slot __efi_runtime_data *efi_var_index;
+static u32 __efi_runtime_data efi_var_index_mask;
+
+/**
+ * efi_var_mem_hash() - hash GUID and name of a variable
+ *
+ * This is the 32 bit FNV-1a hash over the GUID and the name without the
+ * terminating NUL.
+ *
+ * @guid:	GUID of the variable
+ * @name:	name of the variable
+ * Return:	hash value
+ */
+static u32 __efi_runtime efi_var_mem_hash(const efi_guid_t *guid,
+					  const u16 *name)
+{
+	const u8 *pos = (const u8 *)guid;
+	u32 hash = 2166136261U;
+	int i;
+
+	for (i = 0; i < sizeof(efi_guid_t); ++i)
+		hash = (hash ^ pos[i]) * 16777619U;
+	for (; *name; ++name)
+		hash = (hash ^ *name) * 16777619U;
+
+	return hash;
+}
+
+/**
+ * efi_var_mem_next() - get the variable following a variable in the buffer
+ *
+ * @var:	variable
+ * Return:	next variable, or end of the buffer
+ */
+static struct efi_var_entry __efi_runtime
+*efi_var_mem_next(struct efi_var_entry *var)
+{
+	u16 *data;
+
+	for (data = var->name; *data; ++data)
+		;
+	++data;
+
+	return (struct efi_var_entry *)ALIGN((uintptr_t)data + var->length, 8);
+}
 
 /**
  * efi_var_mem_compare() - compare GUID and name with a variable
@@ -25,41 +86,118 @@ static struct efi_var_entry __efi_runtime_data *efi_current_var;
  * @var:	variable to compare
  * @guid:	GUID to compare
  * @name:	variable name to compare
- * @next:	pointer to next variable
  * Return:	true if match
  */
 static bool __efi_runtime
 efi_var_mem_compare(struct efi_var_entry *var, const efi_guid_t *guid,
-		    const u16 *name, struct efi_var_entry **next)
+		    const u16 *name)
 {
 	int i;
 	u8 *guid1, *guid2;
-	const u16 *data, *var_name;
-	bool match = true;
+	const u16 *data;
 
 	for (guid1 = (u8 *)&var->guid, guid2 = (u8 *)guid, i = 0;
-	     i < sizeof(efi_guid_t) && match; ++i)
-		match = (guid1[i] == guid2[i]);
+	     i < sizeof(efi_guid_t); ++i) {
+		if (guid1[i] != guid2[i])
+			return false;
+	}
 
-	for (data = var->name, var_name = name;; ++data) {
-		if (match)
-			match = (*data == *var_name);
+	for (data = var->name; *data == *name; ++data, ++name) {
 		if (!*data)
-			break;
-		if (*var_name)
-			++var_name;
+			return true;
 	}
 
-	++data;
+	return false;
+}
 
-	if (next)
-		*next = (struct efi_var_entry *)
-			ALIGN((uintptr_t)data + var->length, 8);
+/**
+ * efi_var_index_add() - add a variable to the index
+ *
+ * The index has at least twice as many slots as the buffer can hold
+ * variables, so there always is a free slot.
+ *
+ * @var:	variable in efi_var_buf
+ * @hash:	hash of GUID and name of the variable
+ */
+static void __efi_runtime efi_var_index_add(struct efi_var_entry *var,
+					    u32 hash)
+{
+	u32 slot;
+
+	for (slot = hash & efi_var_index_mask; efi_var_index[slot].offset;
+	     slot = (slot + 1) & efi_var_index_mask)
+		;
+	efi_var_index[slot].offset = (uintptr_t)var - (uintptr_t)efi_var_buf;
+	efi_var_index[slot].hash = hash;
+}
+
+/**
+ * efi_var_index_find() - find the slot of a variable in the index
+ *
+ * @offset:	offset of the variable as recorded in the index
+ * @hash:	hash of GUID and name of the variable
+ * @slotp:	returns the slot
+ * Return:	true if found
+ */
+static bool __efi_runtime efi_var_index_find(u32 offset, u32 hash, u32 *slotp)
+{
+	u32 slot;
+
+	for (slot = hash & efi_var_index_mask; efi_var_index[slot].offset;
+	     slot = (slot + 1) & efi_var_index_mask) {
+		if (efi_var_index[slot].hash == hash &&
+		    efi_var_index[slot].offset == offset) {
+			*slotp = slot;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * efi_var_index_del() - remove a variable from the index
+ *
+ * Entries following the slot in the same cluster are moved back, so that no
+ * lookup stops early at the emptied slot.
+ *
+ * @var:	variable in efi_var_buf
+ */
+static void __efi_runtime efi_var_index_del(struct efi_var_entry *var)
+{
+	u32 offset = (uintptr_t)var - (uintptr_t)efi_var_buf;
+	u32 slot, next, home;
 
-	if (match)
-		efi_current_var = var;
+	if (!efi_var_index_find(offset, efi_var_mem_hash(&var->guid, var->name),
+				&slot))
+		return;
 
-	return match;
+	for (next = (slot + 1) & efi_var_index_mask; efi_var_index[next].offset;
+	     next = (next + 1) & efi_var_index_mask) {
+		home = efi_var_index[next].hash & efi_var_index_mask;
+		/* move the entry unless its home slot lies in (slot, next] */
+		if (((next - home) & efi_var_index_mask) >=
+		    ((next - slot) & efi_var_index_mask)) {
+			efi_var_index[slot] = efi_var_index[next];
+			slot = next;
+		}
+	}
+	efi_var_index[slot].offset = 0;
+}
+
+/**
+ * efi_var_index_rebuild() - fill the index from the contents of efi_var_buf
+ */
+static void efi_var_index_rebuild(void)
+{
+	struct efi_var_entry *var, *last;
+
+	memset(efi_var_index, '\0',
+	       (efi_var_index_mask + 1) * sizeof(struct efi_var_slot));
+	last = (struct efi_var_entry *)
+	       ((uintptr_t)efi_var_buf + efi_var_buf->length);
+	for (var = efi_var_buf->var; var < last; var = efi_var_mem_next(var))
+		efi_var_index_add(var, efi_var_mem_hash(&var->guid, var->name));
 }
 
 struct efi_var_entry __efi_runtime
@@ -67,6 +205,7 @@ struct efi_var_entry __efi_runtime
 		  struct efi_var_entry **next)
 {
 	struct efi_var_entry *var, *last;
+	u32 hash, slot;
 
 	last = (struct efi_var_entry *)
 	       ((uintptr_t)efi_var_buf + efi_var_buf->length);
@@ -79,29 +218,22 @@ struct efi_var_entry __efi_runtime
 		}
 		return NULL;
 	}
-	if (efi_current_var &&
-	    efi_var_mem_compare(efi_current_var, guid, name, next)) {
-		if (next && *next >= last)
-			*next = NULL;
-		return efi_current_var;
-	}
 
-	var = efi_var_buf->var;
-	if (var < last) {
-		for (; var;) {
-			struct efi_var_entry *pos;
-			bool match;
-
-			match = efi_var_mem_compare(var, guid, name, &pos);
-			if (pos >= last)
-				pos = NULL;
-			if (match) {
-				if (next)
-					*next = pos;
-				return var;
-			}
-			var = pos;
+	hash = efi_var_mem_hash(guid, name);
+	for (slot = hash & efi_var_index_mask; efi_var_index[slot].offset;
+	     slot = (slot + 1) & efi_var_index_mask) {
+		if (efi_var_index[slot].hash != hash)
+			continue;
+		var = (struct efi_var_entry *)
+		      ((uintptr_t)efi_var_buf + efi_var_index[slot].offset);
+		if (!efi_var_mem_compare(var, guid, name))
+			continue;
+		if (next) {
+			*next = efi_var_mem_next(var);
+			if (*next >= last)
+				*next = NULL;
 		}
+		return var;
 	}
 	if (next)
 		*next = NULL;
@@ -110,29 +242,39 @@ struct efi_var_entry __efi_runtime
 
 void __efi_runtime efi_var_mem_del(struct efi_var_entry *var)
 {
-	u16 *data;
 	struct efi_var_entry *next, *last;
+	u32 offset, size, slot, hash;
 
 	if (!var)
 		return;
 
 	last = (struct efi_var_entry *)
 	       ((uintptr_t)efi_var_buf + efi_var_buf->length);
-	if (var <= efi_current_var)
-		efi_current_var = NULL;
+	efi_var_index_del(var);
 
-	for (data = var->name; *data; ++data)
-		;
-	++data;
-	next = (struct efi_var_entry *)
-	       ALIGN((uintptr_t)data + var->length, 8);
-	efi_var_buf->length -= (uintptr_t)next - (uintptr_t)var;
+	next = efi_var_mem_next(var);
+	offset = (uintptr_t)var - (uintptr_t)efi_var_buf;
+	size = (uintptr_t)next - (uintptr_t)var;
+	efi_var_buf->length -= size;
 
 	/* efi_memcpy_runtime() can be used because next >= var. */
 	efi_memcpy_runtime(var, next, (uintptr_t)last - (uintptr_t)next);
 	efi_var_buf->crc32 = crc32(0, (u8 *)efi_var_buf->var,
 				   efi_var_buf->length -
 				   sizeof(struct efi_var_file));
+
+	/*
+	 * The variables after the deleted one have moved down. Offsets are
+	 * unique, so an entry already moved cannot be mistaken for a later one.
+	 */
+	last = (struct efi_var_entry *)
+	       ((uintptr_t)efi_var_buf + efi_var_buf->length);
+	for (; var < last; var = efi_var_mem_next(var)) {
+		offset = (uintptr_t)var - (uintptr_t)efi_var_buf;
+		hash = efi_var_mem_hash(&var->guid, var->name);
+		if (efi_var_index_find(offset + size, hash, &slot))
+			efi_var_index[slot].offset = offset;
+	}
 }
 
 efi_status_t __efi_runtime efi_var_mem_ins(
@@ -164,6 +306,7 @@ efi_status_t __efi_runtime efi_var_mem_ins(
 			   sizeof(u16) * var_name_len);
 	efi_memcpy_runtime(data, data1, size1);
 	efi_memcpy_runtime((u8 *)data + size1, data2, size2);
+	efi_var_index_add(var, efi_var_mem_hash(vendor, variable_name));
 
 	var = (struct efi_var_entry *)
 	      ALIGN((uintptr_t)data + var->length, 8);
@@ -196,14 +339,8 @@ static void efi_var_mem_bs_del(void)
 		if (var >= last)
 			break;
 		if (var->attr & EFI_VARIABLE_RUNTIME_ACCESS) {
-			u16 *data;
-
 			/* skip variable */
-			for (data = var->name; *data; ++data)
-				;
-			++data;
-			var = (struct efi_var_entry *)
-			      ALIGN((uintptr_t)data + var->length, 8);
+			var = efi_var_mem_next(var);
 		} else {
 			/* delete variable */
 			efi_var_mem_del(var);
@@ -238,12 +375,13 @@ static void EFIAPI __efi_runtime
 efi_var_mem_notify_virtual_address_map(struct efi_event *event, void *context)
 {
 	efi_convert_pointer(0, (void **)&efi_var_buf);
-	efi_current_var = NULL;
+	efi_convert_pointer(0, (void **)&efi_var_index);
 }
 
 efi_status_t efi_var_mem_init(void)
 {
 	u64 memory;
+	u32 slots;
 	efi_status_t ret;
 	struct efi_event *event;
 
@@ -260,6 +398,20 @@ efi_status_t efi_var_mem_init(void)
 			      (uintptr_t)efi_var_buf;
 	/* crc32 for 0 bytes = 0 */
 
+	/* the smallest variable has a one character name and no data */
+	slots = roundup_pow_of_two(2 * EFI_VAR_BUF_SIZE /
+				   (sizeof(struct efi_var_entry) + 8));
+	ret = efi_allocate_pages(EFI_ALLOCATE_ANY_PAGES,
+				 EFI_RUNTIME_SERVICES_DATA,
+				 efi_size_in_pages(slots *
+						   sizeof(struct efi_var_slot)),
+				 &memory);
+	if (ret != EFI_SUCCESS)
+		return ret;
+	efi_var_index = (struct efi_var_slot *)(uintptr_t)memory;
+	efi_var_index_mask = slots - 1;
+	efi_var_index_rebuild();
+
 	ret = efi_create_event(EVT_SIGNAL_EXIT_BOOT_SERVICES, TPL_CALLBACK,
 			       efi_var_mem_notify_exit_boot_services, NULL,
 			       NULL, &event);
@@ -350,4 +502,5 @@ efi_get_next_variable_name_mem(efi_uintn_t *variable_name_size,
 void efi_var_buf_update(struct efi_var_file *var_buf)
 {
 	memcpy(efi_var_buf, var_buf, EFI_VAR_BUF_SIZE);
+	efi_var_index_rebuild();
 }
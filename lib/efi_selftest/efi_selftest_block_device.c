@@ -12,7 +12,8 @@
  * file protocol.
  * A known file is read from the file system and verified.
  * The same block is read via the EFI_BLOCK_IO_PROTOCOL and compared to the file
- * contents.
+ * contents. The block and the file are read once more, asynchronously, via the
+ * EFI_BLOCK_IO2_PROTOCOL and ReadEx().
  */
 
 #include <efi_selftest.h>
@@ -28,6 +29,8 @@
 static struct efi_boot_services *boottime;
 
 static const efi_guid_t block_io_protocol_guid = EFI_BLOCK_IO_PROTOCOL_GUID;
+static const efi_guid_t __maybe_unused block_io2_protocol_guid =
+	EFI_BLOCK_IO2_PROTOCOL_GUID;
 static const efi_guid_t guid_device_path = EFI_DEVICE_PATH_PROTOCOL_GUID;
 static const efi_guid_t guid_simple_file_system_protocol =
 					EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_GUID;
@@ -291,6 +294,27 @@ static efi_uintn_t dp_size(struct efi_device_path *dp)
 	return (char *)pos - (char *)dp;
 }
 
+/*
+ * Wait for an asynchronous transfer to complete.
+ *
+ * @event:	event signalled on completion
+ * Return:	status code of CheckEvent()
+ */
+static efi_status_t wait_for_io(struct efi_event *event)
+{
+	efi_status_t ret;
+	int i;
+
+	/* CheckEvent() drives the transfer, a step each time */
+	for (i = 0; i < 1000; ++i) {
+		ret = boottime->check_event(event);
+		if (ret != EFI_NOT_READY)
+			break;
+	}
+
+	return ret;
+}
+
 /*
  * Execute unit test.
  *
@@ -304,6 +328,10 @@ static int execute(void)
 	efi_handle_t handle_partition = NULL;
 	struct efi_device_path *dp_partition;
 	struct efi_block_io *block_io_protocol;
+	struct efi_block_io2 *block_io2_protocol __maybe_unused;
+	struct efi_block_io2_token token2 __maybe_unused;
+	struct efi_file_io_token token;
+	struct efi_event *event;
 	struct efi_simple_file_system_protocol *file_system;
 	struct efi_file_handle *root, *file;
 	struct {
@@ -476,6 +504,85 @@ static int execute(void)
 		return EFI_ST_FAILURE;
 	}
 
+	ret = boottime->create_event(0, TPL_CALLBACK, NULL, NULL, &event);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to create event\n");
+		return EFI_ST_FAILURE;
+	}
+
+#ifdef CONFIG_EFI_BLOCK_IO2_PROTOCOL
+	/* Read the same block asynchronously */
+	ret = boottime->open_protocol(handle_partition,
+				      &block_io2_protocol_guid,
+				      (void **)&block_io2_protocol, NULL, NULL,
+				      EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open block IO 2 protocol\n");
+		return EFI_ST_FAILURE;
+	}
+	boottime->set_mem(block_io_aligned, sizeof(block_io_aligned), 0);
+	token2.event = event;
+	ret = block_io2_protocol->read_blocks_ex(block_io2_protocol,
+				block_io2_protocol->media->media_id,
+				(0x5000 >> LB_BLOCK_SIZE) - 1, &token2,
+				block_io2_protocol->media->block_size,
+				block_io_aligned);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("ReadBlocksEx failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (wait_for_io(event) != EFI_SUCCESS ||
+	    token2.transaction_status != EFI_SUCCESS) {
+		efi_st_error("ReadBlocksEx did not complete\n");
+		return EFI_ST_FAILURE;
+	}
+	if (memcmp(block_io_aligned + 1, buf, 11)) {
+		efi_st_error("Unexpected block content\n");
+		return EFI_ST_FAILURE;
+	}
+#endif
+
+	/* Read the file asynchronously */
+	ret = root->open(root, &file, u"hello.txt", EFI_FILE_MODE_READ,
+			 0);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open file\n");
+		return EFI_ST_FAILURE;
+	}
+	boottime->set_mem(buf, sizeof(buf), 0);
+	token.event = event;
+	token.buffer_size = sizeof(buf) - 1;
+	token.buffer = buf;
+	ret = file->read_ex(file, &token);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("ReadEx failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (wait_for_io(event) != EFI_SUCCESS ||
+	    token.status != EFI_SUCCESS) {
+		efi_st_error("ReadEx did not complete\n");
+		return EFI_ST_FAILURE;
+	}
+	if (token.buffer_size != 13) {
+		efi_st_error("Wrong number of bytes read: %u\n",
+			     (unsigned int)token.buffer_size);
+		return EFI_ST_FAILURE;
+	}
+	if (memcmp(buf, "Hello world!", 12)) {
+		efi_st_error("Unexpected file content\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = file->close(file);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to close file\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = boottime->close_event(event);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to close event\n");
+		return EFI_ST_FAILURE;
+	}
+
 #ifdef CONFIG_FAT_WRITE
 	/* Write file */
 	ret = root->open(root, &file, u"u-boot.txt", EFI_FILE_MODE_READ |
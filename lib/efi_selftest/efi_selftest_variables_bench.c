@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * efi_selftest_variables_bench
+ *
+ * This unit test measures the cost of GetVariable and SetVariable with many
+ * variables in the store. It creates a set of variables and then counts the
+ * number of calls that can be made during a fixed time for the first
+ * variable created, for the last one, and for a variable that does not
+ * exist. With an indexed store the three rates should be about the same.
+ *
+ * The rates are only reported; the test fails if a call fails or returns
+ * the wrong data. As it takes several seconds it is only run on request.
+ */
+
+#include <efi_selftest.h>
+
+#define EFI_ST_NUM_VARS 128
+#define EFI_ST_NAME_LEN 16
+/* duration of each measurement in units of 100 ns */
+#define EFI_ST_PERIOD 1000000
+/* number of calls between checks of the timer */
+#define EFI_ST_BATCH 16
+
+static struct efi_boot_services *boottime;
+static struct efi_runtime_services *runtime;
+static struct efi_event *timer;
+static const efi_guid_t guid_vendor =
+	EFI_GUID(0x9e7e3b8a, 0x45b6, 0x4e30,
+		 0x8a, 0x1b, 0x27, 0x4f, 0x0c, 0x63, 0xd2, 0x91);
+
+/*
+ * Set up the name of a test variable.
+ *
+ * @name:	buffer of EFI_ST_NAME_LEN characters for the name
+ * @index:	number of the variable
+ */
+static void var_name(u16 *name, unsigned int index)
+{
+	const char *prefix = "efi_st_bench";
+	int i;
+
+	for (i = 0; prefix[i]; ++i)
+		name[i] = prefix[i];
+	name[i++] = '0' + index / 100 % 10;
+	name[i++] = '0' + index / 10 % 10;
+	name[i++] = '0' + index % 10;
+	name[i] = 0;
+}
+
+/*
+ * Delete the test variables.
+ */
+static void delete_vars(void)
+{
+	u16 name[EFI_ST_NAME_LEN];
+	unsigned int i;
+
+	for (i = 0; i < EFI_ST_NUM_VARS; ++i) {
+		var_name(name, i);
+		runtime->set_variable(name, &guid_vendor, 0, 0, NULL);
+	}
+}
+
+/*
+ * Count the calls of GetVariable for a variable during one period.
+ *
+ * @name:	name of the variable
+ * @expected:	status expected from GetVariable
+ * @value:	value expected if the variable exists
+ * @countp:	returns the number of calls
+ * Return:	EFI_ST_SUCCESS for success
+ */
+static int measure_get(u16 *name, efi_status_t expected, u32 value,
+		       unsigned int *countp)
+{
+	efi_status_t ret;
+	efi_uintn_t len;
+	unsigned int count = 0;
+	int i;
+	u32 data;
+
+	ret = boottime->set_timer(timer, EFI_TIMER_RELATIVE, EFI_ST_PERIOD);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Could not set timer\n");
+		return EFI_ST_FAILURE;
+	}
+	do {
+		for (i = 0; i < EFI_ST_BATCH; ++i, ++count) {
+			len = sizeof(data);
+			ret = runtime->get_variable(name, &guid_vendor, NULL,
+						    &len, &data);
+			if (ret != expected) {
+				efi_st_error("GetVariable returned %u\n",
+					     (unsigned int)ret);
+				return EFI_ST_FAILURE;
+			}
+			if (ret == EFI_SUCCESS && data != value) {
+				efi_st_error("GetVariable returned wrong value\n");
+				return EFI_ST_FAILURE;
+			}
+		}
+	} while (boottime->check_event(timer) == EFI_NOT_READY);
+	*countp = count;
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Count the calls of SetVariable for a variable during one period.
+ *
+ * @name:	name of the variable
+ * @countp:	returns the number of calls
+ * Return:	EFI_ST_SUCCESS for success
+ */
+static int measure_set(u16 *name, unsigned int *countp)
+{
+	efi_status_t ret;
+	unsigned int count = 0;
+	int i;
+	u32 data;
+
+	ret = boottime->set_timer(timer, EFI_TIMER_RELATIVE, EFI_ST_PERIOD);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Could not set timer\n");
+		return EFI_ST_FAILURE;
+	}
+	do {
+		for (i = 0; i < EFI_ST_BATCH; ++i, ++count) {
+			data = count;
+			ret = runtime->set_variable(
+					name, &guid_vendor,
+					EFI_VARIABLE_BOOTSERVICE_ACCESS,
+					sizeof(data), &data);
+			if (ret != EFI_SUCCESS) {
+				efi_st_error("SetVariable failed\n");
+				return EFI_ST_FAILURE;
+			}
+		}
+	} while (boottime->check_event(timer) == EFI_NOT_READY);
+	*countp = count;
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Setup unit test.
+ *
+ * @handle	handle of the loaded image
+ * @systable	system table
+ */
+static int setup(const efi_handle_t img_handle,
+		 const struct efi_system_table *systable)
+{
+	efi_status_t ret;
+
+	boottime = systable->boottime;
+	runtime = systable->runtime;
+
+	ret = boottime->create_event(EVT_TIMER, TPL_CALLBACK, NULL, NULL,
+				     &timer);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Could not create event\n");
+		return EFI_ST_FAILURE;
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Tear down unit test.
+ *
+ * Return:	EFI_ST_SUCCESS for success
+ */
+static int teardown(void)
+{
+	efi_status_t ret;
+
+	delete_vars();
+	if (timer) {
+		ret = boottime->close_event(timer);
+		timer = NULL;
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("Could not close event\n");
+			return EFI_ST_FAILURE;
+		}
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Execute unit test.
+ *
+ * Return:	EFI_ST_SUCCESS for success
+ */
+static int execute(void)
+{
+	u16 name[EFI_ST_NAME_LEN];
+	unsigned int i, count;
+	efi_status_t ret;
+	u32 data;
+
+	for (i = 0; i < EFI_ST_NUM_VARS; ++i) {
+		var_name(name, i);
+		data = i;
+		ret = runtime->set_variable(name, &guid_vendor,
+					    EFI_VARIABLE_BOOTSERVICE_ACCESS,
+					    sizeof(data), &data);
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("SetVariable failed for variable %u\n",
+				     i);
+			return EFI_ST_FAILURE;
+		}
+	}
+	efi_st_printf("%u variables, %u ms per measurement\n",
+		      EFI_ST_NUM_VARS, EFI_ST_PERIOD / 10000);
+
+	var_name(name, 0);
+	if (measure_get(name, EFI_SUCCESS, 0, &count) != EFI_ST_SUCCESS)
+		return EFI_ST_FAILURE;
+	efi_st_printf("GetVariable, first variable: %u calls\n", count);
+
+	var_name(name, EFI_ST_NUM_VARS - 1);
+	if (measure_get(name, EFI_SUCCESS, EFI_ST_NUM_VARS - 1, &count) !=
+	    EFI_ST_SUCCESS)
+		return EFI_ST_FAILURE;
+	efi_st_printf("GetVariable, last variable: %u calls\n", count);
+
+	var_name(name, EFI_ST_NUM_VARS);
+	if (measure_get(name, EFI_NOT_FOUND, 0, &count) != EFI_ST_SUCCESS)
+		return EFI_ST_FAILURE;
+	efi_st_printf("GetVariable, missing variable: %u calls\n", count);
+
+	/* each update moves the variable to the end of the store */
+	var_name(name, 0);
+	if (measure_set(name, &count) != EFI_ST_SUCCESS)
+		return EFI_ST_FAILURE;
+	efi_st_printf("SetVariable, update: %u calls\n", count);
+
+	for (i = 1; i < EFI_ST_NUM_VARS; ++i) {
+		var_name(name, i);
+		ret = runtime->set_variable(name, &guid_vendor, 0, 0, NULL);
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("Could not delete variable %u\n", i);
+			return EFI_ST_FAILURE;
+		}
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
+EFI_UNIT_TEST(variables_bench) = {
+	.name = "variables benchmark",
+	.phase = EFI_EXECUTE_BEFORE_BOOTTIME_EXIT,
+	.setup = setup,
+	.execute = execute,
+	.teardown = teardown,
+	.on_request = true,
+};
@@ -15,7 +15,6 @@
 #include <errno.h>
 #include <log.h>
 #include <malloc.h>
-#include <sort.h>
 
 #ifdef USE_HOSTCC		/* HOST build */
 # include <string.h>
@@ -35,9 +34,6 @@
 # include <linux/ctype.h>
 #endif
 
-#define USED_FREE 0
-#define USED_DELETED -1
-
 #include <env_callback.h>
 #include <env_flags.h>
 #include <search.h>
@@ -52,16 +48,38 @@
  * The reentrant version has no static variables to maintain the state.
  * Instead the interface of all functions is extended to take an argument
  * which describes the current status.
+ *
+ * Each entry is allocated on its own, together with its key, so that it
+ * never moves once created. Pointers to the entries are kept in:
+ *
+ * - the hash table, which uses double hashing with open addressing and
+ *   grows as entries are added
+ * - the entry list, which gives each entry the index returned by
+ *   hsearch_r() and is what hmatch_r() and hwalk_r() walk
+ * - the sorted list, ordered by key, which hexport_r() walks
  */
 
 struct env_entry_node {
-	int used;
 	struct env_entry entry;
+	unsigned int hval;
+	unsigned int idx;
+	char key[];
 };
 
+/* Marks a slot of the hash table whose entry was deleted */
+static struct env_entry_node deleted_node;
+#define DELETED		(&deleted_node)
+
+/* The table grows once this many of its slots are used or deleted */
+#define HTAB_LOAD_MAX(size)	((size) / 4 * 3)
 
-static void _hdelete(const char *key, struct hsearch_data *htab,
-		     struct env_entry *ep, int idx);
+/*
+ * Growing the table does not move all the entries at once. Instead each
+ * call to hsearch_r() moves this many slots from the old table.
+ */
+#define HTAB_MOVE_STEP		8
+
+static void _hdelete(struct hsearch_data *htab, struct env_entry_node *node);
 
 /*
  * hcreate()
@@ -85,13 +103,23 @@ static int isprime(unsigned int number)
 	return number % div != 0;
 }
 
+/* Return the first prime not smaller than nel, which is at least 5 */
+static unsigned int htab_prime(unsigned int nel)
+{
+	if (nel < 5)
+		nel = 5;
+	nel |= 1;		/* make odd */
+	while (!isprime(nel))
+		nel += 2;
+
+	return nel;
+}
+
 /*
  * Before using the hash table we must allocate memory for it.
- * Test for an existing table are done. We allocate one element
- * more as the found prime number says. This is done for more effective
- * indexing as explained in the comment for the hsearch function.
- * The contents of the table is zeroed, especially the field used
- * becomes zero.
+ * Test for an existing table are done. The table is made large enough to
+ * hold nel elements without growing. The contents of the table is zeroed,
+ * so all slots start free.
  */
 
 int hcreate_r(size_t nel, struct hsearch_data *htab)
@@ -108,18 +136,24 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 		return 0;
 	}
 
-	/* Change nel to the first prime number not smaller as nel. */
-	nel |= 1;		/* make odd */
-	while (!isprime(nel))
-		nel += 2;
-
-	htab->size = nel;
+	if (!nel)
+		nel = 1;
+	htab->size = htab_prime(nel + nel / 3 + 1);
 	htab->filled = 0;
+	htab->deleted = 0;
+	htab->old_table = NULL;
+	htab->list_size = nel;
+	memset(htab->cache, '\0', sizeof(htab->cache));
 
 	/* allocate memory and zero out */
-	htab->table = (struct env_entry_node *)calloc(htab->size + 1,
-						sizeof(struct env_entry_node));
-	if (htab->table == NULL) {
+	htab->table = calloc(htab->size, sizeof(*htab->table));
+	htab->list = malloc(nel * sizeof(*htab->list));
+	htab->sorted = malloc(nel * sizeof(*htab->sorted));
+	if (!htab->table || !htab->list || !htab->sorted) {
+		free(htab->table);
+		free(htab->list);
+		free(htab->sorted);
+		htab->table = NULL;
 		__set_errno(ENOMEM);
 		return 0;
 	}
@@ -149,15 +183,17 @@ void hdestroy_r(struct hsearch_data *htab)
 	}
 
 	/* free used memory */
-	for (i = 1; i <= htab->size; ++i) {
-		if (htab->table[i].used > 0) {
-			struct env_entry *ep = &htab->table[i].entry;
-
-			free((void *)ep->key);
-			free(ep->data);
-		}
+	for (i = 0; i < htab->filled; ++i) {
+		free(htab->list[i]->entry.data);
+		free(htab->list[i]);
 	}
 	free(htab->table);
+	free(htab->old_table);
+	free(htab->list);
+	free(htab->sorted);
+	htab->old_table = NULL;
+	htab->filled = 0;
+	memset(htab->cache, '\0', sizeof(htab->cache));
 
 	/* the sign for an existing table is an value != NULL in htable */
 	htab->table = NULL;
@@ -170,17 +206,23 @@ void hdestroy_r(struct hsearch_data *htab)
 /*
  * This is the search function. It uses double hashing with open addressing.
  * The argument item.key has to be a pointer to an zero terminated, most
- * probably strings of chars. The function for generating a number of the
- * strings is simple but fast. It can be replaced by a more complex function
- * like ajw (see [Aho,Sethi,Ullman]) if the needs are shown.
+ * probably strings of chars. The key is hashed with FNV-1a, which is fast
+ * and, unlike a plain shift-and-add, keeps keys with a long common prefix
+ * (bootcmd_mmc0, bootcmd_mmc1, ...) apart.
+ *
+ * The full hash is stored in each entry. It is used as a first fast
+ * comparison for equality of the stored and the parameter value, which
+ * helps to prevent unnecessary expensive calls of strcmp, and it lets the
+ * table grow without hashing the keys again.
  *
- * We use an trick to speed up the lookup. The table is created by hcreate
- * with one more element available. This enables us to use the index zero
- * special. This index will never be used because we store the first hash
- * index in the field used where zero means not used. Every other value
- * means used. The used field can be used as a first fast comparison for
- * equality of the stored and the parameter value. This helps to prevent
- * unnecessary expensive calls of strcmp.
+ * When the table gets 3/4 full (counting deleted slots) a table twice the
+ * size of the number of entries is allocated. The entries are moved over a
+ * few at a time on each call, so no single call pays for the whole table.
+ * Until that is done, entries are looked up in both tables.
+ *
+ * Lookups go through a small cache indexed by the hash, which saves the
+ * probing for variables which are read again and again, e.g. by scripts
+ * in loops.
  *
  * This implementation differs from the standard library version of
  * this function in a number of ways:
@@ -194,239 +236,358 @@ void hdestroy_r(struct hsearch_data *htab)
  * - The standard implementation does not provide a way to update an
  *   existing entry.  This version will create a new entry or update an
  *   existing one when both "action == ENV_ENTER" and "item.data != NULL".
- * - Instead of returning 1 on success, we return the index into the
- *   internal hash table, which is also guaranteed to be positive.
- *   This allows us direct access to the found hash table slot for
- *   example for functions like hdelete().
+ * - Instead of returning 1 on success, we return the index of the entry
+ *   plus one, which is guaranteed to be positive. This allows us to carry
+ *   on from the found entry with hmatch_r().
  */
 
-int hmatch_r(const char *match, int last_idx, struct env_entry **retval,
-	     struct hsearch_data *htab)
+static unsigned int htab_hash(const char *key)
 {
-	unsigned int idx;
-	size_t key_len = strlen(match);
+	unsigned int hval = 2166136261U;
 
-	for (idx = last_idx + 1; idx < htab->size; ++idx) {
-		if (htab->table[idx].used <= 0)
-			continue;
-		if (!strncmp(match, htab->table[idx].entry.key, key_len)) {
-			*retval = &htab->table[idx].entry;
-			return idx;
-		}
+	while (*key) {
+		hval ^= (unsigned char)*key++;
+		hval *= 16777619;
 	}
 
-	__set_errno(ESRCH);
-	*retval = NULL;
-	return 0;
+	return hval;
 }
 
-static int
-do_callback(const struct env_entry *e, const char *name, const char *value,
-	    enum env_op op, int flags)
+/*
+ * Find the slot holding the entry with the given key, or NULL if it is not
+ * in this table.
+ */
+static struct env_entry_node **htab_find_slot(struct env_entry_node **table,
+					      unsigned int size,
+					      unsigned int hval,
+					      const char *key)
 {
-#ifndef CONFIG_SPL_BUILD
-	if (e->callback)
-		return e->callback(name, value, op, flags);
-#endif
-	return 0;
+	/* Second hash function: as suggested in [Knuth] */
+	unsigned int step = 1 + hval % (size - 2);
+	unsigned int idx = hval % size;
+	unsigned int count;
+
+	/* Because size is prime this steps through all slots */
+	for (count = 0; count < size; count++) {
+		struct env_entry_node *node = table[idx];
+
+		if (!node)
+			break;
+		if (node != DELETED && node->hval == hval &&
+		    !strcmp(node->key, key))
+			return &table[idx];
+		idx += step;
+		if (idx >= size)
+			idx -= size;
+	}
+
+	return NULL;
 }
 
-/*
- * Compare an existing entry with the desired key, and overwrite if the action
- * is ENV_ENTER.  This is simply a helper function for hsearch_r().
- */
-static inline int _compare_and_overwrite_entry(struct env_entry item,
-		enum env_action action, struct env_entry **retval,
-		struct hsearch_data *htab, int flag, unsigned int hval,
-		unsigned int idx)
+/* Find the first free or deleted slot for an entry, NULL if full */
+static struct env_entry_node **htab_free_slot(struct env_entry_node **table,
+					      unsigned int size,
+					      unsigned int hval)
 {
-	if (htab->table[idx].used == hval
-	    && strcmp(item.key, htab->table[idx].entry.key) == 0) {
-		/* Overwrite existing value? */
-		if (action == ENV_ENTER && item.data) {
-			/* check for permission */
-			if (htab->change_ok != NULL && htab->change_ok(
-			    &htab->table[idx].entry, item.data,
-			    env_op_overwrite, flag)) {
-				debug("change_ok() rejected setting variable "
-					"%s, skipping it!\n", item.key);
-				__set_errno(EPERM);
-				*retval = NULL;
-				return 0;
-			}
+	unsigned int step = 1 + hval % (size - 2);
+	unsigned int idx = hval % size;
+	unsigned int count;
 
-			/* If there is a callback, call it */
-			if (do_callback(&htab->table[idx].entry, item.key,
-					item.data, env_op_overwrite, flag)) {
-				debug("callback() rejected setting variable "
-					"%s, skipping it!\n", item.key);
-				__set_errno(EINVAL);
-				*retval = NULL;
-				return 0;
-			}
+	for (count = 0; count < size; count++) {
+		if (!table[idx] || table[idx] == DELETED)
+			return &table[idx];
+		idx += step;
+		if (idx >= size)
+			idx -= size;
+	}
 
-			free(htab->table[idx].entry.data);
-			htab->table[idx].entry.data = strdup(item.data);
-			if (!htab->table[idx].entry.data) {
-				__set_errno(ENOMEM);
-				*retval = NULL;
-				return 0;
-			}
+	return NULL;
+}
+
+/* Move up to count slots from the old table into the current one */
+static void htab_move(struct hsearch_data *htab, unsigned int count)
+{
+	while (htab->old_table && count--) {
+		struct env_entry_node **slot = &htab->old_table[htab->old_pos];
+
+		if (*slot && *slot != DELETED) {
+			*htab_free_slot(htab->table, htab->size,
+					(*slot)->hval) = *slot;
+			*slot = DELETED;
+		}
+		if (++htab->old_pos == htab->old_size) {
+			free(htab->old_table);
+			htab->old_table = NULL;
 		}
-		/* return found entry */
-		*retval = &htab->table[idx].entry;
-		return idx;
 	}
-	/* keep searching */
-	return -1;
 }
 
-int hsearch_r(struct env_entry item, enum env_action action,
-	      struct env_entry **retval, struct hsearch_data *htab, int flag)
+/*
+ * Start moving to a table twice the size of the number of entries. This
+ * also drops the deleted slots, so the new table is never smaller than the
+ * current one. If there is no memory, carry on with the current table.
+ */
+static void htab_grow(struct hsearch_data *htab)
 {
-	unsigned int hval;
-	unsigned int count;
-	unsigned int len = strlen(item.key);
-	unsigned int idx;
-	unsigned int first_deleted = 0;
-	int ret;
+	struct env_entry_node **table;
+	unsigned int size;
+
+	if (htab->old_table)
+		htab_move(htab, htab->old_size);
+
+	size = htab->filled * 2;
+	if (size < htab->size)
+		size = htab->size;
+	size = htab_prime(size);
+	table = calloc(size, sizeof(*table));
+	if (!table)
+		return;
 
-	/* Compute an value for the given string. Perhaps use a better method. */
-	hval = len;
-	count = len;
-	while (count-- > 0) {
-		hval <<= 4;
-		hval += item.key[count];
-	}
+	debug("hsearch: growing table %p from %u to %u slots\n", htab,
+	      htab->size, size);
+	htab->old_table = htab->table;
+	htab->old_size = htab->size;
+	htab->old_pos = 0;
+	htab->table = table;
+	htab->size = size;
+	htab->deleted = 0;
+}
 
-	/*
-	 * First hash function:
-	 * simply take the modul but prevent zero.
-	 */
-	hval %= htab->size;
-	if (hval == 0)
-		++hval;
+/* Make room for one more entry in the entry and sorted lists */
+static int htab_grow_lists(struct hsearch_data *htab)
+{
+	unsigned int size = htab->list_size * 2;
+	struct env_entry_node **list;
 
-	/* The first index tried. */
-	idx = hval;
+	if (htab->filled < htab->list_size)
+		return 0;
 
-	if (htab->table[idx].used) {
-		/*
-		 * Further action might be required according to the
-		 * action value.
-		 */
-		unsigned hval2;
+	list = realloc(htab->list, size * sizeof(*list));
+	if (!list)
+		return -ENOMEM;
+	htab->list = list;
+
+	list = realloc(htab->sorted, size * sizeof(*list));
+	if (!list)
+		return -ENOMEM;
+	htab->sorted = list;
+	htab->list_size = size;
 
-		if (htab->table[idx].used == USED_DELETED)
-			first_deleted = idx;
+	return 0;
+}
 
-		ret = _compare_and_overwrite_entry(item, action, retval, htab,
-			flag, hval, idx);
-		if (ret != -1)
-			return ret;
+/* Return the position of the first entry in the sorted list not below key */
+static unsigned int htab_sorted_pos(struct hsearch_data *htab, const char *key)
+{
+	unsigned int lo = 0, hi = htab->filled;
 
-		/*
-		 * Second hash function:
-		 * as suggested in [Knuth]
-		 */
-		hval2 = 1 + hval % (htab->size - 2);
-
-		do {
-			/*
-			 * Because SIZE is prime this guarantees to
-			 * step through all available indices.
-			 */
-			if (idx <= hval2)
-				idx = htab->size + idx - hval2;
-			else
-				idx -= hval2;
-
-			/*
-			 * If we visited all entries leave the loop
-			 * unsuccessfully.
-			 */
-			if (idx == hval)
-				break;
-
-			if (htab->table[idx].used == USED_DELETED
-			    && !first_deleted)
-				first_deleted = idx;
-
-			/* If entry is found use it. */
-			ret = _compare_and_overwrite_entry(item, action, retval,
-				htab, flag, hval, idx);
-			if (ret != -1)
-				return ret;
-		}
-		while (htab->table[idx].used != USED_FREE);
+	/* An imported environment is already sorted, so try the end first */
+	if (hi && strcmp(htab->sorted[hi - 1]->key, key) < 0)
+		return hi;
+
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+
+		if (strcmp(htab->sorted[mid]->key, key) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
 
-	/* An empty bucket has been found. */
-	if (action == ENV_ENTER) {
-		/*
-		 * If table is full and another entry should be
-		 * entered return with error.
-		 */
-		if (htab->filled == htab->size) {
-			__set_errno(ENOMEM);
-			*retval = NULL;
-			return 0;
-		}
+	return lo;
+}
 
-		/*
-		 * Create new entry;
-		 * create copies of item.key and item.data
-		 */
-		if (first_deleted)
-			idx = first_deleted;
-
-		htab->table[idx].used = hval;
-		htab->table[idx].entry.key = strdup(item.key);
-		htab->table[idx].entry.data = strdup(item.data);
-		if (!htab->table[idx].entry.key ||
-		    !htab->table[idx].entry.data) {
-			__set_errno(ENOMEM);
-			*retval = NULL;
-			return 0;
+static struct env_entry_node *htab_lookup(struct hsearch_data *htab,
+					  unsigned int hval, const char *key)
+{
+	struct env_entry_node **cache;
+	struct env_entry_node **slot;
+
+	cache = &htab->cache[hval & (HSEARCH_CACHE_SIZE - 1)];
+	if (*cache && (*cache)->hval == hval && !strcmp((*cache)->key, key))
+		return *cache;
+
+	slot = htab_find_slot(htab->table, htab->size, hval, key);
+	if (!slot && htab->old_table)
+		slot = htab_find_slot(htab->old_table, htab->old_size, hval,
+				      key);
+	if (!slot)
+		return NULL;
+	*cache = *slot;
+
+	return *slot;
+}
+
+int hmatch_r(const char *match, int last_idx, struct env_entry **retval,
+	     struct hsearch_data *htab)
+{
+	unsigned int idx;
+	size_t key_len = strlen(match);
+
+	for (idx = last_idx; idx < htab->filled; ++idx) {
+		struct env_entry_node *node = htab->list[idx];
+
+		if (!strncmp(match, node->key, key_len)) {
+			*retval = &node->entry;
+			return idx + 1;
 		}
+	}
 
-		++htab->filled;
+	__set_errno(ESRCH);
+	*retval = NULL;
+	return 0;
+}
 
-		/* This is a new entry, so look up a possible callback */
-		env_callback_init(&htab->table[idx].entry);
-		/* Also look for flags */
-		env_flags_init(&htab->table[idx].entry);
+static int
+do_callback(const struct env_entry *e, const char *name, const char *value,
+	    enum env_op op, int flags)
+{
+#ifndef CONFIG_SPL_BUILD
+	if (e->callback)
+		return e->callback(name, value, op, flags);
+#endif
+	return 0;
+}
+
+/*
+ * Overwrite an existing entry if the action is ENV_ENTER.  This is simply
+ * a helper function for hsearch_r().
+ */
+static int _overwrite_entry(struct env_entry item, enum env_action action,
+			    struct env_entry **retval,
+			    struct hsearch_data *htab, int flag,
+			    struct env_entry_node *node)
+{
+	char *data;
 
+	/* Overwrite existing value? */
+	if (action == ENV_ENTER && item.data) {
 		/* check for permission */
 		if (htab->change_ok != NULL && htab->change_ok(
-		    &htab->table[idx].entry, item.data, env_op_create, flag)) {
+		    &node->entry, item.data, env_op_overwrite, flag)) {
 			debug("change_ok() rejected setting variable "
 				"%s, skipping it!\n", item.key);
-			_hdelete(item.key, htab, &htab->table[idx].entry, idx);
 			__set_errno(EPERM);
 			*retval = NULL;
 			return 0;
 		}
 
 		/* If there is a callback, call it */
-		if (do_callback(&htab->table[idx].entry, item.key, item.data,
-				env_op_create, flag)) {
+		if (do_callback(&node->entry, item.key, item.data,
+				env_op_overwrite, flag)) {
 			debug("callback() rejected setting variable "
 				"%s, skipping it!\n", item.key);
-			_hdelete(item.key, htab, &htab->table[idx].entry, idx);
 			__set_errno(EINVAL);
 			*retval = NULL;
 			return 0;
 		}
 
-		/* return new entry */
-		*retval = &htab->table[idx].entry;
-		return 1;
+		data = strdup(item.data);
+		if (!data) {
+			__set_errno(ENOMEM);
+			*retval = NULL;
+			return 0;
+		}
+		free(node->entry.data);
+		node->entry.data = data;
 	}
+	/* return found entry */
+	*retval = &node->entry;
 
-	__set_errno(ESRCH);
-	*retval = NULL;
-	return 0;
+	return node->idx + 1;
+}
+
+int hsearch_r(struct env_entry item, enum env_action action,
+	      struct env_entry **retval, struct hsearch_data *htab, int flag)
+{
+	struct env_entry_node *node, **slot;
+	unsigned int hval, pos;
+	size_t len;
+
+	htab_move(htab, HTAB_MOVE_STEP);
+
+	hval = htab_hash(item.key);
+	node = htab_lookup(htab, hval, item.key);
+	if (node)
+		return _overwrite_entry(item, action, retval, htab, flag, node);
+
+	if (action != ENV_ENTER) {
+		__set_errno(ESRCH);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* Create a new entry, growing the table first if needed */
+	if (htab->filled + htab->deleted >= HTAB_LOAD_MAX(htab->size))
+		htab_grow(htab);
+	slot = htab_free_slot(htab->table, htab->size, hval);
+	if (!slot || htab_grow_lists(htab)) {
+		__set_errno(ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* create copies of item.key and item.data */
+	len = strlen(item.key);
+	node = malloc(sizeof(*node) + len + 1);
+	if (!node) {
+		__set_errno(ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+	memset(&node->entry, '\0', sizeof(node->entry));
+	memcpy(node->key, item.key, len + 1);
+	node->entry.key = node->key;
+	node->entry.data = strdup(item.data);
+	if (!node->entry.data) {
+		free(node);
+		__set_errno(ENOMEM);
+		*retval = NULL;
+		return 0;
+	}
+	node->hval = hval;
+
+	if (*slot == DELETED)
+		--htab->deleted;
+	*slot = node;
+	node->idx = htab->filled;
+	htab->list[node->idx] = node;
+	pos = htab_sorted_pos(htab, node->key);
+	memmove(&htab->sorted[pos + 1], &htab->sorted[pos],
+		(htab->filled - pos) * sizeof(*htab->sorted));
+	htab->sorted[pos] = node;
+	++htab->filled;
+
+	/* This is a new entry, so look up a possible callback */
+	env_callback_init(&node->entry);
+	/* Also look for flags */
+	env_flags_init(&node->entry);
+
+	/* check for permission */
+	if (htab->change_ok != NULL && htab->change_ok(
+	    &node->entry, item.data, env_op_create, flag)) {
+		debug("change_ok() rejected setting variable "
+			"%s, skipping it!\n", item.key);
+		_hdelete(htab, node);
+		__set_errno(EPERM);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* If there is a callback, call it */
+	if (do_callback(&node->entry, item.key, item.data,
+			env_op_create, flag)) {
+		debug("callback() rejected setting variable "
+			"%s, skipping it!\n", item.key);
+		_hdelete(htab, node);
+		__set_errno(EINVAL);
+		*retval = NULL;
+		return 0;
+	}
+
+	/* return new entry */
+	*retval = &node->entry;
+	return 1;
 }
 
 
@@ -440,37 +601,54 @@ int hsearch_r(struct env_entry item, enum env_action action,
  * do that.
  */
 
-static void _hdelete(const char *key, struct hsearch_data *htab,
-		     struct env_entry *ep, int idx)
+static void _hdelete(struct hsearch_data *htab, struct env_entry_node *node)
 {
-	/* free used entry */
-	debug("hdelete: DELETING key \"%s\"\n", key);
-	free((void *)ep->key);
-	free(ep->data);
-	ep->flags = 0;
-	htab->table[idx].used = USED_DELETED;
+	struct env_entry_node **slot, *last;
+	unsigned int pos;
 
-	--htab->filled;
+	/* free used entry */
+	debug("hdelete: DELETING key \"%s\"\n", node->key);
+
+	/* A callback may have grown the table, so look for the slot again */
+	slot = htab_find_slot(htab->table, htab->size, node->hval, node->key);
+	if (slot)
+		++htab->deleted;
+	else if (htab->old_table)
+		slot = htab_find_slot(htab->old_table, htab->old_size,
+				      node->hval, node->key);
+	if (slot)
+		*slot = DELETED;
+	if (htab->cache[node->hval & (HSEARCH_CACHE_SIZE - 1)] == node)
+		htab->cache[node->hval & (HSEARCH_CACHE_SIZE - 1)] = NULL;
+
+	pos = htab_sorted_pos(htab, node->key);
+	memmove(&htab->sorted[pos], &htab->sorted[pos + 1],
+		(htab->filled - pos - 1) * sizeof(*htab->sorted));
+
+	/* keep the entry list dense by moving the last entry into the gap */
+	last = htab->list[--htab->filled];
+	htab->list[node->idx] = last;
+	last->idx = node->idx;
+
+	free(node->entry.data);
+	free(node);
 }
 
 int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
 {
-	struct env_entry e, *ep;
-	int idx;
+	struct env_entry_node *node;
 
 	debug("hdelete: DELETE key \"%s\"\n", key);
 
-	e.key = (char *)key;
-
-	idx = hsearch_r(e, ENV_FIND, &ep, htab, 0);
-	if (idx == 0) {
+	node = htab_lookup(htab, htab_hash(key), key);
+	if (!node) {
 		__set_errno(ESRCH);
 		return -ENOENT;	/* not found */
 	}
 
 	/* Check for permission */
 	if (htab->change_ok != NULL &&
-	    htab->change_ok(ep, NULL, env_op_delete, flag)) {
+	    htab->change_ok(&node->entry, NULL, env_op_delete, flag)) {
 		debug("change_ok() rejected deleting variable "
 			"%s, skipping it!\n", key);
 		__set_errno(EPERM);
@@ -478,15 +656,14 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
 	}
 
 	/* If there is a callback, call it */
-	if (do_callback(&htab->table[idx].entry, key, NULL,
-			env_op_delete, flag)) {
+	if (do_callback(&node->entry, key, NULL, env_op_delete, flag)) {
 		debug("callback() rejected deleting variable "
 			"%s, skipping it!\n", key);
 		__set_errno(EINVAL);
 		return -EINVAL;
 	}
 
-	_hdelete(key, htab, ep, idx);
+	_hdelete(htab, node);
 
 	return 0;
 }
@@ -509,7 +686,8 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
  * for later re-import.
  *
  * The entries in the result list will be sorted by ascending key
- * values.
+ * values. The table keeps a sorted list of its entries, so no sorting is
+ * needed here.
  *
  * If the separator character is different from NUL, then any
  * separator characters and backslash characters in the values will
@@ -534,14 +712,6 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
  *		bytes in the string will be '\0'-padded.
  */
 
-static int cmpkey(const void *p1, const void *p2)
-{
-	struct env_entry *e1 = *(struct env_entry **)p1;
-	struct env_entry *e2 = *(struct env_entry **)p2;
-
-	return (strcmp(e1->key, e2->key));
-}
-
 static int match_string(int flag, const char *str, const char *pat, void *priv)
 {
 	switch (flag & H_MATCH_METHOD) {
@@ -604,7 +774,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		 char **resp, size_t size,
 		 int argc, char *const argv[])
 {
-	struct env_entry *list[htab->size];
+	struct env_entry **list;
 	char *res, *p;
 	size_t totlen;
 	int i, n;
@@ -615,63 +785,55 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		return (-1);
 	}
 
+	list = malloc((htab->filled + 1) * sizeof(*list));
+	if (!list) {
+		__set_errno(ENOMEM);
+		return (-1);
+	}
+
 	debug("EXPORT  table = %p, htab.size = %d, htab.filled = %d, size = %lu\n",
 	      htab, htab->size, htab->filled, (ulong)size);
 	/*
 	 * Pass 1:
-	 * search used entries,
+	 * search used entries in key order,
 	 * save addresses and compute total length
 	 */
-	for (i = 1, n = 0, totlen = 0; i <= htab->size; ++i) {
-
-		if (htab->table[i].used > 0) {
-			struct env_entry *ep = &htab->table[i].entry;
-			int found = match_entry(ep, flag, argc, argv);
+	for (i = 0, n = 0, totlen = 0; i < htab->filled; ++i) {
+		struct env_entry *ep = &htab->sorted[i]->entry;
+		int found = match_entry(ep, flag, argc, argv);
 
-			if ((argc > 0) && (found == 0))
-				continue;
+		if ((argc > 0) && (found == 0))
+			continue;
 
-			if ((flag & H_HIDE_DOT) && ep->key[0] == '.')
-				continue;
+		if ((flag & H_HIDE_DOT) && ep->key[0] == '.')
+			continue;
 
-			list[n++] = ep;
+		list[n++] = ep;
 
-			totlen += strlen(ep->key);
+		totlen += strlen(ep->key);
 
-			if (sep == '\0') {
-				totlen += strlen(ep->data);
-			} else {	/* check if escapes are needed */
-				char *s = ep->data;
+		if (sep == '\0') {
+			totlen += strlen(ep->data);
+		} else {	/* check if escapes are needed */
+			char *s = ep->data;
 
-				while (*s) {
+			while (*s) {
+				++totlen;
+				/* add room for needed escape chars */
+				if ((*s == sep) || (*s == '\\'))
 					++totlen;
-					/* add room for needed escape chars */
-					if ((*s == sep) || (*s == '\\'))
-						++totlen;
-					++s;
-				}
+				++s;
 			}
-			totlen += 2;	/* for '=' and 'sep' char */
 		}
+		totlen += 2;	/* for '=' and 'sep' char */
 	}
 
-#ifdef DEBUG
-	/* Pass 1a: print unsorted list */
-	printf("Unsorted: n=%d\n", n);
-	for (i = 0; i < n; ++i) {
-		printf("\t%3d: %p ==> %-10s => %s\n",
-		       i, list[i], list[i]->key, list[i]->data);
-	}
-#endif
-
-	/* Sort list by keys */
-	qsort(list, n, sizeof(struct env_entry *), cmpkey);
-
 	/* Check if the user supplied buffer size is sufficient */
 	if (size) {
 		if (size < totlen + 1) {	/* provided buffer too small */
 			printf("Env export buffer too small: %lu, but need %lu\n",
 			       (ulong)size, (ulong)totlen + 1);
+			free(list);
 			__set_errno(ENOMEM);
 			return (-1);
 		}
@@ -688,6 +850,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		/* no, allocate and clear one */
 		*resp = res = calloc(1, size);
 		if (res == NULL) {
+			free(list);
 			__set_errno(ENOMEM);
 			return (-1);
 		}
@@ -714,6 +877,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		*p++ = sep;
 	}
 	*p = '\0';		/* terminate result */
+	free(list);
 
 	return size;
 }
@@ -842,7 +1006,8 @@ int himport_r(struct hsearch_data *htab,
 	 * (CONFIG_ENV_SIZE).  This heuristics will result in
 	 * unreasonably large numbers (and thus memory footprint) for
 	 * big flash environments (>8,000 entries for 64 KB
-	 * environment size), so we clip it to a reasonable value.
+	 * environment size), so we clip it to a reasonable value; the
+	 * table grows if more entries are added.
 	 * On the other hand we need to add some more entries for free
 	 * space when importing very small buffers. Both boundaries can
 	 * be overwritten in the board config file if needed.
@@ -996,12 +1161,10 @@ int hwalk_r(struct hsearch_data *htab, int (*callback)(struct env_entry *entry))
 	int i;
 	int retval;
 
-	for (i = 1; i <= htab->size; ++i) {
-		if (htab->table[i].used > 0) {
-			retval = callback(&htab->table[i].entry);
-			if (retval)
-				return retval;
-		}
+	for (i = 0; i < htab->filled; ++i) {
+		retval = callback(&htab->list[i]->entry);
+		if (retval)
+			return retval;
 	}
 
 	return 0;
@@ -6,7 +6,9 @@
 #include <common.h>
 #include <compiler.h>
 #include <image.h>
+#include <malloc.h>
 #include <linux/kernel.h>
+#include <linux/sizes.h>
 #include <linux/types.h>
 #include <asm/unaligned.h>
 #include <u-boot/lz4.h>
@@ -16,51 +18,80 @@
 
 #define LZ4F_BLOCKUNCOMPRESSED_FLAG 0x80000000U
 
-int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+/**
+ * ulz4_parse_header() - Check an LZ4 frame header and skip over it
+ *
+ * @src: Frame to check
+ * @srcn: Length of @src
+ * @inp: Returns a pointer to the first block header
+ * @has_block_checksum: Returns true if each block is followed by a checksum
+ * @block_max: Returns the maximum uncompressed size of a block
+ * Return: 0 if OK, else see ulz4fn()
+ */
+static int ulz4_parse_header(const void *src, size_t srcn, const void **inp,
+			     int *has_block_checksum, size_t *block_max)
 {
-	const void *end = dst + *dstn;
+	/* With in-place decompression the header may become invalid later. */
 	const void *in = src;
+	u32 magic;
+	u8 flags, version, independent_blocks, has_content_size;
+	u8 block_desc;
+
+	if (srcn < sizeof(u32) + 3*sizeof(u8))
+		return -EINVAL;	/* input overrun */
+
+	magic = get_unaligned_le32(in);
+	in += sizeof(u32);
+	flags = *(u8 *)in;
+	in += sizeof(u8);
+	block_desc = *(u8 *)in;
+	in += sizeof(u8);
+
+	version = (flags >> 6) & 0x3;
+	independent_blocks = (flags >> 5) & 0x1;
+	*has_block_checksum = (flags >> 4) & 0x1;
+	has_content_size = (flags >> 3) & 0x1;
+
+	/* We assume there's always only a single, standard frame. */
+	if (magic != LZ4F_MAGIC || version != 1)
+		return -EPROTONOSUPPORT;	/* unknown format */
+	if ((flags & 0x03) || (block_desc & 0x8f))
+		return -EINVAL;	/* reserved bits must be zero */
+	if (!independent_blocks)
+		return -EPROTONOSUPPORT; /* we can't support this yet */
+
+	/* 64KB, 256KB, 1MB or 4MB; smaller IDs are invalid */
+	*block_max = 1 << (8 + 2 * ((block_desc >> 4) & 0x7));
+
+	if (has_content_size) {
+		if (srcn < sizeof(u32) + 3*sizeof(u8) + sizeof(u64))
+			return -EINVAL;	/* input overrun */
+		in += sizeof(u64);
+	}
+	/* Header checksum byte */
+	in += sizeof(u8);
+	*inp = in;
+
+	return 0;
+}
+
+int ulz4fn_cb(const void *src, size_t srcn, void *dst, size_t *dstn,
+	      void (*in_fn)(void *priv, const void *buf, size_t len),
+	      void *priv)
+{
+	const void *end = dst + *dstn;
+	const void *in;
+	const void *fed = src;
 	void *out = dst;
 	int has_block_checksum;
+	size_t block_max;
 	int ret;
 	*dstn = 0;
 
-	{ /* With in-place decompression the header may become invalid later. */
-		u32 magic;
-		u8 flags, version, independent_blocks, has_content_size;
-		u8 block_desc;
-
-		if (srcn < sizeof(u32) + 3*sizeof(u8))
-			return -EINVAL;	/* input overrun */
-
-		magic = get_unaligned_le32(in);
-		in += sizeof(u32);
-		flags = *(u8 *)in;
-		in += sizeof(u8);
-		block_desc = *(u8 *)in;
-		in += sizeof(u8);
-
-		version = (flags >> 6) & 0x3;
-		independent_blocks = (flags >> 5) & 0x1;
-		has_block_checksum = (flags >> 4) & 0x1;
-		has_content_size = (flags >> 3) & 0x1;
-
-		/* We assume there's always only a single, standard frame. */
-		if (magic != LZ4F_MAGIC || version != 1)
-			return -EPROTONOSUPPORT;	/* unknown format */
-		if ((flags & 0x03) || (block_desc & 0x8f))
-			return -EINVAL;	/* reserved bits must be zero */
-		if (!independent_blocks)
-			return -EPROTONOSUPPORT; /* we can't support this yet */
-
-		if (has_content_size) {
-			if (srcn < sizeof(u32) + 3*sizeof(u8) + sizeof(u64))
-				return -EINVAL;	/* input overrun */
-			in += sizeof(u64);
-		}
-		/* Header checksum byte */
-		in += sizeof(u8);
-	}
+	ret = ulz4_parse_header(src, srcn, &in, &has_block_checksum,
+				&block_max);
+	if (ret)
+		return ret;
 
 	while (1) {
 		u32 block_header, block_size;
@@ -74,6 +105,18 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 			break;
 		}
 
+		/* Hand over everything up to the end of this block first */
+		if (in_fn) {
+			const void *next = in + block_size;
+
+			if (has_block_checksum && block_size)
+				next += sizeof(u32);
+			if (next > src + srcn)
+				next = src + srcn;
+			in_fn(priv, fed, next - fed);
+			fed = next;
+		}
+
 		if (!block_size) {
 			ret = 0;	/* decompression successful */
 			break;
@@ -107,3 +150,82 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 	*dstn = out - dst;
 	return ret;
 }
+
+int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	return ulz4fn_cb(src, srcn, dst, dstn, NULL, NULL);
+}
+
+int ulz4fn_out(const void *src, size_t srcn,
+	       int (*out_fn)(void *priv, const void *buf, size_t len),
+	       void *priv, unsigned long long *dstn)
+{
+	const void *in;
+	int has_block_checksum;
+	size_t block_max;
+	void *block;
+	unsigned long long total = 0;
+	int ret;
+
+	ret = ulz4_parse_header(src, srcn, &in, &has_block_checksum,
+				&block_max);
+	if (ret)
+		return ret;
+	if (block_max < SZ_64K)
+		return -EINVAL;
+
+	block = malloc(block_max);
+	if (!block)
+		return -ENOMEM;
+
+	while (1) {
+		u32 block_header, block_size;
+		const void *out;
+
+		if (in - src + sizeof(u32) > srcn) {
+			ret = -EINVAL;		/* input overrun */
+			break;
+		}
+		block_header = get_unaligned_le32(in);
+		in += sizeof(u32);
+		block_size = block_header & ~LZ4F_BLOCKUNCOMPRESSED_FLAG;
+
+		if (in - src + block_size > srcn || block_size > block_max) {
+			ret = -EINVAL;		/* input overrun */
+			break;
+		}
+
+		if (!block_size) {
+			ret = 0;	/* decompression successful */
+			break;
+		}
+
+		if (block_header & LZ4F_BLOCKUNCOMPRESSED_FLAG) {
+			out = in;
+			ret = block_size;
+		} else {
+			/* constant folding essential, do not touch params! */
+			ret = LZ4_decompress_generic(in, block, block_size,
+					block_max, endOnInputSize,
+					decode_full_block, noDict, block,
+					NULL, 0);
+			if (ret < 0) {
+				ret = -EPROTO;	/* decompression error */
+				break;
+			}
+			out = block;
+		}
+		total += ret;
+		ret = out_fn(priv, out, ret);
+		if (ret)
+			break;
+
+		in += block_size;
+		if (has_block_checksum)
+			in += sizeof(u32);
+	}
+	free(block);
+
+	*dstn = total;
+	return ret;
+}
@@ -26,7 +26,7 @@
 
 #define LZMA_PROPERTIES_OFFSET 0
 #define LZMA_SIZE_OFFSET       LZMA_PROPS_SIZE
-#define LZMA_DATA_OFFSET       LZMA_SIZE_OFFSET+sizeof(uint64_t)
+#define LZMA_DATA_OFFSET       (LZMA_SIZE_OFFSET + sizeof(uint64_t))
 
 #include "LzmaTools.h"
 #include "LzmaDec.h"
@@ -34,11 +34,55 @@
 #include <linux/string.h>
 #include <malloc.h>
 
+/* Compressed bytes handed to the decoder at a time when using a callback */
+#define LZMA_CB_CHUNK (64 << 10)
+
 static void *SzAlloc(void *p, size_t size) { return malloc(size); }
 static void SzFree(void *p, void *address) { free(address); }
 
-int lzmaBuffToBuffDecompress(unsigned char *outStream, SizeT *uncompressedSize,
-			     const unsigned char *inStream, SizeT length)
+static SRes lzmaDecodeCb(Byte *dest, SizeT *destLen, const Byte *inStream,
+			 SizeT length, ELzmaStatus *status, ISzAlloc *alloc,
+			 void (*in_fn)(void *priv, const void *buf, size_t len),
+			 void *priv)
+{
+    const Byte *src = inStream + LZMA_DATA_OFFSET;
+    SizeT left = length - LZMA_DATA_OFFSET;
+    CLzmaDec p;
+    SRes res;
+
+    LzmaDec_Construct(&p);
+    res = LzmaDec_AllocateProbs(&p, inStream, LZMA_PROPS_SIZE, alloc);
+    if (res != SZ_OK)
+        return res;
+    p.dic = dest;
+    p.dicBufSize = *destLen;
+    LzmaDec_Init(&p);
+
+    in_fn(priv, inStream, LZMA_DATA_OFFSET);
+    *status = LZMA_STATUS_NEEDS_MORE_INPUT;
+    while (res == SZ_OK && left && *status == LZMA_STATUS_NEEDS_MORE_INPUT) {
+        SizeT chunk = min_t(SizeT, left, LZMA_CB_CHUNK);
+
+        in_fn(priv, src, chunk);
+        res = LzmaDec_DecodeToDic(&p, *destLen, src, &chunk,
+                                  LZMA_FINISH_END, status);
+        src += chunk;
+        left -= chunk;
+        schedule();
+    }
+    if (res == SZ_OK && *status == LZMA_STATUS_NEEDS_MORE_INPUT)
+        res = SZ_ERROR_INPUT_EOF;
+
+    *destLen = p.dicPos;
+    LzmaDec_FreeProbs(&p, alloc);
+    return res;
+}
+
+static int lzmaDecompress(unsigned char *outStream, SizeT *uncompressedSize,
+			  const unsigned char *inStream, SizeT length,
+			  void (*in_fn)(void *priv, const void *buf,
+					size_t len),
+			  void *priv)
 {
     int res = SZ_ERROR_DATA;
     int i;
@@ -106,10 +150,17 @@ int lzmaBuffToBuffDecompress(unsigned char *outStream, SizeT *uncompressedSize,
 
     schedule();
 
-    res = LzmaDecode(
-        outStream, &outProcessed,
-        inStream + LZMA_DATA_OFFSET, &compressedSize,
-        inStream, LZMA_PROPS_SIZE, LZMA_FINISH_END, &state, &g_Alloc);
+    if (in_fn) {
+        if (length < LZMA_DATA_OFFSET)
+            return SZ_ERROR_INPUT_EOF;
+        res = lzmaDecodeCb(outStream, &outProcessed, inStream, length,
+                           &state, &g_Alloc, in_fn, priv);
+    } else {
+        res = LzmaDecode(
+            outStream, &outProcessed,
+            inStream + LZMA_DATA_OFFSET, &compressedSize,
+            inStream, LZMA_PROPS_SIZE, LZMA_FINISH_END, &state, &g_Alloc);
+    }
     *uncompressedSize = outProcessed;
 
     debug("LZMA: Uncompressed ............... 0x%zx\n", outProcessed);
@@ -121,4 +172,89 @@ int lzmaBuffToBuffDecompress(unsigned char *outStream, SizeT *uncompressedSize,
     return res;
 }
 
+int lzmaBuffToBuffDecompress(unsigned char *outStream, SizeT *uncompressedSize,
+			     const unsigned char *inStream, SizeT length)
+{
+    return lzmaDecompress(outStream, uncompressedSize, inStream, length,
+                          NULL, NULL);
+}
+
+int lzmaBuffToBuffDecompressCb(unsigned char *outStream,
+			       SizeT *uncompressedSize,
+			       const unsigned char *inStream, SizeT length,
+			       void (*in_fn)(void *priv, const void *buf,
+					     size_t len),
+			       void *priv)
+{
+    return lzmaDecompress(outStream, uncompressedSize, inStream, length,
+                          in_fn, priv);
+}
+
+int lzmaBuffToCbDecompress(const unsigned char *inStream, SizeT length,
+			   int (*out_fn)(void *priv, const void *buf,
+					 size_t len),
+			   void *priv, unsigned long long *uncompressedSize)
+{
+    const Byte *src = inStream + LZMA_DATA_OFFSET;
+    unsigned long long outSize = 0, total = 0;
+    ELzmaStatus status;
+    ISzAlloc g_Alloc;
+    SizeT left;
+    CLzmaDec p;
+    int ret = 0;
+    SRes res;
+    int i;
+
+    *uncompressedSize = 0;
+    if (length < LZMA_DATA_OFFSET)
+        return SZ_ERROR_INPUT_EOF;
+    left = length - LZMA_DATA_OFFSET;
+
+    /* Uncompressed size, all ones if unknown (end marker used instead) */
+    for (i = 0; i < 8; i++)
+        outSize |= (unsigned long long)inStream[LZMA_SIZE_OFFSET + i] << (i * 8);
+
+    g_Alloc.Alloc = SzAlloc;
+    g_Alloc.Free = SzFree;
+
+    /* The dictionary doubles as the output window */
+    LzmaDec_Construct(&p);
+    res = LzmaDec_Allocate(&p, inStream, LZMA_PROPS_SIZE, &g_Alloc);
+    if (res != SZ_OK)
+        return res;
+    LzmaDec_Init(&p);
+
+    do {
+        ELzmaFinishMode mode = LZMA_FINISH_ANY;
+        SizeT start, limit, chunk = left;
+
+        if (p.dicPos == p.dicBufSize)
+            p.dicPos = 0;
+        start = p.dicPos;
+        limit = p.dicBufSize;
+        if (outSize != ~0ULL && outSize - total <= limit - start) {
+            limit = start + (SizeT)(outSize - total);
+            mode = LZMA_FINISH_END;
+        }
+
+        res = LzmaDec_DecodeToDic(&p, limit, src, &chunk, mode, &status);
+        src += chunk;
+        left -= chunk;
+        if (p.dicPos > start) {
+            total += p.dicPos - start;
+            ret = out_fn(priv, p.dic + start, p.dicPos - start);
+        } else if (res == SZ_OK && !chunk &&
+                   status == LZMA_STATUS_NEEDS_MORE_INPUT) {
+            res = SZ_ERROR_INPUT_EOF;
+        }
+        schedule();
+    } while (res == SZ_OK && !ret && total != outSize &&
+             status != LZMA_STATUS_FINISHED_WITH_MARK);
+
+    LzmaDec_Free(&p, &g_Alloc);
+    *uncompressedSize = total;
+
+    return ret ? ret : res;
+}
+
 #endif
@@ -28,4 +28,49 @@
 int lzmaBuffToBuffDecompress(unsigned char *outStream, SizeT *uncompressedSize,
 			     const unsigned char *inStream, SizeT length);
 
+/**
+ * lzmaBuffToBuffDecompressCb() - Decompress LZMA data in chunks
+ *
+ * This is lzmaBuffToBuffDecompress() with a callback which is handed
+ * consecutive pieces of @inStream, in order, each one just before the
+ * decoder gets to see it.
+ *
+ * @outStream: output buffer
+ * @uncompressedSize: On entry, the maximum uncompressed size of the data;
+ *	on exit, the actual uncompressed size after processing
+ * @inStream: Compressed bytes to decompress
+ * @length: Sizeof @inStream
+ * @in_fn: Function to call with each piece of input
+ * @priv: Private data passed to @in_fn
+ * @return see lzmaBuffToBuffDecompress()
+ */
+int lzmaBuffToBuffDecompressCb(unsigned char *outStream,
+			       SizeT *uncompressedSize,
+			       const unsigned char *inStream, SizeT length,
+			       void (*in_fn)(void *priv, const void *buf,
+					     size_t len),
+			       void *priv);
+
+/**
+ * lzmaBuffToCbDecompress() - Decompress LZMA data through a callback
+ *
+ * This decompresses into the decoder's dictionary buffer, which is
+ * allocated at the size given in the stream header, and passes each new
+ * piece of output to @out_fn. The output can therefore be much larger than
+ * the memory available for it.
+ *
+ * @inStream: Compressed bytes to decompress
+ * @length: Sizeof @inStream
+ * @out_fn: Function to call with each piece of output. It returns 0 to
+ *	continue or -ve to stop decompression with that error
+ * @priv: Private data passed to @out_fn
+ * @uncompressedSize: Returns the number of bytes passed to @out_fn
+ * @return 0 if OK, -ve error from @out_fn, or an SZ_ERROR_... value (which
+ *	is positive) if the data cannot be decompressed
+ */
+int lzmaBuffToCbDecompress(const unsigned char *inStream, SizeT length,
+			   int (*out_fn)(void *priv, const void *buf,
+					 size_t len),
+			   void *priv, unsigned long long *uncompressedSize);
+
 #endif
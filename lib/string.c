@@ -20,8 +20,29 @@
 #include <linux/types.h>
 #include <linux/string.h>
 #include <linux/ctype.h>
+#include <linux/kernel.h>
 #include <malloc.h>
 
+#if CONFIG_IS_ENABLED(STRING_WORD_AT_A_TIME)
+/*
+ * The word-at-a-time functions below only read naturally aligned words.
+ * Such a word never crosses a page boundary, so reading past the end of a
+ * string within that word is safe, even if the next page is not mapped.
+ */
+#define WORD_MASK	(sizeof(unsigned long) - 1)
+
+/**
+ * has_zero_byte() - Check whether any byte in a word is zero
+ *
+ * @v: Word to check
+ * Return: true if at least one byte of @v is zero
+ */
+static inline bool has_zero_byte(unsigned long v)
+{
+	return (v - REPEAT_BYTE(0x01)) & ~v & REPEAT_BYTE(0x80);
+}
+#endif
+
 
 /**
  * strncasecmp - Case insensitive, length-limited string comparison
@@ -210,6 +231,27 @@ int strcmp(const char *cs, const char *ct)
 {
 	int ret;
 
+#if CONFIG_IS_ENABLED(STRING_WORD_AT_A_TIME)
+	/* skip over equal words, leaving the byte loop to find the end */
+	if (!(((ulong)cs ^ (ulong)ct) & WORD_MASK)) {
+		const unsigned long *w1, *w2;
+
+		for (; (ulong)cs & WORD_MASK; cs++, ct++) {
+			unsigned char a = *cs, b = *ct;
+
+			if (a != b || !b)
+				return a - b;
+		}
+		w1 = (const unsigned long *)cs;
+		w2 = (const unsigned long *)ct;
+		while (*w1 == *w2 && !has_zero_byte(*w1)) {
+			w1++;
+			w2++;
+		}
+		cs = (const char *)w1;
+		ct = (const char *)w2;
+	}
+#endif
 	while (1) {
 		unsigned char a = *cs++;
 		unsigned char b = *ct++;
@@ -255,6 +297,22 @@ int strncmp(const char *cs, const char *ct, size_t count)
  */
 char * strchr(const char * s, int c)
 {
+#if CONFIG_IS_ENABLED(STRING_WORD_AT_A_TIME)
+	unsigned long mask = REPEAT_BYTE((u8)c);
+	const unsigned long *w;
+
+	for (; (ulong)s & WORD_MASK; ++s) {
+		if (*s == (char)c)
+			return (char *)s;
+		if (*s == '\0')
+			return NULL;
+	}
+	/* stop at the first word holding either @c or the terminator */
+	for (w = (const unsigned long *)s;
+	     !has_zero_byte(*w) && !has_zero_byte(*w ^ mask); w++)
+		;
+	s = (const char *)w;
+#endif
 	for(; *s != (char) c; ++s)
 		if (*s == '\0')
 			return NULL;
@@ -294,9 +352,20 @@ char * strrchr(const char * s, int c)
  */
 size_t strlen(const char * s)
 {
-	const char *sc;
+	const char *sc = s;
+
+#if CONFIG_IS_ENABLED(STRING_WORD_AT_A_TIME)
+	const unsigned long *w;
 
-	for (sc = s; *sc != '\0'; ++sc)
+	for (; (ulong)sc & WORD_MASK; ++sc) {
+		if (*sc == '\0')
+			return sc - s;
+	}
+	for (w = (const unsigned long *)sc; !has_zero_byte(*w); w++)
+		;
+	sc = (const char *)w;
+#endif
+	for (; *sc != '\0'; ++sc)
 		/* nothing */;
 	return sc - s;
 }
@@ -310,9 +379,22 @@ size_t strlen(const char * s)
  */
 size_t strnlen(const char * s, size_t count)
 {
-	const char *sc;
+	const char *sc = s;
+
+#if CONFIG_IS_ENABLED(STRING_WORD_AT_A_TIME)
+	const unsigned long *w;
 
-	for (sc = s; count-- && *sc != '\0'; ++sc)
+	for (; count && ((ulong)sc & WORD_MASK); ++sc, count--) {
+		if (*sc == '\0')
+			return sc - s;
+	}
+	/* only whole words inside the limit are read */
+	for (w = (const unsigned long *)sc;
+	     count >= sizeof(*w) && !has_zero_byte(*w); w++)
+		count -= sizeof(*w);
+	sc = (const char *)w;
+#endif
+	for (; count-- && *sc != '\0'; ++sc)
 		/* nothing */;
 	return sc - s;
 }
@@ -530,12 +612,34 @@ __used void * memset(void * s,int c,size_t count)
 	unsigned long cl = 0;
 	int i;
 
+#if CONFIG_IS_ENABLED(MEM_WORD_AT_A_TIME)
+	/* fill 8 bits at a time until the pointer is word-aligned */
+	s8 = (char *)s;
+	if (count >= 2 * sizeof(*sl)) {
+		while ((ulong)s8 & (sizeof(*sl) - 1)) {
+			*s8++ = c;
+			count--;
+		}
+	}
+	sl = (unsigned long *)s8;
+#endif
+
 	/* do it one word at a time (32 bits or 64 bits) while possible */
-	if ( ((ulong)s & (sizeof(*sl) - 1)) == 0) {
+	if ( ((ulong)sl & (sizeof(*sl) - 1)) == 0) {
 		for (i = 0; i < sizeof(*sl); i++) {
 			cl <<= 8;
 			cl |= c & 0xff;
 		}
+#if CONFIG_IS_ENABLED(MEM_WORD_AT_A_TIME)
+		while (count >= 4 * sizeof(*sl)) {
+			sl[0] = cl;
+			sl[1] = cl;
+			sl[2] = cl;
+			sl[3] = cl;
+			sl += 4;
+			count -= 4 * sizeof(*sl);
+		}
+#endif
 		while (count >= sizeof(*sl)) {
 			*sl++ = cl;
 			count -= sizeof(*sl);
@@ -568,8 +672,37 @@ __used void * memcpy(void *dest, const void *src, size_t count)
 	if (src == dest)
 		return dest;
 
+#if CONFIG_IS_ENABLED(MEM_WORD_AT_A_TIME)
+	/*
+	 * If both pointers have the same misalignment, copy bytes up to a word
+	 * boundary so that the bulk of the data can be copied a word at a time
+	 */
+	d8 = (char *)dest;
+	s8 = (char *)src;
+	if (!(((ulong)dest ^ (ulong)src) & (sizeof(*dl) - 1)) &&
+	    count >= 2 * sizeof(*dl)) {
+		while ((ulong)d8 & (sizeof(*dl) - 1)) {
+			*d8++ = *s8++;
+			count--;
+		}
+	}
+	dl = (unsigned long *)d8;
+	sl = (unsigned long *)s8;
+#endif
+
 	/* while all data is aligned (common case), copy a word at a time */
-	if ( (((ulong)dest | (ulong)src) & (sizeof(*dl) - 1)) == 0) {
+	if ( (((ulong)dl | (ulong)sl) & (sizeof(*dl) - 1)) == 0) {
+#if CONFIG_IS_ENABLED(MEM_WORD_AT_A_TIME)
+		while (count >= 4 * sizeof(*dl)) {
+			dl[0] = sl[0];
+			dl[1] = sl[1];
+			dl[2] = sl[2];
+			dl[3] = sl[3];
+			dl += 4;
+			sl += 4;
+			count -= 4 * sizeof(*dl);
+		}
+#endif
 		while (count >= sizeof(*dl)) {
 			*dl++ = *sl++;
 			count -= sizeof(*dl);
@@ -615,6 +748,26 @@ __used void * memmove(void * dest,const void *src,size_t count)
 	} else {
 		tmp = (char *) dest + count;
 		s = (char *) src + count;
+
+#if CONFIG_IS_ENABLED(MEM_WORD_AT_A_TIME)
+		/* copy backwards a word at a time if the alignment allows it */
+		if (!(((ulong)tmp ^ (ulong)s) & (sizeof(ulong) - 1))) {
+			unsigned long *dl, *sl;
+
+			while (count && ((ulong)tmp & (sizeof(*dl) - 1))) {
+				*--tmp = *--s;
+				count--;
+			}
+			dl = (unsigned long *)tmp;
+			sl = (unsigned long *)s;
+			while (count >= sizeof(*dl)) {
+				*--dl = *--sl;
+				count -= sizeof(*dl);
+			}
+			tmp = (char *)dl;
+			s = (char *)sl;
+		}
+#endif
 		while (count--)
 			*--tmp = *--s;
 		}
@@ -635,7 +788,34 @@ __used int memcmp(const void * cs,const void * ct,size_t count)
 	const unsigned char *su1, *su2;
 	int res = 0;
 
-	for( su1 = cs, su2 = ct; 0 < count; ++su1, ++su2, count--)
+	su1 = cs;
+	su2 = ct;
+
+#if CONFIG_IS_ENABLED(MEM_WORD_AT_A_TIME)
+	/* skip over equal words, leaving the byte loop to find a difference */
+	if (!(((ulong)su1 ^ (ulong)su2) & (sizeof(ulong) - 1))) {
+		const unsigned long *l1, *l2;
+
+		while (count && ((ulong)su1 & (sizeof(*l1) - 1))) {
+			if ((res = *su1 - *su2) != 0)
+				return res;
+			su1++;
+			su2++;
+			count--;
+		}
+		l1 = (const unsigned long *)su1;
+		l2 = (const unsigned long *)su2;
+		while (count >= sizeof(*l1) && *l1 == *l2) {
+			l1++;
+			l2++;
+			count -= sizeof(*l1);
+		}
+		su1 = (const unsigned char *)l1;
+		su2 = (const unsigned char *)l2;
+	}
+#endif
+
+	for (; 0 < count; ++su1, ++su2, count--)
 		if ((res = *su1 - *su2) != 0)
 			break;
 	return res;
@@ -716,6 +896,20 @@ char * strstr(const char * s1,const char * s2)
 void *memchr(const void *s, int c, size_t n)
 {
 	const unsigned char *p = s;
+
+#if CONFIG_IS_ENABLED(STRING_WORD_AT_A_TIME)
+	unsigned long mask = REPEAT_BYTE((u8)c);
+	const unsigned long *w;
+
+	for (; n && ((ulong)p & WORD_MASK); p++, n--) {
+		if ((unsigned char)c == *p)
+			return (void *)p;
+	}
+	for (w = (const unsigned long *)p;
+	     n >= sizeof(*w) && !has_zero_byte(*w ^ mask); w++)
+		n -= sizeof(*w);
+	p = (const unsigned char *)w;
+#endif
 	while (n-- != 0) {
 		if ((unsigned char)c == *p++) {
 			return (void *)(p-1);
@@ -8,4 +8,18 @@
    subject to change. Applications should only use zlib.h.
  */
 
+/*
+ * Minimum input and output space inflate() must have available before it
+ * hands over to inflate_fast().  The wide variant refills its bit buffer
+ * with a single 8-byte load and may write up to 7 bytes past the end of a
+ * match, so it needs a little more slack on both sides.
+ */
+#ifdef CONFIG_ZLIB_INFLATE_FAST_WIDE
+#  define INFLATE_FAST_MIN_HAVE 8
+#  define INFLATE_FAST_MIN_LEFT 266
+#else
+#  define INFLATE_FAST_MIN_HAVE 6
+#  define INFLATE_FAST_MIN_LEFT 258
+#endif
+
 void inflate_fast OF((z_streamp strm, unsigned start));
@@ -9,53 +9,376 @@
 #include <abuf.h>
 #include <log.h>
 #include <malloc.h>
+#include <asm/global_data.h>
+#include <linux/kernel.h>
 #include <linux/zstd.h>
 
-int zstd_decompress(struct abuf *in, struct abuf *out)
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct zstd_pool_ent - A decompression workspace kept between calls
+ *
+ * zstd_init_dctx() places the context at the start of its workspace, which
+ * malloc() aligns suitably, so the context and workspace pointers are the
+ * same. zstd_put_dctx() relies on this to find the workspace to reuse or
+ * free.
+ *
+ * @workspace: Workspace holding the context, NULL if not allocated yet
+ * @busy: true if the context is currently handed out
+ */
+struct zstd_pool_ent {
+	void *workspace;
+	bool busy;
+};
+
+static struct zstd_pool_ent zstd_pool[CONFIG_ZSTD_DCTX_POOL];
+
+/**
+ * zstd_pool_ready() - Check whether the pool of contexts can be used
+ *
+ * Return: true if the full malloc() is ready, else false
+ */
+static bool zstd_pool_ready(void)
 {
+	return gd->flags & GD_FLG_FULL_MALLOC_INIT;
+}
+
+/**
+ * zstd_get_dctx() - Get a decompression context
+ *
+ * This hands out a free context from the pool, allocating its workspace on
+ * first use, or allocates a one-off context if the pool is exhausted or not
+ * ready yet. The pool is not used before relocation, since a workspace kept
+ * in the pre-relocation malloc() area would not be valid afterwards, and BSS
+ * may not be usable yet.
+ *
+ * Return: initialised context, or NULL if out of memory
+ */
+static zstd_dctx *zstd_get_dctx(void)
+{
+	size_t wsize = zstd_dctx_workspace_bound();
+	struct zstd_pool_ent *ent = NULL;
 	zstd_dctx *ctx;
-	size_t wsize, len;
 	void *workspace;
-	int ret;
+	int i;
 
-	wsize = zstd_dctx_workspace_bound();
-	workspace = malloc(wsize);
-	if (!workspace) {
-		debug("%s: cannot allocate workspace of size %zu\n", __func__,
-			wsize);
-		return -ENOMEM;
+	for (i = 0; zstd_pool_ready() && i < ARRAY_SIZE(zstd_pool); i++) {
+		if (!zstd_pool[i].busy) {
+			ent = &zstd_pool[i];
+			break;
+		}
+	}
+
+	if (ent && ent->workspace) {
+		workspace = ent->workspace;
+	} else {
+		workspace = malloc(wsize);
+		if (!workspace) {
+			debug("%s: cannot allocate workspace of size %zu\n",
+			      __func__, wsize);
+			return NULL;
+		}
 	}
 
 	ctx = zstd_init_dctx(workspace, wsize);
 	if (!ctx) {
 		log_err("%s: zstd_init_dctx() failed\n", __func__);
-		ret = -EPERM;
-		goto do_free;
+		if (!ent || workspace != ent->workspace)
+			free(workspace);
+		return NULL;
+	}
+	if (ent) {
+		ent->workspace = workspace;
+		ent->busy = true;
+	}
+
+	return ctx;
+}
+
+/**
+ * zstd_put_dctx() - Release a context obtained from zstd_get_dctx()
+ *
+ * @ctx: Context to release
+ */
+static void zstd_put_dctx(zstd_dctx *ctx)
+{
+	int i;
+
+	/* The context is at the start of its workspace, see zstd_pool_ent */
+	for (i = 0; zstd_pool_ready() && i < ARRAY_SIZE(zstd_pool); i++) {
+		if (zstd_pool[i].workspace == (void *)ctx) {
+			zstd_pool[i].busy = false;
+			return;
+		}
+	}
+	free(ctx);
+}
+
+/**
+ * zstd_next_frame() - Check whether a zstd or skippable frame follows
+ *
+ * @src: Remaining input
+ * @len: Number of bytes remaining
+ * Return: true if @src starts with a frame, false if it is empty or junk
+ */
+static bool zstd_next_frame(const void *src, size_t len)
+{
+	return len && ZSTD_isFrame(src, len);
+}
+
+int zstd_decompress_dict(struct abuf *in, struct abuf *out,
+			 const zstd_ddict *ddict)
+{
+	const u8 *src = abuf_data(in);
+	size_t src_left = abuf_size(in);
+	u8 *dst = abuf_data(out);
+	size_t dst_left = abuf_size(out);
+	zstd_dctx *ctx;
+	size_t len;
+	int ret;
+
+	if (!zstd_next_frame(src, src_left)) {
+		log_err("%s: no zstd frame found\n", __func__);
+		return -EINVAL;
 	}
 
+	ctx = zstd_get_dctx();
+	if (!ctx)
+		return -ENOMEM;
+
 	/*
-	 * Find out how large the frame actually is, there may be junk at
-	 * the end of the frame that zstd_decompress_dctx() can't handle.
+	 * Decompress one frame at a time, stopping at the first thing which
+	 * is not a frame: there may be junk at the end of the data that
+	 * zstd_decompress_dctx() can't handle.
 	 */
-	len = zstd_find_frame_compressed_size(abuf_data(in), abuf_size(in));
-	if (zstd_is_error(len)) {
-		log_err("%s: failed to detect compressed size: %d\n", __func__,
-			zstd_get_error_code(len));
-		ret = -EINVAL;
-		goto do_free;
+	while (zstd_next_frame(src, src_left)) {
+		len = zstd_find_frame_compressed_size(src, src_left);
+		if (zstd_is_error(len)) {
+			log_err("%s: failed to detect compressed size: %d\n",
+				__func__, zstd_get_error_code(len));
+			ret = -EINVAL;
+			goto do_put;
+		}
+
+		if (!zstd_is_skippable_frame(src, len)) {
+			size_t out_len;
+
+			if (ddict)
+				out_len = zstd_decompress_using_ddict(ctx, dst,
+								      dst_left,
+								      src, len,
+								      ddict);
+			else
+				out_len = zstd_decompress_dctx(ctx, dst,
+							       dst_left, src,
+							       len);
+			if (zstd_is_error(out_len)) {
+				log_err("%s: failed to decompress: %d\n",
+					__func__, zstd_get_error_code(out_len));
+				ret = -EINVAL;
+				goto do_put;
+			}
+			dst += out_len;
+			dst_left -= out_len;
+		}
+		src += len;
+		src_left -= len;
 	}
 
-	len = zstd_decompress_dctx(ctx, abuf_data(out), abuf_size(out),
-				   abuf_data(in), len);
+	ret = dst - (u8 *)abuf_data(out);
+do_put:
+	zstd_put_dctx(ctx);
+	return ret;
+}
+
+int zstd_decompress(struct abuf *in, struct abuf *out)
+{
+	return zstd_decompress_dict(in, out, NULL);
+}
+
+int zstd_decompress_cb(struct abuf *in, struct abuf *out,
+		       void (*in_fn)(void *priv, const void *buf, size_t len),
+		       void *priv)
+{
+	const u8 *src = abuf_data(in);
+	size_t src_left = abuf_size(in);
+	u8 *dst = abuf_data(out);
+	size_t dst_left = abuf_size(out);
+	zstd_dctx *ctx;
+	size_t len, need;
+	int ret;
+
+	ctx = zstd_get_dctx();
+	if (!ctx)
+		return -ENOMEM;
+
+	/*
+	 * Use the buffer-less API so that each block is decoded straight
+	 * into @out, right after its compressed bytes are passed to @in_fn.
+	 * This also steps over skippable frames.
+	 */
+	len = ZSTD_decompressBegin(ctx);
+	while (!zstd_is_error(len)) {
+		need = ZSTD_nextSrcSizeToDecompress(ctx);
+		if (!need) {
+			/* end of frame, carry on if another one follows */
+			if (!zstd_next_frame(src, src_left))
+				break;
+			len = ZSTD_decompressBegin(ctx);
+			continue;
+		}
+		if (need > src_left) {
+			log_err("%s: truncated frame\n", __func__);
+			ret = -EINVAL;
+			goto do_put;
+		}
+		in_fn(priv, src, need);
+		len = ZSTD_decompressContinue(ctx, dst, dst_left, src, need);
+		if (zstd_is_error(len))
+			break;
+		src += need;
+		src_left -= need;
+		dst += len;
+		dst_left -= len;
+	}
 	if (zstd_is_error(len)) {
 		log_err("%s: failed to decompress: %d\n", __func__,
 			zstd_get_error_code(len));
 		ret = -EINVAL;
+		goto do_put;
+	}
+
+	ret = dst - (u8 *)abuf_data(out);
+do_put:
+	zstd_put_dctx(ctx);
+	return ret;
+}
+
+/**
+ * zstd_max_window() - Find the largest window size used by any frame
+ *
+ * @src: Input data
+ * @src_left: Size of input data
+ * Return: largest window size, or -ve on error
+ */
+static long zstd_max_window(const u8 *src, size_t src_left)
+{
+	zstd_frame_header hdr;
+	size_t max = 0, len;
+
+	if (!zstd_next_frame(src, src_left))
+		return -EINVAL;
+
+	while (zstd_next_frame(src, src_left)) {
+		len = zstd_get_frame_header(&hdr, src, src_left);
+		if (len)	/* error, or truncated header */
+			return -EINVAL;
+		max = max(max, (size_t)hdr.windowSize);
+
+		len = zstd_find_frame_compressed_size(src, src_left);
+		if (zstd_is_error(len))
+			return -EINVAL;
+		src += len;
+		src_left -= len;
+	}
+
+	return max;
+}
+
+int zstd_decompress_window(struct abuf *in, struct abuf *win,
+			   int (*out_fn)(void *priv, const void *buf,
+					 size_t len),
+			   void *priv, const zstd_ddict *ddict,
+			   unsigned long long *sizep)
+{
+	zstd_in_buffer ibuf;
+	zstd_out_buffer obuf;
+	zstd_dstream *ds;
+	size_t wsize, len;
+	void *workspace;
+	unsigned long long total = 0;
+	long window;
+	int ret;
+
+	window = zstd_max_window(abuf_data(in), abuf_size(in));
+	if (window < 0) {
+		log_err("%s: invalid zstd frame header\n", __func__);
+		return window;
+	}
+
+	wsize = zstd_dstream_workspace_bound(window);
+	workspace = malloc(wsize);
+	if (!workspace) {
+		debug("%s: cannot allocate workspace of size %zu\n", __func__,
+		      wsize);
+		return -ENOMEM;
+	}
+	ds = zstd_init_dstream(window, workspace, wsize);
+	if (!ds || zstd_is_error(zstd_dctx_ref_ddict(ds, ddict))) {
+		log_err("%s: zstd_init_dstream() failed\n", __func__);
+		ret = -EPERM;
 		goto do_free;
 	}
 
-	ret = len;
+	ibuf.src = abuf_data(in);
+	ibuf.size = abuf_size(in);
+	ibuf.pos = 0;
+	do {
+		size_t in_pos = ibuf.pos;
+
+		obuf.dst = abuf_data(win);
+		obuf.size = abuf_size(win);
+		obuf.pos = 0;
+		len = zstd_decompress_stream(ds, &obuf, &ibuf);
+		if (zstd_is_error(len)) {
+			log_err("%s: failed to decompress: %d\n", __func__,
+				zstd_get_error_code(len));
+			ret = -EINVAL;
+			goto do_free;
+		}
+		if (!obuf.pos && ibuf.pos == in_pos) {
+			log_err("%s: truncated frame\n", __func__);
+			ret = -EINVAL;
+			goto do_free;
+		}
+		if (obuf.pos) {
+			ret = out_fn(priv, obuf.dst, obuf.pos);
+			if (ret)
+				goto do_free;
+			total += obuf.pos;
+		}
+		/* a frame is fully flushed when len is 0; look for another */
+	} while (len ||
+		 zstd_next_frame(ibuf.src + ibuf.pos, ibuf.size - ibuf.pos));
+
+	if (sizep)
+		*sizep = total;
+	ret = 0;
 do_free:
 	free(workspace);
 	return ret;
 }
+
+const zstd_ddict *zstd_ddict_create(const void *dict, size_t dict_size)
+{
+	size_t wsize = zstd_ddict_workspace_bound(dict_size);
+	const zstd_ddict *ddict;
+	void *workspace;
+
+	workspace = malloc(wsize);
+	if (!workspace)
+		return NULL;
+	ddict = zstd_init_ddict(dict, dict_size, workspace, wsize);
+	if (!ddict) {
+		log_err("%s: invalid dictionary\n", __func__);
+		free(workspace);
+	}
+
+	return ddict;
+}
+
+void zstd_ddict_free(const zstd_ddict *ddict)
+{
+	/* The dictionary is emplaced at the start of its workspace */
+	free((void *)ddict);
+}
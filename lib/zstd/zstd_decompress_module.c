@@ -101,5 +101,42 @@ size_t zstd_get_frame_header(zstd_frame_header *header, const void *src,
 }
 EXPORT_SYMBOL(zstd_get_frame_header);
 
+unsigned int zstd_is_skippable_frame(const void *src, size_t src_size)
+{
+	return ZSTD_isSkippableFrame(src, src_size);
+}
+EXPORT_SYMBOL(zstd_is_skippable_frame);
+
+size_t zstd_ddict_workspace_bound(size_t dict_size)
+{
+	return ZSTD_estimateDDictSize(dict_size, ZSTD_dlm_byRef);
+}
+EXPORT_SYMBOL(zstd_ddict_workspace_bound);
+
+const zstd_ddict *zstd_init_ddict(const void *dict, size_t dict_size,
+	void *workspace, size_t workspace_size)
+{
+	if (workspace == NULL)
+		return NULL;
+	return ZSTD_initStaticDDict(workspace, workspace_size, dict, dict_size,
+		ZSTD_dlm_byRef, ZSTD_dct_auto);
+}
+EXPORT_SYMBOL(zstd_init_ddict);
+
+size_t zstd_decompress_using_ddict(zstd_dctx *dctx, void *dst,
+	size_t dst_capacity, const void *src, size_t src_size,
+	const zstd_ddict *ddict)
+{
+	return ZSTD_decompress_usingDDict(dctx, dst, dst_capacity, src,
+		src_size, ddict);
+}
+EXPORT_SYMBOL(zstd_decompress_using_ddict);
+
+size_t zstd_dctx_ref_ddict(zstd_dctx *dctx, const zstd_ddict *ddict)
+{
+	return ZSTD_DCtx_refDDict(dctx, ddict);
+}
+EXPORT_SYMBOL(zstd_dctx_ref_ddict);
+
 MODULE_LICENSE("Dual BSD/GPL");
 MODULE_DESCRIPTION("Zstd Decompressor");
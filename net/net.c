@@ -166,6 +166,10 @@ int		net_restart_wrap;
 static int	net_restarted;
 /* At least one device configured */
 static int	net_dev_exists;
+/* Number of net_batch_start() calls not yet matched by net_batch_end() */
+static int	net_batch_depth;
+/* Device left running by the last transfer in a batch */
+static bool	net_batch_up;
 
 /* XXX in both little & big endian machines 0xFFFF == ntohs(-1) */
 /* default is without VLAN */
@@ -440,7 +444,11 @@ int net_loop(enum proto_t protocol)
 
 	bootstage_mark_name(BOOTSTAGE_ID_ETH_START, "eth_start");
 	net_init();
-	if (eth_is_on_demand_init()) {
+	if (net_batch_up) {
+		/* still running from the last transfer in this batch */
+		net_batch_up = false;
+		eth_init_state_only();
+	} else if (eth_is_on_demand_init()) {
 		eth_halt();
 		eth_set_current();
 		ret = eth_init();
@@ -689,10 +697,15 @@ restart:
 				env_set_hex("filesize", net_boot_file_size);
 				env_set_hex("fileaddr", image_load_addr);
 			}
-			if (protocol != NETCONS && protocol != NCSI)
-				eth_halt();
-			else
+			if (protocol == NETCONS || protocol == NCSI) {
 				eth_halt_state_only();
+			} else if (net_batch_depth) {
+				/* leave the device running for the next one */
+				eth_halt_state_only();
+				net_batch_up = true;
+			} else {
+				eth_halt();
+			}
 
 			eth_set_last_protocol(protocol);
 
@@ -733,6 +746,28 @@ done:
 
 /**********************************************************************/
 
+void net_batch_start(void)
+{
+	net_batch_depth++;
+}
+
+void net_batch_end(void)
+{
+	if (!net_batch_depth || --net_batch_depth)
+		return;
+	if (net_batch_up) {
+		net_batch_up = false;
+		eth_halt();
+	}
+}
+
+bool net_batch_active(void)
+{
+	return net_batch_depth;
+}
+
+/**********************************************************************/
+
 static void start_again_timeout_handler(void)
 {
 	net_set_state(NETLOOP_RESTART);
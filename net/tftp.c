@@ -68,6 +68,8 @@ enum {
 };
 
 static struct in_addr tftp_remote_ip;
+/* The server used by the last transfer, for reusing its Ethernet address */
+static struct in_addr tftp_last_remote_ip;
 /* The UDP port at their end */
 static int	tftp_remote_port;
 /* The UDP port at our end */
@@ -720,6 +722,7 @@ static int tftp_init_load_addr(void)
 	lmb_init_and_reserve(&lmb, gd->bd, (void *)gd->fdt_blob);
 
 	max_size = lmb_get_free_size(&lmb, image_load_addr);
+	lmb_uninit(&lmb);
 	if (!max_size)
 		return -1;
 
@@ -946,8 +949,15 @@ void tftp_start(enum proto_t protocol)
 	tftp_cur_block = 0;
 	tftp_windowsize = 1;
 	tftp_last_nack = 0;
-	/* zero out server ether in case the server ip has changed */
-	memset(net_server_ethaddr, 0, 6);
+	/*
+	 * zero out server ether in case the server ip has changed; within a
+	 * batch the address found for the same server is used again, to save
+	 * an ARP round trip for each file
+	 */
+	if (!net_batch_active() || (IS_ENABLED(CONFIG_IPV6) && use_ip6) ||
+	    tftp_remote_ip.s_addr != tftp_last_remote_ip.s_addr)
+		memset(net_server_ethaddr, 0, 6);
+	tftp_last_remote_ip = tftp_remote_ip;
 	/* Revert tftp_block_size to dflt */
 	tftp_block_size = TFTP_BLOCK_SIZE;
 #ifdef CONFIG_TFTP_TSIZE
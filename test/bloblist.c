@@ -5,7 +5,10 @@
 
 #include <common.h>
 #include <bloblist.h>
+#include <bootstage.h>
+#include <console.h>
 #include <log.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <asm/global_data.h>
 #include <test/suites.h>
@@ -608,6 +611,69 @@ static int bloblist_test_blob_maxsize(struct unit_test_state *uts)
 }
 BLOBLIST_TEST(bloblist_test_blob_maxsize, 0);
 
+/**
+ * check_bootstage_stash() - Pass records from one bootstage table to another
+ *
+ * This replaces gd->bootstage with a new table, which the caller must free
+ *
+ * @uts: Test state
+ * Return: 0 if OK, CMD_RET_FAILURE on failure
+ */
+static int check_bootstage_stash(struct unit_test_state *uts)
+{
+	int found1 = 0, found2 = 0;
+
+	/* start with an empty table so the stash fits in the test bloblist */
+	ut_assertok(bootstage_init(true));
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "bloblist_test1");
+	ut_assertok(bootstage_stash_default());
+	ut_assertnonnull(bloblist_find(BLOBLISTT_U_BOOT_BOOTSTAGE, 0));
+
+	/* a second stash replaces the first, e.g. TPL then SPL */
+	bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "bloblist_test2");
+	ut_assertok(bootstage_stash_default());
+
+	/* the next phase starts with an empty table and reads them back */
+	free(gd->bootstage);
+	ut_assertok(bootstage_init(false));
+	ut_assertok(bootstage_unstash_default());
+	console_record_reset_enable();
+	bootstage_report();
+
+	/* both records must be reported, each once */
+	while (console_record_avail()) {
+		ut_assert(console_record_readline(uts->actual_str,
+						  sizeof(uts->actual_str)) >= 0);
+		if (strstr(uts->actual_str, "bloblist_test1"))
+			found1++;
+		if (strstr(uts->actual_str, "bloblist_test2"))
+			found2++;
+	}
+	ut_asserteq(1, found1);
+	ut_asserteq(1, found2);
+
+	return 0;
+}
+
+/* Test passing bootstage records to the next phase in the bloblist */
+static int bloblist_test_bootstage(struct unit_test_state *uts)
+{
+	struct bootstage_data *old = gd->bootstage;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_BOOTSTAGE_STASH_BLOBLIST))
+		return -EAGAIN;
+
+	clear_bloblist();
+	ut_assertok(bloblist_new(TEST_ADDR, TEST_BLOBLIST_SIZE, 0));
+	ret = check_bootstage_stash(uts);
+	free(gd->bootstage);
+	gd->bootstage = old;
+
+	return ret;
+}
+BLOBLIST_TEST(bloblist_test_bootstage, UT_TESTF_CONSOLE_REC);
+
 int do_ut_bloblist(struct cmd_tbl *cmdtp, int flag, int argc,
 		   char *const argv[])
 {
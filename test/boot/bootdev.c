@@ -429,7 +429,9 @@ static int bootdev_test_hunt_scan(struct unit_test_state *uts)
 	ut_assertok(bootflow_scan_first(NULL, NULL, &iter,
 					BOOTFLOWF_SHOW | BOOTFLOWF_HUNT |
 					BOOTFLOWF_SKIP_GLOBAL, &bflow));
-	ut_asserteq(BIT(MMC_HUNTER) | BIT(1), std->hunters_used);
+
+	/* a bootflow is found on an existing MMC bootdev, with no hunting */
+	ut_asserteq(BIT(1), std->hunters_used);
 
 	return 0;
 }
@@ -670,10 +672,10 @@ static int bootdev_test_next_prio(struct unit_test_state *uts)
 	ut_asserteq_str("mmc2.bootdev", dev->name);
 	ut_assert_nextline("Hunting with: simple_bus");
 	ut_assert_nextline("Found 2 extension board(s).");
-	ut_assert_nextline("Hunting with: mmc");
 	ut_assert_console_end();
 
-	ut_asserteq(BIT(MMC_HUNTER) | BIT(1), std->hunters_used);
+	/* the MMC bootdevs already exist, so the MMC hunter is not needed yet */
+	ut_asserteq(BIT(1), std->hunters_used);
 
 	ut_assertok(bootdev_next_prio(&iter, &dev));
 	ut_asserteq_str("mmc1.bootdev", dev->name);
@@ -684,14 +686,14 @@ static int bootdev_test_next_prio(struct unit_test_state *uts)
 
 	ut_assertok(bootdev_next_prio(&iter, &dev));
 	ut_asserteq_str("spi.bin@0.bootdev", dev->name);
-	ut_assert_skip_to_line("Hunting with: spi_flash");
+	ut_assert_nextline("Hunting with: mmc");
 
 	/*
-	 * this scans all bootdevs of priority BOOTDEVP_4_SCAN_FAST before it
-	 * starts looking at the devices, so we se virtio as well
+	 * the SPI-flash bootdevs already exist, so they are used before any
+	 * hunter of priority BOOTDEVP_4_SCAN_FAST runs
 	 */
-	ut_assert_nextline("Hunting with: virtio");
 	ut_assert_nextlinen("SF: Detected m25p16");
+	ut_asserteq(BIT(MMC_HUNTER) | BIT(1), std->hunters_used);
 
 	ut_assertok(bootdev_next_prio(&iter, &dev));
 	ut_asserteq_str("spi.bin@1.bootdev", dev->name);
@@ -713,3 +715,46 @@ static int bootdev_test_next_prio(struct unit_test_state *uts)
 }
 BOOTSTD_TEST(bootdev_test_next_prio, UT_TESTF_DM | UT_TESTF_SCAN_FDT |
 	     UT_TESTF_SF_BOOTDEV);
+
+/* Check moving on after a hunter which rebinds bootdevs of the same priority */
+static int bootdev_test_next_prio_rebind(struct unit_test_state *uts)
+{
+	struct bootdev_uc_plat *plat;
+	struct bootflow_iter iter;
+	struct bootstd_priv *std;
+	struct udevice *dev;
+	int ret;
+
+	test_set_skip_delays(true);
+	ut_assertok(bootstd_get_priv(&std));
+
+	/* bind the SCSI bootdev, which scsi_scan() unbinds and binds again */
+	ut_assertok(run_command("scsi scan", 0));
+
+	memset(&iter, '\0', sizeof(iter));
+	iter.cur_prio = BOOTDEVP_4_SCAN_FAST;
+	iter.flags = BOOTFLOWF_HUNT;
+
+	/* the existing bootdev is used first, without hunting */
+	dev = NULL;
+	ut_assertok(bootdev_next_prio(&iter, &dev));
+	ut_asserteq_str("scsi.id0lun0.bootdev", dev->name);
+	ut_asserteq(0, std->hunters_used);
+
+	/* the SCSI hunter replaces it, so the new one is used next */
+	ut_assertok(bootdev_next_prio(&iter, &dev));
+	ut_asserteq_str("scsi.id0lun0.bootdev", dev->name);
+	plat = dev_get_uclass_plat(dev);
+	ut_assert(!plat->old);
+	ut_asserteq(BIT(6) | BIT(5) | BIT(4), std->hunters_used);
+
+	/* it is not used again after the other hunters of this priority */
+	while (!(ret = bootdev_next_prio(&iter, &dev)) &&
+	       iter.cur_prio == BOOTDEVP_4_SCAN_FAST)
+		ut_assert(strcmp("scsi.id0lun0.bootdev", dev->name));
+	ut_assertok(ret);
+	ut_asserteq(BOOTDEVP_5_SCAN_SLOW, iter.cur_prio);
+
+	return 0;
+}
+BOOTSTD_TEST(bootdev_test_next_prio_rebind, UT_TESTF_DM | UT_TESTF_SCAN_FDT);
@@ -13,6 +13,7 @@
 #include <bootstd.h>
 #include <cli.h>
 #include <dm.h>
+#include <env.h>
 #include <expo.h>
 #ifdef CONFIG_SANDBOX
 #include <asm/test.h>
@@ -266,6 +267,100 @@ static int bootflow_scan_boot(struct unit_test_state *uts)
 }
 BOOTSTD_TEST(bootflow_scan_boot, UT_TESTF_DM | UT_TESTF_SCAN_FDT);
 
+/* Check using the bootflow cache to avoid scanning */
+static int bootflow_cache(struct unit_test_state *uts)
+{
+	struct bootflow_iter iter;
+	struct bootflow bflow;
+	char rec[256], *p;
+	const char *val;
+	int flags, num;
+
+	if (!IS_ENABLED(CONFIG_BOOTSTD_CACHE))
+		return -EAGAIN;
+
+	ut_assertok(bootstd_test_drop_bootdev_order(uts));
+	ut_assertok(env_set(BOOTFLOW_CACHE_VAR, NULL));
+	flags = BOOTFLOWF_CACHE | BOOTFLOWF_SHOW | BOOTFLOWF_SKIP_GLOBAL;
+
+	/* with nothing in the cache, the scan finds the mmc1 bootflow */
+	console_record_reset_enable();
+	ut_assertok(bootflow_scan_first(NULL, NULL, &iter, flags, &bflow));
+	ut_asserteq(0, iter.flags & BOOTFLOWF_CACHED);
+	ut_asserteq_str("mmc1.bootdev.part_1", bflow.name);
+	ut_assert_skip_to_line("Scanning bootdev 'mmc1.bootdev':");
+	ut_assert_console_end();
+
+	ut_assertok(bootflow_cache_save(&bflow));
+	val = env_get(BOOTFLOW_CACHE_VAR);
+	ut_assertnonnull(val);
+	ut_asserteq_strn("mmc1.bootdev 1 syslinux /extlinux/extlinux.conf ",
+			 val);
+	strlcpy(rec, val, sizeof(rec));
+	bootflow_free(&bflow);
+	bootflow_iter_uninit(&iter);
+
+	/* now the bootflow comes straight from the cache */
+	ut_assertok(bootflow_scan_first(NULL, NULL, &iter, flags, &bflow));
+	ut_assert(iter.flags & BOOTFLOWF_CACHED);
+	ut_asserteq_str("mmc1.bootdev.part_1", bflow.name);
+	ut_asserteq(BOOTFLOWST_READY, bflow.state);
+	ut_assert_console_end();
+	bootflow_free(&bflow);
+
+	/* if that does not boot, the scan starts but skips that bootflow */
+	ut_asserteq(-ENODEV, bootflow_scan_next(&iter, &bflow));
+	ut_assert_skip_to_line("Scanning bootdev 'mmc1.bootdev':");
+	bootflow_iter_uninit(&iter);
+
+	/* an unsupported bootmeth can be dropped before the scan starts */
+	ut_assertok(bootflow_scan_first(NULL, NULL, &iter, flags, &bflow));
+	ut_assert(iter.flags & BOOTFLOWF_CACHED);
+	num = iter.num_methods;
+	ut_assertok(bootflow_iter_drop_bootmeth(&iter, bflow.method));
+	bootflow_free(&bflow);
+	ut_asserteq(-ENODEV, bootflow_scan_next(&iter, &bflow));
+	ut_asserteq(num - 1, iter.num_methods);
+	bootflow_iter_uninit(&iter);
+
+	/* a different bootdev order means that the cache is not used */
+	ut_assertok(env_set("boot_targets", "mmc1"));
+	ut_assertok(bootflow_scan_first(NULL, NULL, &iter, flags, &bflow));
+	ut_asserteq(0, iter.flags & BOOTFLOWF_CACHED);
+	ut_asserteq_str("mmc1.bootdev.part_1", bflow.name);
+	bootflow_free(&bflow);
+	bootflow_iter_uninit(&iter);
+	ut_assertok(env_set("boot_targets", NULL));
+
+	/* a changed bootflow file means that the cache is not used */
+	p = strrchr(rec, ' ') - 1;
+	*p = *p == '0' ? '1' : '0';
+	ut_assertok(env_set(BOOTFLOW_CACHE_VAR, rec));
+	console_record_reset_enable();
+	ut_assertok(bootflow_scan_first(NULL, NULL, &iter, flags, &bflow));
+	ut_asserteq(0, iter.flags & BOOTFLOWF_CACHED);
+	ut_asserteq_str("mmc1.bootdev.part_1", bflow.name);
+	ut_assert_skip_to_line("Scanning bootdev 'mmc1.bootdev':");
+
+	/* this updates the cache */
+	ut_assertok(bootflow_cache_save(&bflow));
+	ut_assert(strcmp(rec, env_get(BOOTFLOW_CACHE_VAR)));
+	bootflow_free(&bflow);
+	bootflow_iter_uninit(&iter);
+
+	/* the cache is not used unless asked for */
+	ut_assertok(bootflow_scan_first(NULL, NULL, &iter,
+					flags & ~BOOTFLOWF_CACHE, &bflow));
+	ut_asserteq(0, iter.flags & BOOTFLOWF_CACHED);
+	bootflow_free(&bflow);
+	bootflow_iter_uninit(&iter);
+
+	ut_assertok(env_set(BOOTFLOW_CACHE_VAR, NULL));
+
+	return 0;
+}
+BOOTSTD_TEST(bootflow_cache, UT_TESTF_DM | UT_TESTF_SCAN_FDT);
+
 /* Check iterating through available bootflows */
 static int bootflow_iter(struct unit_test_state *uts)
 {
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the 'membench' command
+ */
+
+#include <common.h>
+#include <console.h>
+#include <test/ut.h>
+
+/* Declare a new mem test */
+#define MEM_TEST(_name, _flags)	UNIT_TEST(_name, _flags, mem_test)
+
+/* Test 'membench' reports each operation at each alignment */
+static int mem_test_bench(struct unit_test_state *uts)
+{
+	static const char *const ops[] = {
+		"memcpy", "memmove", "memset", "memcmp",
+	};
+	static const int aligns[][2] = {
+		{ 0, 0 }, { 1, 1 }, { 0, 1 }, { 3, 6 },
+	};
+	char expect[40];
+	int i, j;
+
+	ut_assertok(console_record_reset_enable());
+	ut_assertok(run_command("membench 1000 10", 0));
+	ut_assert_nextline("op       dst/src       size         us       MB/s");
+	for (i = 0; i < ARRAY_SIZE(ops); i++) {
+		for (j = 0; j < ARRAY_SIZE(aligns); j++) {
+			snprintf(expect, sizeof(expect), "%-8s %3d/%-3d %10d",
+				 ops[i], aligns[j][0], aligns[j][1], 0x1000);
+			ut_assert_nextlinen(expect);
+		}
+	}
+	ut_assert_console_end();
+
+	/* a zero size is not allowed */
+	ut_asserteq(1, run_command("membench 0", 0));
+
+	return 0;
+}
+MEM_TEST(mem_test_bench, UT_TESTF_CONSOLE_REC);
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the slab front-end of malloc()
+ */
+
+#include <common.h>
+#include <command.h>
+#include <console.h>
+#include <malloc.h>
+#include <test/common.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+/* Number of objects to allocate, enough to need more than one page */
+#define SLAB_TEST_COUNT	200
+
+/* Size class used for the tests, and its object size */
+#define SLAB_TEST_CLASS	1
+#define SLAB_TEST_SIZE	32
+
+/* Test that small allocations come from the slabs and are counted */
+static int common_test_malloc_slab(struct unit_test_state *uts)
+{
+	struct malloc_slab_stats before, stats;
+	u8 *ptr[SLAB_TEST_COUNT];
+	int i, j;
+
+	ut_assertok(malloc_slab_get_stats(SLAB_TEST_CLASS, &before));
+	ut_asserteq(SLAB_TEST_SIZE, before.size);
+
+	for (i = 0; i < SLAB_TEST_COUNT; i++) {
+		ptr[i] = malloc(SLAB_TEST_SIZE - 8 + i % 8);
+		ut_assertnonnull(ptr[i]);
+		ut_assert(malloc_slab_owns(ptr[i]));
+		ut_asserteq(SLAB_TEST_SIZE, malloc_usable_size(ptr[i]));
+		memset(ptr[i], i, SLAB_TEST_SIZE);
+	}
+
+	ut_assertok(malloc_slab_get_stats(SLAB_TEST_CLASS, &stats));
+	ut_asserteq(before.inuse + SLAB_TEST_COUNT, stats.inuse);
+	ut_asserteq(before.allocs + SLAB_TEST_COUNT, stats.allocs);
+	ut_assert(stats.peak >= stats.inuse);
+	ut_assert(stats.pages > before.pages);
+	ut_assert(stats.capacity >= stats.inuse);
+
+	/* no object may overlap another */
+	for (i = 0; i < SLAB_TEST_COUNT; i++) {
+		for (j = 0; j < SLAB_TEST_SIZE; j++)
+			ut_asserteq((u8)i, ptr[i][j]);
+	}
+
+	for (i = 0; i < SLAB_TEST_COUNT; i++)
+		free(ptr[i]);
+
+	/* empty pages go back to the free pool */
+	ut_assertok(malloc_slab_get_stats(SLAB_TEST_CLASS, &stats));
+	ut_asserteq(before.inuse, stats.inuse);
+	ut_asserteq(before.pages, stats.pages);
+
+	return 0;
+}
+COMMON_TEST(common_test_malloc_slab, 0);
+
+/* Test the edges of the slab front-end and the other allocation functions */
+static int common_test_malloc_slab_funcs(struct unit_test_state *uts)
+{
+	char *ptr, *new;
+	int i;
+
+	/* large and aligned requests go to dlmalloc */
+	ptr = malloc(MALLOC_SLAB_MAX + 1);
+	ut_assertnonnull(ptr);
+	ut_assert(!malloc_slab_owns(ptr));
+	free(ptr);
+
+	ptr = memalign(64, 16);
+	ut_assertnonnull(ptr);
+	ut_assert(!malloc_slab_owns(ptr));
+	ut_asserteq(0, (ulong)ptr & 63);
+	free(ptr);
+
+	/* calloc() must clear a slab object which was used before */
+	ptr = malloc(40);
+	ut_assert(malloc_slab_owns(ptr));
+	memset(ptr, 0xff, 40);
+	free(ptr);
+	ptr = calloc(1, 40);
+	ut_assert(malloc_slab_owns(ptr));
+	for (i = 0; i < 40; i++)
+		ut_asserteq(0, ptr[i]);
+	free(ptr);
+
+	/* realloc() stays put within the class, else moves */
+	ptr = malloc(20);
+	strcpy(ptr, "slab");
+	new = realloc(ptr, 30);
+	ut_asserteq_ptr(ptr, new);
+	new = realloc(ptr, 200);
+	ut_assert(malloc_slab_owns(new));
+	ut_asserteq(256, malloc_usable_size(new));
+	ut_asserteq_str("slab", new);
+	ptr = new;
+	new = realloc(ptr, 4000);
+	ut_assertnonnull(new);
+	ut_assert(!malloc_slab_owns(new));
+	ut_asserteq_str("slab", new);
+
+	/* and back into a slab */
+	ptr = new;
+	new = malloc(100);
+	ut_assert(malloc_slab_owns(new));
+	free(new);
+	free(ptr);
+
+	return 0;
+}
+COMMON_TEST(common_test_malloc_slab_funcs, 0);
+
+/* Test the 'malloc info' command */
+static int common_test_malloc_info(struct unit_test_state *uts)
+{
+	struct malloc_slab_stats stats;
+	char expect[20];
+	uint cls;
+
+	if (!IS_ENABLED(CONFIG_CMD_MALLOC))
+		return -EAGAIN;
+	ut_assertok(console_record_reset_enable());
+	ut_assertok(run_command("malloc info", 0));
+	ut_assert_nextlinen("total bytes   = ");
+	ut_assert_nextlinen("heap top      = ");
+	ut_assert_nextlinen("slab pages    = ");
+	ut_assert_nextline(" size  pages  in use    peak    allocs  fallback  frag");
+	for (cls = 0; !malloc_slab_get_stats(cls, &stats); cls++) {
+		snprintf(expect, sizeof(expect), "%5u ", stats.size);
+		ut_assert_nextlinen(expect);
+	}
+	ut_assert_console_end();
+
+	return 0;
+}
+COMMON_TEST(common_test_malloc_info, UT_TESTF_CONSOLE_REC);
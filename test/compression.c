@@ -6,15 +6,22 @@
 #include <common.h>
 #include <abuf.h>
 #include <bootm.h>
+#include <blk.h>
 #include <command.h>
+#include <decomp_write.h>
 #include <gzip.h>
+#include <hash.h>
 #include <image.h>
 #include <log.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <part.h>
+#include <time.h>
 #include <asm/io.h>
 
+#include <linux/sizes.h>
 #include <u-boot/lz4.h>
+#include <u-boot/sha256.h>
 #include <u-boot/zlib.h>
 #include <bzlib.h>
 
@@ -610,6 +617,496 @@ static int compression_test_bootm_none(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_bootm_none, 0);
 
+/**
+ * decomp_hash() - Decompress with image_decomp_hash() and hash with SHA256
+ *
+ * @comp_type:	Compression type to use
+ * @in:		Compressed data
+ * @in_size:	Size of compressed data
+ * @out:	Buffer for the decompressed data
+ * @out_size:	Size of @out
+ * @load_end:	Returns the end of the decompressed data
+ * @digest:	Returns the SHA256 digest of the compressed data
+ * Return: 0 if OK, -ve on error
+ */
+static int decomp_hash(int comp_type, void *in, ulong in_size, void *out,
+		       ulong out_size, ulong *load_end, u8 *digest)
+{
+	struct hash_algo *algo;
+	void *ctx;
+	int ret, err;
+
+	ret = hash_progressive_lookup_algo("sha256", &algo);
+	if (ret)
+		return ret;
+	ret = algo->hash_init(algo, &ctx);
+	if (ret)
+		return ret;
+	ret = image_decomp_hash(comp_type, map_to_sysmem(out),
+				map_to_sysmem(in), IH_TYPE_KERNEL, out, in,
+				in_size, out_size, load_end, algo, ctx);
+	err = algo->hash_finish(algo, ctx, digest, algo->digest_size);
+
+	return ret ? ret : err;
+}
+
+/* hash_update() method of a hash engine which always fails */
+static int fail_hash_update(struct hash_algo *algo, void *ctx, const void *buf,
+			    unsigned int size, int is_last)
+{
+	return -EIO;
+}
+
+/**
+ * run_bootm_hash_test() - Check the hash computed while decompressing
+ *
+ * @comp_type:	Compression type to test
+ * @compress:	Our function to compress data
+ * Return: 0 if OK, non-zero on failure
+ */
+static int run_bootm_hash_test(struct unit_test_state *uts, int comp_type,
+			       mutate_func compress)
+{
+	u8 digest[SHA256_SUM_LEN], expect[SHA256_SUM_LEN];
+	ulong compress_size = TEST_BUFFER_SIZE;
+	int unc_len = strlen(plain);
+	int digest_len = sizeof(expect);
+	struct hash_algo *algo, fail;
+	void *compress_buff, *out;
+	ulong load_end;
+	void *ctx;
+
+	compress_buff = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(compress_buff);
+	out = malloc(TEST_BUFFER_SIZE);
+	ut_assertnonnull(out);
+
+	memset(compress_buff, '\0', TEST_BUFFER_SIZE);
+	ut_assertok(compress(uts, (void *)plain, unc_len, compress_buff,
+			     compress_size, &compress_size));
+
+	/* Some trailing padding, which must be hashed too */
+	compress_size += 4;
+	ut_assertok(hash_block("sha256", compress_buff, compress_size, expect,
+			       &digest_len));
+
+	ut_assertok(decomp_hash(comp_type, compress_buff, compress_size, out,
+				TEST_BUFFER_SIZE, &load_end, digest));
+	ut_asserteq(unc_len, load_end - map_to_sysmem(out));
+	ut_asserteq_mem(plain, out, unc_len);
+	ut_asserteq_mem(expect, digest, sizeof(expect));
+
+	/* Too little space */
+	ut_assert(decomp_hash(comp_type, compress_buff, compress_size, out,
+			      unc_len - 1, &load_end, digest));
+
+	/* A failing hash engine fails the decompression */
+	ut_assertok(hash_progressive_lookup_algo("sha256", &algo));
+	fail = *algo;
+	fail.hash_update = fail_hash_update;
+	ut_assertok(fail.hash_init(&fail, &ctx));
+	ut_asserteq(-EIO, image_decomp_hash(comp_type, map_to_sysmem(out),
+					    map_to_sysmem(compress_buff),
+					    IH_TYPE_KERNEL, out, compress_buff,
+					    compress_size, TEST_BUFFER_SIZE,
+					    &load_end, &fail, ctx));
+	fail.hash_finish(&fail, ctx, digest, sizeof(digest));
+
+	free(out);
+	free(compress_buff);
+
+	return 0;
+}
+
+static int compression_test_bootm_hash_gzip(struct unit_test_state *uts)
+{
+	return run_bootm_hash_test(uts, IH_COMP_GZIP, compress_using_gzip);
+}
+COMPRESSION_TEST(compression_test_bootm_hash_gzip, 0);
+
+static int compression_test_bootm_hash_bzip2(struct unit_test_state *uts)
+{
+	return run_bootm_hash_test(uts, IH_COMP_BZIP2, compress_using_bzip2);
+}
+COMPRESSION_TEST(compression_test_bootm_hash_bzip2, 0);
+
+static int compression_test_bootm_hash_lzma(struct unit_test_state *uts)
+{
+	return run_bootm_hash_test(uts, IH_COMP_LZMA, compress_using_lzma);
+}
+COMPRESSION_TEST(compression_test_bootm_hash_lzma, 0);
+
+static int compression_test_bootm_hash_lz4(struct unit_test_state *uts)
+{
+	return run_bootm_hash_test(uts, IH_COMP_LZ4, compress_using_lz4);
+}
+COMPRESSION_TEST(compression_test_bootm_hash_lz4, 0);
+
+static int compression_test_bootm_hash_zstd(struct unit_test_state *uts)
+{
+	return run_bootm_hash_test(uts, IH_COMP_ZSTD, compress_using_zstd);
+}
+COMPRESSION_TEST(compression_test_bootm_hash_zstd, 0);
+
+#define BENCH_SIZE	SZ_4M
+
+/*
+ * Compare separate hash and decompress passes against the fused one. This
+ * takes a while, so is manual:
+ *
+ *    ut compression -f bootm_hash_bench_norun
+ */
+static int compression_test_bootm_hash_bench_norun(struct unit_test_state *uts)
+{
+	u8 digest[SHA256_SUM_LEN], expect[SHA256_SUM_LEN];
+	int digest_len = sizeof(expect);
+	ulong comp_size = BENCH_SIZE;
+	ulong load_end, start, split, fused;
+	u8 *data, *comp, *out;
+	uint seed = 1;
+	int i;
+
+	data = malloc(BENCH_SIZE);
+	comp = malloc(BENCH_SIZE);
+	out = malloc(BENCH_SIZE);
+	ut_assertnonnull(data);
+	ut_assertnonnull(comp);
+	ut_assertnonnull(out);
+
+	/* Compressible, but not trivially so */
+	for (i = 0; i < BENCH_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = plain[(seed >> 16) % 64];
+	}
+	ut_assertok(gzip(comp, &comp_size, data, BENCH_SIZE));
+
+	start = timer_get_us();
+	ut_assertok(hash_block("sha256", comp, comp_size, expect,
+			       &digest_len));
+	ut_assertok(image_decomp(IH_COMP_GZIP, map_to_sysmem(out),
+				 map_to_sysmem(comp), IH_TYPE_KERNEL, out,
+				 comp, comp_size, BENCH_SIZE, &load_end));
+	split = timer_get_us() - start;
+
+	memset(out, '\0', BENCH_SIZE);
+	start = timer_get_us();
+	ut_assertok(decomp_hash(IH_COMP_GZIP, comp, comp_size, out, BENCH_SIZE,
+				&load_end, digest));
+	fused = timer_get_us() - start;
+
+	ut_asserteq_mem(expect, digest, sizeof(expect));
+	ut_asserteq_mem(data, out, BENCH_SIZE);
+	printf("gzip %lu -> %u bytes: hash then decompress %lu us, fused %lu us\n",
+	       comp_size, BENCH_SIZE, split, fused);
+
+	free(out);
+	free(comp);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_bootm_hash_bench_norun, UT_TESTF_MANUAL);
+
+#define INFLATE_SIZE	SZ_256K
+#define INFLATE_CHUNK	4001
+
+/*
+ * Inflate into small, oddly sized output chunks so that matches are copied
+ * both from the sliding window and from the output, over a mix of run,
+ * short-distance and long-distance matches
+ */
+static int compression_test_gzip_inflate_stream(struct unit_test_state *uts)
+{
+	ulong comp_size = INFLATE_SIZE;
+	u8 *data, *comp, *out;
+	uint seed = 1;
+	int hdr, ret, i;
+	z_stream s;
+
+	data = malloc(INFLATE_SIZE);
+	comp = malloc(INFLATE_SIZE);
+	out = malloc(INFLATE_SIZE + INFLATE_CHUNK);
+	ut_assertnonnull(data);
+	ut_assertnonnull(comp);
+	ut_assertnonnull(out);
+
+	for (i = 0; i < INFLATE_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		switch ((i >> 10) & 3) {
+		case 0:		/* runs, distance 1 */
+			data[i] = (i >> 6) & 0xff;
+			break;
+		case 1:		/* short periods, distances 2 to 7 */
+			data[i] = plain[i % (2 + ((i >> 12) % 6))];
+			break;
+		default:	/* text with longer repeats */
+			data[i] = plain[(seed >> 16) % 64];
+			break;
+		}
+	}
+	ut_assertok(gzip(comp, &comp_size, data, INFLATE_SIZE));
+	hdr = gzip_parse_header(comp, comp_size);
+	ut_assert(hdr > 0);
+
+	memset(&s, '\0', sizeof(s));
+	s.zalloc = gzalloc;
+	s.zfree = gzfree;
+	ut_asserteq(Z_OK, inflateInit2(&s, -MAX_WBITS));
+	s.next_in = comp + hdr;
+	s.avail_in = comp_size - hdr;
+	do {
+		s.next_out = out + s.total_out;
+		s.avail_out = INFLATE_CHUNK;
+		ret = inflate(&s, Z_NO_FLUSH);
+		ut_assert(ret == Z_OK || ret == Z_STREAM_END);
+	} while (ret != Z_STREAM_END);
+	inflateEnd(&s);
+
+	ut_asserteq(INFLATE_SIZE, s.total_out);
+	ut_asserteq_mem(data, out, INFLATE_SIZE);
+
+	free(out);
+	free(comp);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_gzip_inflate_stream, 0);
+
+/* zstd -19 -D /tmp/dict.txt /tmp/plain.txt, dict.txt being zstd_dict */
+static const char zstd_dict[] =
+	"If I were any shorter, there wouldn't be much sense in\n"
+	"compressing me in the first place. At least with lzo, anyway,\n";
+
+static const char zstd_dict_compressed[] =
+	"\x28\xb5\x2f\xfd\x64\x5e\x00\x9d\x03\x00\x92\x47\x16\x12\x90\xcf"
+	"\x01\x60\x63\x80\x0d\x0c\xa1\x01\xfd\x90\xeb\xff\x5c\xff\x8b\x0e"
+	"\x40\xcc\x4e\x65\xce\x76\x00\xc1\xf7\x29\xb9\x49\x08\xe3\xdb\x16"
+	"\xd5\xe6\x90\x7e\xca\xd2\x31\x96\xab\xb3\xd4\x1d\x40\xf4\x5b\xee"
+	"\x73\xbd\x1f\xfc\x5c\x8a\x9e\x56\xf3\xd0\xee\xcd\x56\x7b\x7e\xc5"
+	"\xbd\x65\x21\x40\x50\xdc\xf4\x08\x9e\x2e\xf3\x6e\xa6\x3c\x37\x95"
+	"\x96\x7a\xb9\x2b\x1f\x01\x07\x00\x60\x13\x00\x63\xa3\x18\x45\xe1"
+	"\x12\x3d\x36\x95\xac\x11\x84\x5e\x8a\xc2\xe7\x0d\x4a\xe4\xf4\x6e"
+	"\xfa";
+
+/* Skippable frame with a three-byte payload */
+static const char zstd_skippable[] = "\x50\x2a\x4d\x18\x03\x00\x00\x00" "abc";
+
+struct zstd_win_state {
+	char *buf;
+	size_t pos;
+	int calls;
+};
+
+static int zstd_win_out(void *priv, const void *buf, size_t len)
+{
+	struct zstd_win_state *state = priv;
+
+	memcpy(state->buf + state->pos, buf, len);
+	state->pos += len;
+	state->calls++;
+
+	return 0;
+}
+
+/* Skippable frame, two frames and trailing junk, all in one go */
+static int compression_test_zstd_multi_frame(struct unit_test_state *uts)
+{
+	const size_t plain_len = strlen(plain);
+	struct zstd_win_state state;
+	char src[TEST_BUFFER_SIZE], dst[TEST_BUFFER_SIZE * 2], win[7];
+	struct abuf in, out, winbuf;
+	size_t src_len = 0;
+	unsigned long long size;
+
+	memcpy(src, zstd_skippable, sizeof(zstd_skippable) - 1);
+	src_len += sizeof(zstd_skippable) - 1;
+	memcpy(src + src_len, zstd_compressed, zstd_compressed_size);
+	src_len += zstd_compressed_size;
+	memcpy(src + src_len, zstd_compressed, zstd_compressed_size);
+	src_len += zstd_compressed_size;
+	memset(src + src_len, '\0', 16);
+	src_len += 16;
+	ut_assert(src_len <= sizeof(src));
+	ut_assert(plain_len * 2 <= sizeof(dst));
+
+	abuf_init_set(&in, src, src_len);
+	abuf_init_set(&out, dst, sizeof(dst));
+	ut_asserteq(plain_len * 2, zstd_decompress(&in, &out));
+	ut_asserteq_mem(plain, dst, plain_len);
+	ut_asserteq_mem(plain, dst + plain_len, plain_len);
+
+	/* the same again, through a window much smaller than the output */
+	memset(dst, '\0', sizeof(dst));
+	state.buf = dst;
+	state.pos = 0;
+	state.calls = 0;
+	abuf_init_set(&winbuf, win, sizeof(win));
+	ut_assertok(zstd_decompress_window(&in, &winbuf, zstd_win_out, &state,
+					   NULL, &size));
+	ut_asserteq(plain_len * 2, size);
+	ut_asserteq(plain_len * 2, state.pos);
+	ut_assert(state.calls >= plain_len * 2 / sizeof(win));
+	ut_asserteq_mem(plain, dst, plain_len);
+	ut_asserteq_mem(plain, dst + plain_len, plain_len);
+
+	/* nothing but junk */
+	abuf_init_set(&in, src + src_len - 16, 16);
+	ut_asserteq(-EINVAL, zstd_decompress(&in, &out));
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_zstd_multi_frame, 0);
+
+static int compression_test_zstd_dict(struct unit_test_state *uts)
+{
+	const size_t plain_len = strlen(plain);
+	char dst[TEST_BUFFER_SIZE], win[64];
+	struct zstd_win_state state;
+	const zstd_ddict *ddict;
+	struct abuf in, out, winbuf;
+	unsigned long long size;
+
+	abuf_init_set(&in, (void *)zstd_dict_compressed,
+		      sizeof(zstd_dict_compressed) - 1);
+	abuf_init_set(&out, dst, sizeof(dst));
+
+	/* the frame references content which is only in the dictionary */
+	ut_assert(zstd_decompress(&in, &out) < 0);
+
+	ddict = zstd_ddict_create(zstd_dict, sizeof(zstd_dict) - 1);
+	ut_assertnonnull(ddict);
+	ut_asserteq(plain_len, zstd_decompress_dict(&in, &out, ddict));
+	ut_asserteq_mem(plain, dst, plain_len);
+
+	memset(dst, '\0', sizeof(dst));
+	state.buf = dst;
+	state.pos = 0;
+	state.calls = 0;
+	abuf_init_set(&winbuf, win, sizeof(win));
+	ut_assertok(zstd_decompress_window(&in, &winbuf, zstd_win_out, &state,
+					   ddict, &size));
+	ut_asserteq(plain_len, size);
+	ut_asserteq_mem(plain, dst, plain_len);
+	zstd_ddict_free(ddict);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_zstd_dict, 0);
+
+/* Offset and write-buffer size used with the 1MB mmc2 device */
+#define DECOMP_WRITE_OFFSET	SZ_64K
+#define DECOMP_WRITE_BUF	SZ_8K
+
+/* Write @in to mmc2 with decomp_write() and check that it reads back */
+static int run_decomp_write_test(struct unit_test_state *uts, int comp,
+				 const void *in, ulong in_size,
+				 const void *expect, ulong expect_size)
+{
+	struct blk_desc *desc;
+	lbaint_t start, blocks;
+	u8 *buf;
+
+	if (!IS_ENABLED(CONFIG_DECOMP_WRITE))
+		return -EAGAIN;
+
+	ut_assert(blk_get_device_by_str("mmc", "2", &desc) >= 0);
+	start = DECOMP_WRITE_OFFSET / desc->blksz;
+	blocks = DIV_ROUND_UP(expect_size, desc->blksz);
+	buf = malloc(blocks * desc->blksz);
+	ut_assertnonnull(buf);
+
+	/* make sure that stale data cannot pass */
+	memset(buf, 0xff, blocks * desc->blksz);
+	ut_asserteq(blocks, blk_dwrite(desc, start, blocks, buf));
+
+	ut_assertok(decomp_write(comp, (void *)in, in_size, desc,
+				 DECOMP_WRITE_BUF, DECOMP_WRITE_OFFSET, 0));
+	ut_asserteq(blocks, blk_dread(desc, start, blocks, buf));
+	ut_asserteq_mem(expect, buf, expect_size);
+	/* the last block is padded with zeroes */
+	while (expect_size % desc->blksz)
+		ut_asserteq(0, buf[expect_size++]);
+	free(buf);
+
+	return 0;
+}
+
+static int compression_test_decomp_write_gzip(struct unit_test_state *uts)
+{
+	ulong size = SZ_512K, comp_size = SZ_512K;
+	struct blk_desc *desc;
+	u8 *data, *comp;
+	uint seed = 1;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_DECOMP_WRITE))
+		return -EAGAIN;
+
+	data = malloc(size);
+	comp = malloc(comp_size);
+	ut_assertnonnull(data);
+	ut_assertnonnull(comp);
+	for (i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = plain[(seed >> 16) % 64];
+	}
+	/* end part-way through a block */
+	size -= 100;
+	ut_assertok(gzip(comp, &comp_size, data, size));
+	ut_assertok(run_decomp_write_test(uts, IH_COMP_GZIP, comp, comp_size,
+					  data, size));
+
+	/* the output does not fit at the end of the device */
+	ut_assert(blk_get_device_by_str("mmc", "2", &desc) >= 0);
+	ut_asserteq(-EFBIG, decomp_write(IH_COMP_GZIP, comp, comp_size, desc,
+					 DECOMP_WRITE_BUF,
+					 (desc->lba - 8) * desc->blksz, 0));
+
+	/* nor does it match the expected size */
+	ut_asserteq(-EINVAL, decomp_write(IH_COMP_GZIP, comp, comp_size, desc,
+					  DECOMP_WRITE_BUF, 0, size + 1));
+	free(comp);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_decomp_write_gzip, 0);
+
+static int compression_test_decomp_write_zstd(struct unit_test_state *uts)
+{
+	const ulong plain_len = strlen(plain);
+	char src[TEST_BUFFER_SIZE], expect[TEST_BUFFER_SIZE * 2];
+
+	/* two frames, so the output spans more than one block */
+	memcpy(src, zstd_compressed, zstd_compressed_size);
+	memcpy(src + zstd_compressed_size, zstd_compressed,
+	       zstd_compressed_size);
+	memcpy(expect, plain, plain_len);
+	memcpy(expect + plain_len, plain, plain_len);
+
+	return run_decomp_write_test(uts, IH_COMP_ZSTD, src,
+				     zstd_compressed_size * 2, expect,
+				     plain_len * 2);
+}
+COMPRESSION_TEST(compression_test_decomp_write_zstd, 0);
+
+static int compression_test_decomp_write_lz4(struct unit_test_state *uts)
+{
+	return run_decomp_write_test(uts, IH_COMP_LZ4, lz4_compressed,
+				     lz4_compressed_size, plain,
+				     strlen(plain));
+}
+COMPRESSION_TEST(compression_test_decomp_write_lz4, 0);
+
+static int compression_test_decomp_write_lzma(struct unit_test_state *uts)
+{
+	return run_decomp_write_test(uts, IH_COMP_LZMA, lzma_compressed,
+				     lzma_compressed_size, plain,
+				     strlen(plain));
+}
+COMPRESSION_TEST(compression_test_decomp_write_lzma, 0);
+
 int do_ut_compression(struct cmd_tbl *cmdtp, int flag, int argc,
 		      char *const argv[])
 {
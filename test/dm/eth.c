@@ -233,6 +233,43 @@ static int dm_test_eth_prime(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_eth_prime, UT_TESTF_SCAN_FDT);
 
+/* Test that the device is left running between the transfers in a batch */
+static int dm_test_eth_batch(struct unit_test_state *uts)
+{
+	struct eth_sandbox_priv *priv;
+	struct udevice *dev;
+
+	net_ping_ip = string_to_ip("1.1.2.2");
+	env_set("ethact", "eth@10002000");
+	ut_assertok(uclass_get_device_by_name(UCLASS_ETH, "eth@10002000",
+					      &dev));
+	priv = dev_get_priv(dev);
+
+	ut_assertok(net_loop(PING));
+	ut_assert(!priv->started);
+
+	net_batch_start();
+	ut_assert(net_batch_active());
+	ut_assertok(net_loop(PING));
+	ut_assert(priv->started);
+	ut_assertok(net_loop(PING));
+	ut_assert(priv->started);
+
+	/* nested batches keep it running until the outermost one ends */
+	net_batch_start();
+	ut_assertok(net_loop(PING));
+	net_batch_end();
+	ut_assert(net_batch_active());
+	ut_assert(priv->started);
+
+	net_batch_end();
+	ut_assert(!net_batch_active());
+	ut_assert(!priv->started);
+
+	return 0;
+}
+DM_TEST(dm_test_eth_batch, UT_TESTF_SCAN_FDT);
+
 /**
  * This test case is trying to test the following scenario:
  *	- All ethernet devices are not probed
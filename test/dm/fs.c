@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for reading open files via the filesystem layer
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <fs.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <dm/test.h>
+#include <test/ut.h>
+
+#define TEST_FILE	"/fs_file_test"
+#define TEST_SIZE	20000
+#define TEST_CHUNK	1000
+
+static void fill_pattern(u8 *buf, int size, u8 seed)
+{
+	int i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = seed + i * 7 + (i >> 8);
+}
+
+/**
+ * check_file_reads() - check reading an open file in various ways
+ *
+ * @uts:	test state
+ * @file:	open file, containing @data
+ * @data:	expected contents of the file, TEST_SIZE bytes
+ * @buf:	buffer to read into, TEST_SIZE bytes
+ * Return:	0 if OK, else test failure
+ */
+static int check_file_reads(struct unit_test_state *uts, struct fs_file *file,
+			    u8 *data, u8 *buf)
+{
+	loff_t actual;
+	int pos;
+
+	ut_asserteq(TEST_SIZE, file->size);
+
+	/* read forwards, in chunks that do not line up with the clusters */
+	memset(buf, '\0', TEST_SIZE);
+	for (pos = 0; pos < TEST_SIZE; pos += actual) {
+		ut_assertok(fs_file_read(file, buf + pos, pos, TEST_CHUNK,
+					 &actual));
+		ut_assert(actual > 0);
+	}
+	ut_asserteq(TEST_SIZE, pos);
+	ut_asserteq_mem(data, buf, TEST_SIZE);
+
+	/* read backwards, which must walk from the start again */
+	memset(buf, '\0', TEST_SIZE);
+	for (pos = TEST_SIZE - TEST_CHUNK; pos >= 0; pos -= TEST_CHUNK) {
+		ut_assertok(fs_file_read(file, buf + pos, pos, TEST_CHUNK,
+					 &actual));
+		ut_asserteq(TEST_CHUNK, actual);
+	}
+	ut_asserteq_mem(data, buf, TEST_SIZE);
+
+	/* reading past the end is short, reading from beyond it fails */
+	ut_assertok(fs_file_read(file, buf, TEST_SIZE - 10, TEST_CHUNK,
+				 &actual));
+	ut_asserteq(10, actual);
+	ut_assertok(fs_file_read(file, buf, TEST_SIZE, TEST_CHUNK, &actual));
+	ut_asserteq(0, actual);
+	ut_asserteq(-EINVAL, fs_file_read(file, buf, TEST_SIZE + 1, TEST_CHUNK,
+					  &actual));
+
+	/* a file changed while open is looked up again */
+	fill_pattern(data, TEST_SIZE / 2, 0x55);
+	ut_assertok(fs_set_blk_dev("mmc", "1:1", FS_TYPE_ANY));
+	ut_assertok(fs_write(TEST_FILE, map_to_sysmem(data), 0, TEST_SIZE / 2,
+			     &actual));
+	ut_assertok(fs_file_read(file, buf, 0, 0, &actual));
+	ut_asserteq(TEST_SIZE / 2, actual);
+	ut_asserteq(TEST_SIZE / 2, file->size);
+	ut_asserteq_mem(data, buf, TEST_SIZE / 2);
+
+	return 0;
+}
+
+/**
+ * check_file() - write the test file, then open it and check reading it
+ *
+ * @uts:	test state
+ * @data:	buffer for the file contents, TEST_SIZE bytes
+ * @buf:	buffer to read into, TEST_SIZE bytes
+ * Return:	0 if OK, else test failure
+ */
+static int check_file(struct unit_test_state *uts, u8 *data, u8 *buf)
+{
+	struct fs_file *file;
+	loff_t actual;
+	int ret;
+
+	/* mmc1 has a FAT filesystem on its first partition */
+	fill_pattern(data, TEST_SIZE, 0);
+	ut_assertok(fs_set_blk_dev("mmc", "1:1", FS_TYPE_ANY));
+	ut_assertok(fs_write(TEST_FILE, map_to_sysmem(data), 0, TEST_SIZE,
+			     &actual));
+	ut_asserteq(TEST_SIZE, actual);
+
+	ut_assertok(fs_set_blk_dev("mmc", "1:1", FS_TYPE_ANY));
+	ut_assertok(fs_file_open(TEST_FILE, &file));
+	ret = check_file_reads(uts, file, data, buf);
+	fs_file_close(file);
+
+	return ret;
+}
+
+/* Test reading a file in chunks with fs_file_read() */
+static int dm_test_fs_file(struct unit_test_state *uts)
+{
+	u8 *data, *buf;
+	int ret;
+
+	data = malloc(TEST_SIZE);
+	ut_assertnonnull(data);
+	buf = malloc(TEST_SIZE);
+	ut_assertnonnull(buf);
+
+	ret = check_file(uts, data, buf);
+
+	/* mmc1 is shared with other tests, so always remove the file */
+	if (!fs_set_blk_dev("mmc", "1:1", FS_TYPE_ANY))
+		fs_unlink(TEST_FILE);
+	free(buf);
+	free(data);
+
+	return ret;
+}
+DM_TEST(dm_test_fs_file, UT_TESTF_SCAN_FDT);
@@ -193,3 +193,62 @@ static int dm_test_cmd_host(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_cmd_host, UT_TESTF_SCAN_FDT);
+
+/* Test the timing model and I/O statistics of host devices */
+static int dm_test_host_timing(struct unit_test_state *uts)
+{
+	static char label[] = "test";
+	struct host_sb_stats stats;
+	struct udevice *dev, *blk;
+	char buf[20 * 512];
+
+	ut_assertok(host_create_device(label, true, &dev));
+	ut_assertok(host_attach_file(dev, filename));
+	ut_assertok(blk_get_from_parent(dev, &blk));
+	ut_assertok(device_probe(blk));
+
+	/* drop the reads made while probing, e.g. for the partition table */
+	host_get_stats(dev, &stats);
+
+	console_record_reset();
+	ut_assertok(run_command("host timing test 100 1024 8 16 1000", 0));
+	ut_assert_nextline("latency: 100 us");
+	ut_assert_nextline("rate: 1024 KiB/s");
+	ut_assert_nextline("max blocks/command: 8");
+	ut_assert_nextline("erase blocks: 16");
+	ut_assert_nextline("erase time: 1000 us");
+	ut_assert_console_end();
+
+	/*
+	 * The read needs three commands and the write covers two erase blocks.
+	 * Write back the same data, so the filesystem is not changed.
+	 */
+	ut_set_skip_delays(uts, true);
+	ut_asserteq(20, blk_read(blk, 0, 20, buf));
+	ut_asserteq(4, blk_write(blk, 14, 4, buf + 14 * 512));
+
+	ut_assertok(run_command("host stats test", 0));
+	ut_assert_nextline("reads: 3");
+	ut_assert_nextline("writes: 1");
+	ut_assert_nextline("blocks read: 20");
+	ut_assert_nextline("blocks written: 4");
+	ut_assert_nextline("erases: 2");
+	ut_assert_nextline("busy time: %d us", 300 + 9765 + 100 + 1953 + 2000);
+	ut_assert_console_end();
+
+	/* reading the statistics resets them */
+	ut_assertok(run_command("host stats test", 0));
+	ut_assert_nextline("reads: 0");
+	ut_assert_skip_to_line("busy time: 0 us");
+	ut_assert_console_end();
+
+	ut_asserteq(1, run_command("host stats missing", 0));
+	ut_assert_nextline("No such device 'missing'");
+	ut_assert_console_end();
+
+	ut_assertok(host_detach_file(dev));
+	ut_assertok(device_unbind(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_host_timing, UT_TESTF_SCAN_FDT | UT_TESTF_CONSOLE_REC);
@@ -0,0 +1,248 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the raw NAND core, using the sandbox NAND emulator
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <malloc.h>
+#include <nand.h>
+#include <asm/test.h>
+#include <dm/test.h>
+#include <linux/mtd/mtd.h>
+#include <linux/mtd/rawnand.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+/* Geometry of the emulated chip */
+#define NAND_PAGE_SIZE	0x800
+#define NAND_BLOCK_SIZE	0x20000
+
+/* Area written by the tests: four blocks */
+#define NAND_TEST_SIZE	(4 * NAND_BLOCK_SIZE)
+
+/* Page with a single bit error, which ECC corrects */
+#define CORRECTABLE_PAGE	3
+/* Page with two bit errors in one ECC step, which ECC cannot correct */
+#define UNCORRECTABLE_PAGE	70
+
+static u8 nand_test_byte(int i)
+{
+	return (i * 7) ^ (i >> 8) ^ (i >> 16);
+}
+
+static int nand_test_setup(struct unit_test_state *uts, struct udevice **devp,
+			   struct mtd_info **mtdp)
+{
+	struct erase_info instr = {};
+	struct mtd_info *mtd;
+	struct udevice *dev;
+	size_t retlen;
+	u8 *buf;
+	int i;
+
+	ut_assertok(uclass_get_device_by_driver(UCLASS_MTD,
+						DM_DRIVER_GET(sandbox_nand),
+						&dev));
+	mtd = sandbox_nand_get_mtd(dev);
+	ut_asserteq(NAND_PAGE_SIZE, mtd->writesize);
+	ut_asserteq(NAND_BLOCK_SIZE, mtd->erasesize);
+
+	/* the chip is found through its ONFI parameter page */
+	ut_assert(mtd_to_nand(mtd)->onfi_version);
+
+	buf = malloc(NAND_TEST_SIZE);
+	ut_assertnonnull(buf);
+	for (i = 0; i < NAND_TEST_SIZE; i++)
+		buf[i] = nand_test_byte(i);
+
+	instr.mtd = mtd;
+	instr.len = NAND_TEST_SIZE;
+	ut_assertok(mtd_erase(mtd, &instr));
+	ut_assertok(mtd_write(mtd, 0, NAND_TEST_SIZE, &retlen, buf));
+	ut_asserteq(NAND_TEST_SIZE, retlen);
+	free(buf);
+
+	ut_assertok(sandbox_nand_flip_bit(dev, CORRECTABLE_PAGE, 100, 2));
+	ut_assertok(sandbox_nand_flip_bit(dev, UNCORRECTABLE_PAGE, 600, 0));
+	ut_assertok(sandbox_nand_flip_bit(dev, UNCORRECTABLE_PAGE, 700, 5));
+
+	*devp = dev;
+	*mtdp = mtd;
+
+	return 0;
+}
+
+/* Basic test of the sandbox NAND emulator */
+static int dm_test_nand_base(struct unit_test_state *uts)
+{
+	struct mtd_info *mtd;
+	struct udevice *dev;
+	size_t retlen;
+	u8 buf[NAND_PAGE_SIZE];
+	loff_t from;
+	int i;
+
+	ut_assertok(nand_test_setup(uts, &dev, &mtd));
+
+	ut_assertok(mtd_read(mtd, NAND_PAGE_SIZE, NAND_PAGE_SIZE, &retlen,
+			     buf));
+	ut_asserteq(NAND_PAGE_SIZE, retlen);
+	for (i = 0; i < NAND_PAGE_SIZE; i++)
+		ut_asserteq(nand_test_byte(NAND_PAGE_SIZE + i), buf[i]);
+
+	/* the single bit error is corrected and reported */
+	from = CORRECTABLE_PAGE * NAND_PAGE_SIZE;
+	ut_asserteq(-EUCLEAN, mtd_read(mtd, from, NAND_PAGE_SIZE, &retlen,
+				       buf));
+	for (i = 0; i < NAND_PAGE_SIZE; i++)
+		ut_asserteq(nand_test_byte(from + i), buf[i]);
+
+	from = UNCORRECTABLE_PAGE * NAND_PAGE_SIZE;
+	ut_asserteq(-EBADMSG, mtd_read(mtd, from, NAND_PAGE_SIZE, &retlen,
+				       buf));
+
+	return 0;
+}
+DM_TEST(dm_test_nand_base, UT_TESTF_SCAN_FDT);
+
+/**
+ * nand_test_read() - Read from the NAND chip, with or without cache reads
+ *
+ * @uts: Test state
+ * @dev: NAND device
+ * @mtd: MTD device for @dev
+ * @cache: true to allow READ CACHE SEQUENTIAL, false to read page by page
+ * @from: Offset to read from
+ * @len: Number of bytes to read
+ * @buf: Returns the data read
+ * @retp: Returns the value returned by mtd_read()
+ * @eccp: Returns the change in the ECC statistics
+ * @statsp: Returns the commands used by the read
+ * Return: 0 if OK, -ve on test failure
+ */
+static int nand_test_read(struct unit_test_state *uts, struct udevice *dev,
+			  struct mtd_info *mtd, bool cache, loff_t from,
+			  size_t len, u8 *buf, int *retp,
+			  struct mtd_ecc_stats *eccp,
+			  struct sandbox_nand_stats *statsp)
+{
+	struct nand_chip *chip = mtd_to_nand(mtd);
+	struct mtd_ecc_stats old = mtd->ecc_stats;
+	size_t retlen;
+
+	if (cache)
+		chip->onfi_params.opt_cmd |=
+			cpu_to_le16(ONFI_OPT_CMD_READ_CACHE);
+	else
+		chip->onfi_params.opt_cmd &=
+			~cpu_to_le16(ONFI_OPT_CMD_READ_CACHE);
+
+	/* make sure that every page comes from the chip */
+	chip->pagebuf = -1;
+	sandbox_nand_reset_stats(dev);
+	memset(buf, '\0', len);
+	*retp = mtd_read(mtd, from, len, &retlen, buf);
+	ut_asserteq(len, retlen);
+	sandbox_nand_get_stats(dev, statsp);
+	ut_asserteq(0, statsp->errors);
+
+	eccp->corrected = mtd->ecc_stats.corrected - old.corrected;
+	eccp->failed = mtd->ecc_stats.failed - old.failed;
+
+	return 0;
+}
+
+/* Check that cache reads return the same as reading page by page */
+static int dm_test_nand_cache_read(struct unit_test_state *uts)
+{
+	static const struct {
+		loff_t from;
+		size_t len;
+		int ret;
+	} cases[] = {
+		/* several whole pages, including the corrected one */
+		{ 0, 8 * NAND_PAGE_SIZE, -EUCLEAN },
+		/* unaligned start and length */
+		{ 4 * NAND_PAGE_SIZE + 0x123, 5 * NAND_PAGE_SIZE + 0x45,
+		  0 },
+		{ 5 * NAND_PAGE_SIZE, 6 * NAND_PAGE_SIZE - 1, 0 },
+		{ 6 * NAND_PAGE_SIZE + 1, 6 * NAND_PAGE_SIZE - 1, 0 },
+		/* across a block boundary */
+		{ NAND_BLOCK_SIZE - 3 * NAND_PAGE_SIZE, 6 * NAND_PAGE_SIZE,
+		  0 },
+		{ NAND_BLOCK_SIZE - 2 * NAND_PAGE_SIZE - 0x10,
+		  5 * NAND_PAGE_SIZE, 0 },
+		{ 2 * NAND_BLOCK_SIZE - 2 * NAND_PAGE_SIZE,
+		  2 * NAND_PAGE_SIZE + 0x100, 0 },
+		/* starting, ending and around an uncorrectable page */
+		{ UNCORRECTABLE_PAGE * NAND_PAGE_SIZE, 4 * NAND_PAGE_SIZE,
+		  -EBADMSG },
+		{ (UNCORRECTABLE_PAGE - 3) * NAND_PAGE_SIZE, 4 * NAND_PAGE_SIZE,
+		  -EBADMSG },
+		{ (UNCORRECTABLE_PAGE - 2) * NAND_PAGE_SIZE, 5 * NAND_PAGE_SIZE,
+		  -EBADMSG },
+		/* everything, so all blocks and both ECC errors */
+		{ 0, NAND_TEST_SIZE, -EBADMSG },
+		/* a single page, which is never a cache read */
+		{ 9 * NAND_PAGE_SIZE, NAND_PAGE_SIZE, 0 },
+	};
+	struct sandbox_nand_stats cstats, pstats;
+	struct mtd_ecc_stats cecc, pecc;
+	struct mtd_info *mtd;
+	struct udevice *dev;
+	u8 *cbuf, *pbuf;
+	int cret, pret;
+	int i, j;
+
+	ut_assertok(nand_test_setup(uts, &dev, &mtd));
+	cbuf = malloc(NAND_TEST_SIZE);
+	ut_assertnonnull(cbuf);
+	pbuf = malloc(NAND_TEST_SIZE);
+	ut_assertnonnull(pbuf);
+
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		loff_t from = cases[i].from;
+		size_t len = cases[i].len;
+		int first = from / NAND_PAGE_SIZE;
+		int last = (from + len - 1) / NAND_PAGE_SIZE;
+
+		ut_assertok(nand_test_read(uts, dev, mtd, true, from, len,
+					   cbuf, &cret, &cecc, &cstats));
+		ut_assertok(nand_test_read(uts, dev, mtd, false, from, len,
+					   pbuf, &pret, &pecc, &pstats));
+
+		ut_asserteq(cases[i].ret, cret);
+		ut_asserteq(pret, cret);
+		ut_asserteq(pecc.corrected, cecc.corrected);
+		ut_asserteq(pecc.failed, cecc.failed);
+		ut_asserteq_mem(pbuf, cbuf, len);
+
+		/* all data outside the uncorrectable page is good */
+		for (j = 0; j < len; j++) {
+			if ((from + j) / NAND_PAGE_SIZE != UNCORRECTABLE_PAGE)
+				ut_asserteq(nand_test_byte(from + j), cbuf[j]);
+		}
+
+		/* the per-page path reads each page separately */
+		ut_asserteq(0, pstats.cache_seq + pstats.cache_end);
+		ut_asserteq(last - first + 1, pstats.page_reads);
+
+		/*
+		 * The cache path only needs a READ PAGE for the first page of
+		 * each block and for partial pages, and moves every other page
+		 * with a cache command
+		 */
+		ut_asserteq(last - first + 1, cstats.page_reads +
+			    cstats.cache_seq);
+		if (last - first >= 2)
+			ut_assert(cstats.cache_seq);
+		ut_assert(cstats.cache_end <= cstats.page_reads);
+	}
+
+	free(pbuf);
+	free(cbuf);
+
+	return 0;
+}
+DM_TEST(dm_test_nand_cache_read, UT_TESTF_SCAN_FDT);
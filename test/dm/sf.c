@@ -13,6 +13,7 @@
 #include <spi_flash.h>
 #include <asm/state.h>
 #include <asm/test.h>
+#include <dm/device-internal.h>
 #include <dm/test.h>
 #include <dm/util.h>
 #include <test/test.h>
@@ -102,3 +103,51 @@ static int dm_test_spi_flash_func(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_spi_flash_func, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test that an unreliable dual read mode is detected and not used */
+static int dm_test_spi_flash_read_tuning(struct unit_test_state *uts)
+{
+	struct udevice *bus, *dev, *emul;
+	struct spi_flash *flash;
+	int size = 0x1000;
+	u8 *src, *dst;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_SPI_FLASH_READ_TUNING))
+		return -EAGAIN;
+
+	src = map_sysmem(0x20000, size);
+	for (i = 0; i < size; i++)
+		src[i] = i;
+	ut_assertok(os_write_file("spi.bin", src, size));
+	dst = map_sysmem(0x20000 + size, size);
+
+	/* this flash is connected with two data lines for reading */
+	ut_assertok(uclass_get_device_by_name(UCLASS_SPI_FLASH, "spi.bin@2",
+					      &dev));
+	flash = dev_get_uclass_priv(dev);
+	ut_asserteq(SPINOR_OP_READ_1_1_2, flash->read_opcode);
+	ut_assertok(spi_flash_read_dm(dev, 0, size, dst));
+	ut_asserteq_mem(src, dst, size);
+
+	/* make dual reads fail and check that the fast read is used */
+	bus = dev_get_parent(dev);
+	ut_assertok(sandbox_spi_get_emul(state_get_current(), bus, dev, &emul));
+	sandbox_sf_set_bad_read(emul, SPINOR_OP_READ_1_1_2);
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_assertok(device_probe(dev));
+	flash = dev_get_uclass_priv(dev);
+	ut_asserteq(SPINOR_OP_READ_FAST, flash->read_opcode);
+	memset(dst, '\0', size);
+	ut_assertok(spi_flash_read_dm(dev, 0, size, dst));
+	ut_asserteq_mem(src, dst, size);
+
+	/*
+	 * Since we are about to destroy all devices, we must tell sandbox
+	 * to forget the emulation device
+	 */
+	sandbox_sf_unbind_emul(state_get_current(), 0, 2);
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_read_tuning, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
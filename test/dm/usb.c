@@ -6,7 +6,9 @@
 #include <common.h>
 #include <console.h>
 #include <dm.h>
+#include <malloc.h>
 #include <part.h>
+#include <scsi.h>
 #include <usb.h>
 #include <asm/io.h>
 #include <asm/state.h>
@@ -85,6 +87,122 @@ static int dm_test_usb_flash(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_usb_flash, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+/* test that a read larger than one transfer is split and reassembled */
+static int dm_test_usb_flash_multi_xfer(struct unit_test_state *uts)
+{
+	struct blk_desc *dev_desc;
+	const int count = 600;
+	char *buf;
+
+	state_set_skip_delays(true);
+	ut_assertok(usb_init());
+	ut_assertok(blk_get_device_by_str("usb", "0", &dev_desc));
+
+	buf = malloc(count * dev_desc->blksz);
+	ut_assertnonnull(buf);
+	memset(buf, '\xff', count * dev_desc->blksz);
+	ut_asserteq(count, blk_dread(dev_desc, 0, count, buf));
+	ut_asserteq_str("this is a test", buf);
+	ut_asserteq(0, buf[count * dev_desc->blksz - 1]);
+	free(buf);
+
+	ut_assertok(usb_stop());
+
+	return 0;
+}
+DM_TEST(dm_test_usb_flash_multi_xfer, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* test that a flash stick with more than 2^32 blocks uses the 16-byte CDBs */
+static int dm_test_usb_flash_lba64(struct unit_test_state *uts)
+{
+	const u64 base = 1ULL << 32;
+	struct udevice *dev, *emul;
+	struct blk_desc *dev_desc;
+	char cmp[1024];
+	lbaint_t size;
+
+	/* get the size of the backing file */
+	state_set_skip_delays(true);
+	ut_assertok(usb_init());
+	ut_assertok(blk_get_device_by_str("usb", "0", &dev_desc));
+	size = dev_desc->lba;
+	ut_assertok(usb_stop());
+
+	sandbox_flash_set_lba_base(base);
+	ut_assertok(usb_init());
+	ut_assertok(uclass_get_device(UCLASS_MASS_STORAGE, 0, &dev));
+	ut_assertok(usb_emul_find_for_dev(dev, &emul));
+	ut_assertok(blk_get_device_by_str("usb", "0", &dev_desc));
+
+	/* this is only possible with read capacity (16) */
+	ut_asserteq(base + size, dev_desc->lba);
+
+	memset(cmp, '\0', sizeof(cmp));
+	ut_asserteq(2, blk_dread(dev_desc, base, 2, cmp));
+	ut_asserteq(SCSI_READ16, sandbox_flash_get_last_cmd(emul));
+	ut_asserteq_str("this is a test", cmp);
+
+	strcpy(cmp, "another test");
+	ut_asserteq(1, blk_dwrite(dev_desc, base + 1, 1, cmp));
+	ut_asserteq(SCSI_WRITE16, sandbox_flash_get_last_cmd(emul));
+
+	/* blocks below 2^32 still use read (10) */
+	memset(cmp, '\0', sizeof(cmp));
+	ut_asserteq(2, blk_dread(dev_desc, 0, 2, cmp));
+	ut_asserteq(SCSI_READ10, sandbox_flash_get_last_cmd(emul));
+	ut_asserteq_str("this is a test", cmp);
+	ut_asserteq_str("another test", cmp + 512);
+
+	memset(cmp, '\0', sizeof(cmp));
+	ut_asserteq(1, blk_dwrite(dev_desc, base + 1, 1, cmp));
+	ut_assertok(usb_stop());
+
+	return 0;
+}
+DM_TEST(dm_test_usb_flash_lba64, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* check a deferred scan of the ports behind usb@1; deferral must be on */
+static int check_defer_scan(struct unit_test_state *uts, struct udevice *bus)
+{
+	struct udevice *dev;
+
+	/* The root hub is set up but nothing behind it is enumerated yet */
+	ut_assertok(usb_scan_device(bus, 0, USB_SPEED_FULL, &dev));
+	ut_asserteq(UCLASS_USB_HUB, device_get_uclass_id(dev));
+	ut_assertok(uclass_find_first_device(UCLASS_MASS_STORAGE, &dev));
+	ut_assertnull(dev);
+
+	ut_assertok(usb_hub_scan_ports());
+	ut_assertok(uclass_get_device(UCLASS_MASS_STORAGE, 0, &dev));
+
+	return 0;
+}
+
+/* test that hub ports can be queued and scanned together later */
+static int dm_test_usb_defer_scan(struct unit_test_state *uts)
+{
+	struct udevice *bus;
+	int ret;
+
+	state_set_skip_delays(true);
+	ut_assertok(uclass_find_device_by_name(UCLASS_USB, "usb@1", &bus));
+	ut_assertok(dm_scan_fdt_dev(bus));
+	ut_assertok(device_probe(bus));
+
+	usb_hub_defer_port_scan(true);
+	ret = check_defer_scan(uts, bus);
+	if (ret) {
+		/* don't leave deferral on or ports queued for later tests */
+		usb_hub_scan_ports();
+		usb_stop();
+		return ret;
+	}
+	ut_assertok(usb_stop());
+
+	return 0;
+}
+DM_TEST(dm_test_usb_defer_scan, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
 /* test that we can handle multiple storage devices */
 static int dm_test_usb_multi(struct unit_test_state *uts)
 {
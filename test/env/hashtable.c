@@ -124,3 +124,98 @@ static int env_test_htab_deletes(struct unit_test_state *uts)
 }
 
 ENV_TEST(env_test_htab_deletes, 0);
+
+/* Number of entries for the growth test, far more than the initial size */
+#define GROW_SIZE 2000
+
+/* Grow the table well beyond its initial size, deleting as we go */
+static int env_test_htab_grow(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+	struct env_entry *ritem;
+	char key[20];
+	int i;
+
+	memset(&htab, 0, sizeof(htab));
+	ut_asserteq(1, hcreate_r(SIZE, &htab));
+
+	ut_assertok(htab_fill(uts, &htab, GROW_SIZE));
+	ut_asserteq(GROW_SIZE, htab.filled);
+	ut_assert(htab.size > GROW_SIZE);
+	ut_assertok(htab_check_fill(uts, &htab, GROW_SIZE));
+
+	/* delete the odd entries and check the rest are intact */
+	for (i = 1; i < GROW_SIZE; i += 2) {
+		sprintf(key, "%d", i);
+		ut_asserteq(0, hdelete_r(key, &htab, 0));
+	}
+	ut_asserteq(GROW_SIZE / 2, htab.filled);
+	for (i = 0; i < GROW_SIZE; i++) {
+		struct env_entry item = { .key = key };
+
+		sprintf(key, "%d", i);
+		hsearch_r(item, ENV_FIND, &ritem, &htab, 0);
+		if (i & 1) {
+			ut_assertnull(ritem);
+		} else {
+			ut_assertnonnull(ritem);
+			ut_asserteq_str(key, ritem->data);
+		}
+	}
+	ut_assertok(htab_create_delete(uts, &htab, ITERATIONS));
+	ut_asserteq(GROW_SIZE / 2, htab.filled);
+
+	hdestroy_r(&htab);
+	return 0;
+}
+
+ENV_TEST(env_test_htab_grow, 0);
+
+/* Check that export is sorted and that hmatch_r() visits every entry once */
+static int env_test_htab_export(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+	struct env_entry *ritem;
+	char *res = NULL, *p;
+	const char *prev;
+	int i, idx, count;
+
+	memset(&htab, 0, sizeof(htab));
+	ut_asserteq(1, hcreate_r(SIZE, &htab));
+
+	/* keys are decimal numbers, so their string order is scrambled */
+	ut_assertok(htab_fill(uts, &htab, GROW_SIZE / 4));
+	ut_assert(hexport_r(&htab, '\n', 0, &res, 0, 0, NULL) > 0);
+
+	prev = "";
+	for (i = 0, p = res; *p; i++) {
+		char *line = p;
+
+		p = strchr(line, '\n');
+		ut_assertnonnull(p);
+		*p++ = '\0';
+		/* compare just the keys */
+		*strchr(line, '=') = '\0';
+		ut_assert(strcmp(prev, line) < 0);
+		prev = line;
+	}
+	ut_asserteq(GROW_SIZE / 4, i);
+	free(res);
+
+	for (idx = 0, count = 0; (idx = hmatch_r("", idx, &ritem, &htab));)
+		count++;
+	ut_asserteq(GROW_SIZE / 4, count);
+
+	/* a search returns an index from which hmatch_r() can carry on */
+	for (idx = 0, count = 0; (idx = hmatch_r("1", idx, &ritem, &htab));) {
+		ut_asserteq('1', *ritem->key);
+		count++;
+	}
+	/* 1, 10-19, 100-199 */
+	ut_asserteq(111, count);
+
+	hdestroy_r(&htab);
+	return 0;
+}
+
+ENV_TEST(env_test_htab_export, 0);
@@ -10,6 +10,7 @@
 #include <os.h>
 #include <spl.h>
 #include <test/ut.h>
+#include <u-boot/crc.h>
 
 /* Declare a new SPL test */
 #define SPL_TEST(_name, _flags)		UNIT_TEST(_name, _flags, spl_test)
@@ -17,6 +18,7 @@
 /* Context used for this test */
 struct text_ctx {
 	int fd;
+	ulong blocks;
 };
 
 static ulong read_fit_image(struct spl_load_info *load, ulong sector,
@@ -40,6 +42,7 @@ static ulong read_fit_image(struct spl_load_info *load, ulong sector,
 		       count * load->bl_len, res, errno);
 		return 0;
 	}
+	text_ctx->blocks += count;
 
 	return count;
 }
@@ -89,3 +92,91 @@ static int spl_test_load(struct unit_test_state *uts)
 	return 0;
 }
 SPL_TEST(spl_test_load, 0);
+
+/**
+ * load_fit_raw() - Load the next phase as a FIT with raw reads
+ *
+ * @uts: Test state
+ * @fname: Filename of the FIT
+ * @bl_len: Block size to use
+ * @image: Returns information about the loaded image
+ * @blocksp: Returns the number of blocks read
+ * Return: 0 if OK, else test failure
+ */
+static int load_fit_raw(struct unit_test_state *uts, const char *fname,
+			int bl_len, struct spl_image_info *image,
+			ulong *blocksp)
+{
+	struct legacy_img_hdr *header;
+	struct text_ctx text_ctx;
+	struct spl_load_info load;
+
+	memset(&load, '\0', sizeof(load));
+	load.bl_len = bl_len;
+	load.read = read_fit_image;
+
+	header = spl_get_load_buffer(-sizeof(*header), sizeof(*header));
+
+	text_ctx.fd = os_open(fname, OS_O_RDONLY);
+	ut_assert(text_ctx.fd >= 0);
+	ut_asserteq(512, os_read(text_ctx.fd, header, 512));
+	text_ctx.blocks = 0;
+	load.priv = &text_ctx;
+
+	memset(image, '\0', sizeof(*image));
+	ut_assertok(spl_load_simple_fit(image, &load, 0, header));
+	os_close(text_ctx.fd);
+	*blocksp = text_ctx.blocks;
+
+	return 0;
+}
+
+/* Size of a devicetree, without the free space at its end */
+static int fdt_used_size(const void *fdt)
+{
+	return fdt_off_dt_strings(fdt) + fdt_size_dt_strings(fdt);
+}
+
+/* Check that blocks shared by the images in a FIT are only read once */
+static int spl_test_load_shared(struct unit_test_state *uts)
+{
+	struct spl_image_info image;
+	long long size;
+	ulong blocks;
+	u32 crc, fdt_crc;
+	char fname[256];
+	void *buf;
+	int ret;
+
+	ret = sandbox_find_next_phase(fname, sizeof(fname), true);
+	if (ret) {
+		printf("(%s not found, error %d)\n", fname, ret);
+		return ret;
+	}
+	ut_assertok(os_get_filesize(fname, &size));
+
+	/* with single-byte blocks there is nothing to share */
+	ut_assertok(load_fit_raw(uts, fname, 1, &image, &blocks));
+	buf = map_sysmem(image.load_addr, image.size);
+	crc = crc32(0, buf, image.size);
+	ut_assertnonnull(image.fdt_addr);
+	fdt_crc = crc32(0, image.fdt_addr, fdt_used_size(image.fdt_addr));
+
+	/* load again with 512-byte blocks, after clearing the images */
+	memset(buf, '\0', image.size);
+	memset(image.fdt_addr, '\0', fdt_totalsize(image.fdt_addr));
+	unmap_sysmem(buf);
+	ut_assertok(load_fit_raw(uts, fname, 512, &image, &blocks));
+	buf = map_sysmem(image.load_addr, image.size);
+	ut_asserteq(crc, crc32(0, buf, image.size));
+	unmap_sysmem(buf);
+	ut_asserteq(fdt_crc, crc32(0, image.fdt_addr,
+				   fdt_used_size(image.fdt_addr)));
+
+	/* no block of the FIT is read more than once */
+	if (IS_ENABLED(CONFIG_SPL_LOAD_FIT_SHARED_BLOCKS))
+		ut_assert(blocks <= DIV_ROUND_UP(size, 512));
+
+	return 0;
+}
+SPL_TEST(spl_test_load_shared, 0);
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Test the EFI memory map
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <malloc.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define NUM_ALLOCS	2000
+
+/**
+ * check_map() - check that the memory map is well formed
+ *
+ * The entries must be in ascending order, must not overlap and adjacent
+ * entries must differ in type or attributes.
+ *
+ * @uts:	test state
+ * @entriesp:	returns the number of entries in the map
+ * Return:	0 if OK, else test failure
+ */
+static int check_map(struct unit_test_state *uts, efi_uintn_t *entriesp)
+{
+	struct efi_mem_desc *map, *prev, *cur;
+	efi_uintn_t size = 0, desc_size, i;
+	u32 desc_version;
+
+	ut_assert(efi_get_memory_map(&size, NULL, NULL, &desc_size,
+				     &desc_version) == EFI_BUFFER_TOO_SMALL);
+	map = malloc(size);
+	ut_assertnonnull(map);
+	ut_assertok(efi_get_memory_map(&size, map, NULL, NULL, NULL));
+	*entriesp = size / desc_size;
+
+	for (i = 1; i < *entriesp; i++) {
+		prev = &map[i - 1];
+		cur = &map[i];
+		ut_assert(cur->num_pages);
+		ut_assert(prev->physical_start +
+			  (prev->num_pages << EFI_PAGE_SHIFT) <=
+			  cur->physical_start);
+		if (prev->physical_start + (prev->num_pages << EFI_PAGE_SHIFT) ==
+		    cur->physical_start) {
+			ut_assert(prev->type != cur->type ||
+				  prev->attribute != cur->attribute);
+		}
+	}
+	free(map);
+
+	return 0;
+}
+
+/* Test many allocations from the EFI memory map */
+static int lib_test_efi_mem_many(struct unit_test_state *uts)
+{
+	efi_uintn_t entries, start_entries;
+	void **bufs;
+	int i;
+
+	ut_assertok(check_map(uts, &start_entries));
+	bufs = calloc(NUM_ALLOCS, sizeof(*bufs));
+	ut_assertnonnull(bufs);
+
+	/* alternate the type, so that the allocations are not merged */
+	for (i = 0; i < NUM_ALLOCS; i++) {
+		ut_assertok(efi_allocate_pool(i & 1 ? EFI_LOADER_DATA :
+					      EFI_BOOT_SERVICES_DATA,
+					      (i % 5) * EFI_PAGE_SIZE + 1,
+					      &bufs[i]));
+	}
+	ut_assertok(check_map(uts, &entries));
+	ut_assert(entries >= NUM_ALLOCS);
+
+	/* free every other one, leaving holes, then fill them again */
+	for (i = 0; i < NUM_ALLOCS; i += 2)
+		ut_assertok(efi_free_pool(bufs[i]));
+	ut_assertok(check_map(uts, &entries));
+	for (i = 0; i < NUM_ALLOCS; i += 2) {
+		ut_assertok(efi_allocate_pool(EFI_BOOT_SERVICES_DATA,
+					      (i % 5) * EFI_PAGE_SIZE + 1,
+					      &bufs[i]));
+	}
+	ut_assertok(check_map(uts, &entries));
+
+	/* a double free must be caught */
+	ut_assertok(efi_free_pool(bufs[1]));
+	ut_assert(efi_free_pool(bufs[1]) == EFI_NOT_FOUND);
+
+	for (i = 0; i < NUM_ALLOCS; i++) {
+		if (i != 1)
+			ut_assertok(efi_free_pool(bufs[i]));
+	}
+	free(bufs);
+
+	/* everything merges back together */
+	ut_assertok(check_map(uts, &entries));
+	ut_asserteq(start_entries, entries);
+
+	return 0;
+}
+LIB_TEST(lib_test_efi_mem_many, 0);
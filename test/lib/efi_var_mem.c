@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Test the index of the in-memory UEFI variable store
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <efi_variable.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+static const efi_guid_t guid_collide =
+	EFI_GUID(0x5a1c7d32, 0x0b3e, 0x4f6d,
+		 0x9a, 0x21, 0x6c, 0x85, 0x3d, 0x47, 0xe0, 0x19);
+
+/*
+ * With guid_collide the first two names have the same hash, 0x01db6b0c. The
+ * next three share its lower 16 bits and the last two have 0x6b0d there, so
+ * they all end up in one cluster of the index whatever its size.
+ */
+static const u16 *const names_collide[] = {
+	u"Hash5A950",
+	u"HashC78B8",
+	u"Hash5E53B",
+	u"Hash6B75D",
+	u"Hash71E0E",
+	u"Hash03A58",
+	u"Hash05A5B",
+};
+
+#define NUM_NAMES	ARRAY_SIZE(names_collide)
+
+/**
+ * set_var() - create or delete one of the test variables
+ *
+ * @uts:	test state
+ * @i:		index into names_collide[]
+ * @add:	true to create the variable, false to delete it
+ * Return:	0 if OK, else test failure
+ */
+static int set_var(struct unit_test_state *uts, int i, bool add)
+{
+	u32 val = i + 1;
+
+	ut_assertok(efi_set_variable_int(names_collide[i], &guid_collide,
+					 EFI_VARIABLE_BOOTSERVICE_ACCESS,
+					 add ? sizeof(val) : 0, &val, false));
+
+	return 0;
+}
+
+/**
+ * check_vars() - check which of the test variables can be found
+ *
+ * @uts:	test state
+ * @present:	bit mask of the variables which must exist
+ * Return:	0 if OK, else test failure
+ */
+static int check_vars(struct unit_test_state *uts, uint present)
+{
+	efi_uintn_t size;
+	u32 val;
+	int i;
+
+	for (i = 0; i < NUM_NAMES; i++) {
+		size = sizeof(val);
+		val = 0;
+		if (!(present & BIT(i))) {
+			ut_assert(efi_get_variable_int(names_collide[i],
+						       &guid_collide, NULL,
+						       &size, &val, NULL) ==
+				  EFI_NOT_FOUND);
+			continue;
+		}
+		ut_assertok(efi_get_variable_int(names_collide[i],
+						 &guid_collide, NULL, &size,
+						 &val, NULL));
+		ut_asserteq(sizeof(val), size);
+		ut_asserteq(i + 1, val);
+	}
+
+	return 0;
+}
+
+/* Test deleting and looking up variables whose hashes collide */
+static int lib_test_efi_var_collide(struct unit_test_state *uts)
+{
+	uint present = 0;
+	int i;
+
+	ut_assertok(efi_init_obj_list());
+
+	for (i = 0; i < NUM_NAMES; i++) {
+		ut_assertok(set_var(uts, i, true));
+		present |= BIT(i);
+		ut_assertok(check_vars(uts, present));
+	}
+
+	/* the first of the cluster, moving all the others down in the buffer */
+	ut_assertok(set_var(uts, 0, false));
+	present &= ~BIT(0);
+	ut_assertok(check_vars(uts, present));
+
+	/* the other one with the same hash, then one with a different home */
+	ut_assertok(set_var(uts, 1, false));
+	present &= ~BIT(1);
+	ut_assertok(check_vars(uts, present));
+	ut_assertok(set_var(uts, 5, false));
+	present &= ~BIT(5);
+	ut_assertok(check_vars(uts, present));
+
+	/* add them back, in a different order */
+	ut_assertok(set_var(uts, 5, true));
+	ut_assertok(set_var(uts, 1, true));
+	ut_assertok(set_var(uts, 0, true));
+	present = BIT(NUM_NAMES) - 1;
+	ut_assertok(check_vars(uts, present));
+
+	/* delete them all again */
+	for (i = 0; i < NUM_NAMES; i++) {
+		ut_assertok(set_var(uts, i, false));
+		present &= ~BIT(i);
+		ut_assertok(check_vars(uts, present));
+	}
+
+	return 0;
+}
+LIB_TEST(lib_test_efi_var_collide, 0);
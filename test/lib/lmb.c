@@ -677,6 +677,8 @@ static int lib_test_lmb_max_regions(struct unit_test_state *uts)
 	const phys_size_t ram_size = ((0xFFFFFFFF >> CONFIG_LMB_MAX_REGIONS)
 			+ 1) * CONFIG_LMB_MAX_REGIONS;
 	const phys_size_t blk_size = 0x10000;
+	/* with dynamic tables, the extra region is accepted */
+	const int extra = IS_ENABLED(CONFIG_LMB_DYNAMIC_REGIONS) ? 1 : 0;
 	phys_addr_t offset;
 	struct lmb lmb;
 	int ret, i;
@@ -700,9 +702,9 @@ static int lib_test_lmb_max_regions(struct unit_test_state *uts)
 	/*  error for the (CONFIG_LMB_MAX_REGIONS + 1) memory regions */
 	offset = ram + 2 * (CONFIG_LMB_MAX_REGIONS + 1) * ram_size;
 	ret = lmb_add(&lmb, offset, ram_size);
-	ut_asserteq(ret, -1);
+	ut_asserteq(ret, extra ? 0 : -1);
 
-	ut_asserteq(lmb.memory.cnt, CONFIG_LMB_MAX_REGIONS);
+	ut_asserteq(lmb.memory.cnt, CONFIG_LMB_MAX_REGIONS + extra);
 	ut_asserteq(lmb.reserved.cnt, 0);
 
 	/*  reserve CONFIG_LMB_MAX_REGIONS regions */
@@ -712,16 +714,16 @@ static int lib_test_lmb_max_regions(struct unit_test_state *uts)
 		ut_asserteq(ret, 0);
 	}
 
-	ut_asserteq(lmb.memory.cnt, CONFIG_LMB_MAX_REGIONS);
+	ut_asserteq(lmb.memory.cnt, CONFIG_LMB_MAX_REGIONS + extra);
 	ut_asserteq(lmb.reserved.cnt, CONFIG_LMB_MAX_REGIONS);
 
 	/*  error for the 9th reserved blocks */
 	offset = ram + 2 * (CONFIG_LMB_MAX_REGIONS + 1) * blk_size;
 	ret = lmb_reserve(&lmb, offset, blk_size);
-	ut_asserteq(ret, -1);
+	ut_asserteq(ret, extra ? 0 : -1);
 
-	ut_asserteq(lmb.memory.cnt, CONFIG_LMB_MAX_REGIONS);
-	ut_asserteq(lmb.reserved.cnt, CONFIG_LMB_MAX_REGIONS);
+	ut_asserteq(lmb.memory.cnt, CONFIG_LMB_MAX_REGIONS + extra);
+	ut_asserteq(lmb.reserved.cnt, CONFIG_LMB_MAX_REGIONS + extra);
 
 	/*  check each regions */
 	for (i = 0; i < CONFIG_LMB_MAX_REGIONS; i++)
@@ -730,6 +732,8 @@ static int lib_test_lmb_max_regions(struct unit_test_state *uts)
 	for (i = 0; i < CONFIG_LMB_MAX_REGIONS; i++)
 		ut_asserteq(lmb.reserved.region[i].base, ram + 2 * i * blk_size);
 
+	lmb_uninit(&lmb);
+
 	return 0;
 }
 #endif
@@ -825,3 +829,77 @@ static int lib_test_lmb_flags(struct unit_test_state *uts)
 
 DM_TEST(lib_test_lmb_flags,
 	UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Number of reservations for the stress test */
+#define LMB_STRESS_COUNT	4000
+
+/*
+ * Reserve thousands of pages in a scrambled order, leaving a one-page gap
+ * after each, then fill and re-open the gaps. This needs tables much larger
+ * than the initial ones.
+ */
+static int lib_test_lmb_many(struct unit_test_state *uts)
+{
+	const phys_size_t page = 0x1000;
+	const phys_addr_t ram = 0x40000000;
+	const phys_size_t ram_size = 2 * LMB_STRESS_COUNT * page;
+	phys_addr_t addr;
+	struct lmb lmb;
+	long ret;
+	int i, j;
+
+	if (!IS_ENABLED(CONFIG_LMB_DYNAMIC_REGIONS))
+		return -EAGAIN;
+
+	lmb_init(&lmb);
+	ut_asserteq(0, lmb_add(&lmb, ram, ram_size));
+
+	/* 7 is coprime with the count, so this visits every page once */
+	for (i = 0; i < LMB_STRESS_COUNT; i++) {
+		j = (i * 7) % LMB_STRESS_COUNT;
+		ret = lmb_reserve(&lmb, ram + 2 * j * page, page);
+		ut_asserteq(0, ret);
+	}
+	ut_asserteq(LMB_STRESS_COUNT, lmb.reserved.cnt);
+	ut_assert(lmb.reserved.max >= LMB_STRESS_COUNT);
+	for (i = 0; i < LMB_STRESS_COUNT; i++) {
+		ut_asserteq(ram + 2 * i * page, lmb.reserved.region[i].base);
+		ut_asserteq(page, lmb.reserved.region[i].size);
+	}
+
+	/* lookups */
+	ut_asserteq(1, lmb_is_reserved(&lmb, ram + 1234 * page));
+	ut_asserteq(0, lmb_is_reserved(&lmb, ram + 1235 * page));
+	ut_asserteq(page, lmb_get_free_size(&lmb, ram + 1235 * page));
+	ut_asserteq(0, lmb_get_free_size(&lmb, ram + 1236 * page));
+	ut_asserteq(-1, lmb_reserve(&lmb, ram + 1235 * page, 2 * page));
+
+	/* no gap is big enough */
+	addr = __lmb_alloc_base(&lmb, 2 * page, page, 0);
+	ut_asserteq(0, addr);
+
+	/* each allocation takes the top gap, merging two regions */
+	for (i = LMB_STRESS_COUNT - 1; i >= 0; i--) {
+		addr = __lmb_alloc_base(&lmb, page, page, 0);
+		ut_asserteq(ram + (2 * i + 1) * page, addr);
+	}
+	ut_asserteq(1, lmb.reserved.cnt);
+	ut_asserteq(ram, lmb.reserved.region[0].base);
+	ut_asserteq(ram_size, lmb.reserved.region[0].size);
+	ut_asserteq(0, __lmb_alloc_base(&lmb, page, page, 0));
+
+	/* re-open the gaps, splitting the region each time */
+	for (i = 0; i < LMB_STRESS_COUNT; i++) {
+		ret = lmb_free(&lmb, ram + (2 * i + 1) * page, page);
+		ut_asserteq(0, ret);
+	}
+	ut_asserteq(LMB_STRESS_COUNT, lmb.reserved.cnt);
+	ut_asserteq(ram + 2 * (LMB_STRESS_COUNT - 1) * page,
+		    lmb.reserved.region[LMB_STRESS_COUNT - 1].base);
+
+	lmb_uninit(&lmb);
+
+	return 0;
+}
+
+DM_TEST(lib_test_lmb_many, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
@@ -196,6 +196,131 @@ static int lib_memmove(struct unit_test_state *uts)
 
 LIB_TEST(lib_memmove, 0);
 
+/* Buffer for the long tests, long enough to reach the unrolled loops */
+#define LONG_SWEEP	(2 * sizeof(long))
+#define LONG_MAX_LEN	(12 * sizeof(long))
+#define LONG_BUFLEN	(LONG_SWEEP + LONG_MAX_LEN + 8)
+
+/**
+ * lib_memcpy_long() - unit test for memcpy() and memmove() with long regions
+ *
+ * Test memcpy() and memmove() with every combination of source and
+ * destination alignment, for lengths up to several words, so that the word
+ * and unrolled loops are used. Overlapping regions are tested with memmove()
+ * in both directions.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_memcpy_long(struct unit_test_state *uts)
+{
+	u8 src[LONG_BUFLEN], buf[LONG_BUFLEN], expect[LONG_BUFLEN];
+	int offset1, offset2, len, i;
+
+	for (i = 0; i < LONG_BUFLEN; i++)
+		src[i] = (i * 7) ^ MASK;
+
+	for (offset1 = 0; offset1 <= LONG_SWEEP; ++offset1) {
+		for (offset2 = 0; offset2 <= LONG_SWEEP; ++offset2) {
+			for (len = 0; len <= LONG_MAX_LEN; ++len) {
+				/* separate buffers */
+				memset(buf, 0, LONG_BUFLEN);
+				memset(expect, 0, LONG_BUFLEN);
+				for (i = 0; i < len; i++)
+					expect[offset2 + i] = src[offset1 + i];
+				ut_asserteq_ptr(buf + offset2,
+						memcpy(buf + offset2,
+						       src + offset1, len));
+				ut_asserteq_mem(expect, buf, LONG_BUFLEN);
+
+				/* overlapping, in the same buffer */
+				for (i = 0; i < LONG_BUFLEN; i++)
+					buf[i] = expect[i] = src[i];
+				for (i = 0; i < len; i++)
+					expect[offset2 + i] = src[offset1 + i];
+				ut_asserteq_ptr(buf + offset2,
+						memmove(buf + offset2,
+							buf + offset1, len));
+				ut_asserteq_mem(expect, buf, LONG_BUFLEN);
+			}
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_memcpy_long, 0);
+
+/**
+ * lib_memset_long() - unit test for memset() with long regions
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_memset_long(struct unit_test_state *uts)
+{
+	u8 buf[LONG_BUFLEN];
+	int offset, len, i;
+
+	for (offset = 0; offset <= LONG_SWEEP; ++offset) {
+		for (len = 0; len <= LONG_MAX_LEN; ++len) {
+			memset(buf, 0, LONG_BUFLEN);
+			ut_asserteq_ptr(buf + offset,
+					memset(buf + offset, 0x1a5, len));
+			for (i = 0; i < LONG_BUFLEN; i++) {
+				if (i < offset || i >= offset + len) {
+					ut_asserteq(0, buf[i]);
+				} else {
+					ut_asserteq(MASK, buf[i]);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_memset_long, 0);
+
+/**
+ * lib_memcmp() - unit test for memcmp()
+ *
+ * Test memcmp() with varied alignment and length, with no difference and
+ * with a single difference at each position in the region.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_memcmp(struct unit_test_state *uts)
+{
+	u8 buf1[LONG_BUFLEN], buf2[LONG_BUFLEN];
+	int offset1, offset2, len, pos;
+
+	for (pos = 0; pos < LONG_BUFLEN; pos++)
+		buf1[pos] = pos ^ MASK;
+
+	for (offset1 = 0; offset1 <= LONG_SWEEP; ++offset1) {
+		for (offset2 = 0; offset2 <= LONG_SWEEP; ++offset2) {
+			for (len = 0; len <= 3 * sizeof(long); ++len) {
+				u8 *p1 = buf1 + offset1, *p2 = buf2 + offset2;
+
+				memcpy(p2, p1, len);
+				ut_asserteq(0, memcmp(p1, p2, len));
+				for (pos = 0; pos < len; pos++) {
+					p2[pos] = p1[pos] + 1;
+					ut_assert(memcmp(p1, p2, len) < 0);
+					ut_assert(memcmp(p2, p1, len) > 0);
+					p2[pos] = p1[pos];
+				}
+			}
+		}
+	}
+
+	/* bytes compare as unsigned */
+	ut_assert(memcmp("\x80", "\x7f", 1) > 0);
+
+	return 0;
+}
+LIB_TEST(lib_memcmp, 0);
+
 /** lib_memdup() - unit test for memdup() */
 static int lib_memdup(struct unit_test_state *uts)
 {
@@ -225,3 +350,150 @@ static int lib_memdup(struct unit_test_state *uts)
 	return 0;
 }
 LIB_TEST(lib_memdup, 0);
+
+/* Alignments and lengths for the string tests, enough to cover several words */
+#define STR_SWEEP	(2 * sizeof(long))
+#define STR_MAX_LEN	(4 * sizeof(long))
+#define STR_BUFLEN	(STR_SWEEP + STR_MAX_LEN + 2 * sizeof(long))
+
+/**
+ * str_fill() - fill a buffer with non-zero bytes, including 0x01 and 0x80
+ *
+ * These values are the edge cases for the has-zero-byte test.
+ *
+ * @buf:	buffer to fill, STR_BUFLEN bytes
+ */
+static void str_fill(char *buf)
+{
+	int i;
+
+	for (i = 0; i < STR_BUFLEN; i++)
+		buf[i] = (i * 37) % 255 + 1;
+	buf[3] = 0x80;
+	buf[5] = 0x01;
+	buf[6] = 0xff;
+}
+
+/**
+ * lib_strlen() - unit test for strlen() and strnlen()
+ *
+ * Test every string alignment and length, with every limit up to beyond
+ * the end of the string.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_strlen(struct unit_test_state *uts)
+{
+	char buf[STR_BUFLEN];
+	int offset, len, count;
+
+	for (offset = 0; offset <= STR_SWEEP; offset++) {
+		for (len = 0; len <= STR_MAX_LEN; len++) {
+			char *s = buf + offset;
+
+			str_fill(buf);
+			s[len] = '\0';
+			ut_asserteq(len, strlen(s));
+			for (count = 0; count <= len + sizeof(long); count++)
+				ut_asserteq(min(len, count), strnlen(s, count));
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_strlen, 0);
+
+/**
+ * lib_strchr() - unit test for strchr() and memchr()
+ *
+ * Search for a character placed at every position of a string of every
+ * alignment, and for characters which are not present.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_strchr(struct unit_test_state *uts)
+{
+	char buf[STR_BUFLEN];
+	int offset, len, pos, n;
+
+	for (offset = 0; offset <= STR_SWEEP; offset++) {
+		for (len = 0; len <= STR_MAX_LEN; len++) {
+			char *s = buf + offset;
+
+			/* '~' is never used by str_fill() */
+			str_fill(buf);
+			s[len] = '\0';
+			ut_assertnull(strchr(s, '~'));
+			ut_asserteq_ptr(s + len, strchr(s, '\0'));
+			ut_assertnull(memchr(s, '~', len));
+
+			for (pos = 0; pos < len; pos++) {
+				s[pos] = '~';
+				ut_asserteq_ptr(s + pos, strchr(s, '~'));
+				/* only the low byte of the character is used */
+				ut_asserteq_ptr(s + pos,
+						memchr(s, 0x100 | '~', len));
+				for (n = 0; n <= len; n++) {
+					ut_asserteq_ptr(n > pos ? s + pos : NULL,
+							memchr(s, '~', n));
+				}
+				s[pos] = (pos * 37) % 255 + 1;
+			}
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_strchr, 0);
+
+/**
+ * lib_strcmp() - unit test for strcmp()
+ *
+ * Compare strings with every combination of alignments, which are equal,
+ * which differ at every position and where one is a prefix of the other.
+ *
+ * @uts:	unit test state
+ * Return:	0 = success, 1 = failure
+ */
+static int lib_strcmp(struct unit_test_state *uts)
+{
+	char buf1[STR_BUFLEN], buf2[STR_BUFLEN];
+	int offset1, offset2, len, pos;
+
+	for (offset1 = 0; offset1 <= STR_SWEEP; offset1++) {
+		for (offset2 = 0; offset2 <= STR_SWEEP; offset2++) {
+			for (len = 0; len <= STR_MAX_LEN; len++) {
+				char *s1 = buf1 + offset1, *s2 = buf2 + offset2;
+
+				str_fill(buf1);
+				s1[len] = '\0';
+				strcpy(s2, s1);
+				/* the data after the terminator must not matter */
+				s2[len + 1] = s1[len + 1] + 1;
+				ut_asserteq(0, strcmp(s1, s2));
+
+				for (pos = 0; pos < len; pos++) {
+					/* bytes compare as unsigned */
+					s2[pos] = s1[pos] == (char)0xff ? 0x7f :
+						  0xff;
+					ut_assert((strcmp(s1, s2) < 0) ==
+						  ((u8)s1[pos] < (u8)s2[pos]));
+					ut_assert((strcmp(s2, s1) < 0) ==
+						  ((u8)s2[pos] < (u8)s1[pos]));
+					ut_assert(strcmp(s1, s2));
+
+					/* s1 is longer than s2 */
+					s2[pos] = '\0';
+					ut_assert(strcmp(s1, s2) > 0);
+					ut_assert(strcmp(s2, s1) < 0);
+					s2[pos] = s1[pos];
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_strcmp, 0);
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Unit test and benchmark for crc32
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <time.h>
+#include <test/lib.h>
+#include <test/ut.h>
+#include <u-boot/crc.h>
+#include <linux/sizes.h>
+
+/**
+ * crc32_ref() - Reference bit-at-a-time CRC32
+ *
+ * @crc: Initial CRC value
+ * @buf: Data to process
+ * @len: Number of bytes in @buf
+ * Return: updated CRC value
+ */
+static uint32_t crc32_ref(uint32_t crc, const u8 *buf, uint len)
+{
+	int k;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *buf++;
+		for (k = 0; k < 8; k++)
+			crc = crc & 1 ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+	}
+
+	return ~crc;
+}
+
+/* Test crc32() against known values and a reference implementation */
+static int lib_crc32(struct unit_test_state *uts)
+{
+	u8 buf[64 + 8];
+	int offset, len, i;
+
+	ut_asserteq(0xcbf43926, crc32(0, (const u8 *)"123456789", 9));
+	ut_asserteq(0, crc32(0, buf, 0));
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 149 + 7;
+
+	/* cover every alignment of the head, body and tail */
+	for (offset = 0; offset < 8; offset++) {
+		for (len = 0; len <= 64; len++) {
+			uint32_t expect = crc32_ref(0x1234, buf + offset, len);
+
+			ut_asserteq(expect, crc32(0x1234, buf + offset, len));
+			/* a calculation split in two must give the same result */
+			ut_asserteq(expect,
+				    crc32(crc32(0x1234, buf + offset, len / 3),
+					  buf + offset + len / 3,
+					  len - len / 3));
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_crc32, 0);
+
+/*
+ * Report the throughput of crc32(). This is slow, so is manual:
+ *
+ *    ut lib -f lib_crc32_bench_norun
+ */
+static int lib_crc32_bench_norun(struct unit_test_state *uts)
+{
+	const int count = 16;
+	ulong start, us;
+	uint32_t crc = 0;
+	u8 *buf;
+	int i;
+
+	buf = malloc(SZ_1M);
+	ut_assertnonnull(buf);
+	for (i = 0; i < SZ_1M; i++)
+		buf[i] = i * 149 + 7;
+
+	start = timer_get_us();
+	for (i = 0; i < count; i++)
+		crc = crc32(crc, buf, SZ_1M);
+	us = max(timer_get_us() - start, 1UL);
+	printf("crc32: %d MiB in %lu us, %lu MB/s\n", count, us,
+	       (ulong)count * SZ_1M / us);
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_crc32_bench_norun, UT_TESTF_MANUAL);
@@ -3,6 +3,7 @@
 #
 # Sanity check of the FIT handling in U-Boot
 
+import hashlib
 import os
 import pytest
 import struct
@@ -32,9 +33,10 @@ base_its = '''
                         type = "kernel";
                         arch = "sandbox";
                         os = "linux";
-                        compression = "none";
+                        compression = "%(loadables1_compression)s";
                         %(loadables1_load)s
                         entry = <0x0>;
+                        %(loadables1_hash)s
                 };
                 fdt-1 {
                         description = "snow";
@@ -299,6 +301,8 @@ def test_fit(u_boot_console):
             'loadables1_addr' : 0x100000,
             'loadables1_size' : filesize(loadables1),
             'loadables1_load' : '',
+            'loadables1_compression' : 'none',
+            'loadables1_hash' : '',
 
             'loadables2' : loadables2,
             'loadables2_out' : loadables2_out,
@@ -388,6 +392,35 @@ def test_fit(u_boot_console):
             check_not_equal(ramdisk, ramdisk_out, 'Ramdisk got decompressed?')
             check_equal(ramdisk + '.gz', ramdisk_out, 'Ramdist not loaded')
 
+        # A compressed loadable's hash is checked while it is decompressed
+        with cons.log.section('Compressed loadable with hash'):
+            params['loadables1'] = make_compressed(loadables1)
+            params['loadables1_compression'] = 'gzip'
+            params['loadables1_hash'] = 'hash-1 { algo = "sha256"; };'
+            fit = fit_util.make_fit(cons, mkimage, base_its, params)
+            cons.restart_uboot()
+            output = cons.run_command_list(cmd.splitlines())
+            check_equal(loadables1, loadables1_out,
+                        'Loadables1 (kernel) not loaded')
+            lines = [line for line in '\n'.join(output).splitlines()
+                     if line.strip()]
+            pos = [i for i, line in enumerate(lines)
+                   if 'Verifying Hash Integrity ... sha256+ OK' in line]
+            assert len(pos) == 1, 'Loadables1 hash not checked once'
+            assert 'Uncompressing' in lines[pos[0] - 1], (
+                'Loadables1 hash not checked while decompressing')
+
+            # Now break the hash in the FIT, which must stop the load
+            digest = hashlib.sha256(read_file(params['loadables1'])).digest()
+            data = read_file(fit)
+            assert data.count(digest) == 1
+            data = data.replace(digest, bytes([digest[0] ^ 1]) + digest[1:])
+            with open(fit, 'wb') as fd:
+                fd.write(data)
+            cons.restart_uboot()
+            output = cons.run_command_list(cmd.splitlines())
+            assert 'Bad Data Hash' in '\n'.join(output)
+
 
     cons = u_boot_console
     try:
@@ -0,0 +1,100 @@
+# SPDX-License-Identifier: GPL-2.0+
+#
+# Test that bootstage records are passed from SPL to the next phase and report
+# how long each phase takes
+
+"""
+The time taken by each phase can be checked against limits, to catch boot-time
+regressions. Add something like this to the boardenv file (times are in
+microseconds):
+
+env__bootstage_limits = {
+    'spl': 100000,
+    'board_f': 50000,
+    'board_r': 500000,
+}
+
+Phases without a limit are only reported.
+"""
+
+import pytest
+
+# Phases reported by this test, each as (name, first mark, last mark)
+PHASES = [
+    ('spl', 'SPL', 'end phase'),
+    ('board_f', 'board_init_f', 'board_init_r'),
+    ('board_r', 'board_init_r', 'main_loop'),
+]
+
+def read_bootstage(cons):
+    """Read the bootstage records from U-Boot
+
+    Args:
+        cons (ConsoleBase): U-Boot console
+
+    Returns:
+        tuple:
+            dict: Mark time in microseconds, for each stage name
+            dict: Accumulated time in microseconds, for each name
+    """
+    out = cons.run_command('bootstage report')
+
+    # The output is something like this:
+    # Timer summary in microseconds (9 records):
+    #        Mark    Elapsed  Stage
+    #           0          0  reset
+    #       1,247      1,247  SPL
+    #       9,118      7,871  end phase
+    #
+    # Accumulated time:
+    #                    905  of_live
+    marks = {}
+    accum = {}
+    in_accum = False
+    for line in out.replace(',', '').splitlines():
+        items = line.split()
+        if line.startswith('Accumulated time'):
+            in_accum = True
+        elif in_accum and len(items) == 2:
+            accum[items[1]] = int(items[0])
+        elif not in_accum and len(items) >= 3 and items[0].isdigit():
+            marks[line.split(maxsplit=2)[2]] = int(items[0])
+    return marks, accum
+
+@pytest.mark.boardspec('sandbox_spl')
+@pytest.mark.buildconfigspec('spl_bootstage')
+@pytest.mark.buildconfigspec('bootstage_stash')
+def test_spl_bootstage(u_boot_console):
+    """Test that SPL's boot timing reaches U-Boot and report each phase
+
+    U-Boot proper stands in for the OS here: on real hardware the same
+    bloblist can be passed to an OS started directly by SPL.
+
+    Note that on sandbox each phase is a new process, so the timer restarts
+    in each phase. Only times within a phase are compared.
+    """
+    cons = u_boot_console
+    cons.restart_uboot()
+    marks, accum = read_bootstage(cons)
+
+    # These records are only present if SPL's stash was found
+    assert 'SPL' in marks
+    assert 'end phase' in marks
+    assert 'board_init_f' in marks
+
+    if cons.config.buildconfig.get('config_bootstage_stash_bloblist'):
+        out = cons.run_command('bloblist list')
+        assert 'Bootstage records' in out
+
+    limits = cons.config.env.get('env__bootstage_limits', {})
+    for name, start, end in PHASES:
+        if start not in marks or end not in marks:
+            continue
+        duration = marks[end] - marks[start]
+        print(f'{name:10} {duration:10} us')
+        assert duration >= 0
+        if name in limits:
+            assert duration <= limits[name], \
+                f"Phase '{name}' took {duration} us, limit {limits[name]} us"
+    for name, duration in accum.items():
+        print(f'{name:10} {duration:10} us (accumulated)')